@@ -21,6 +21,8 @@
 
 #include "account-dialog-context.h"
 
+#include "accounts-private.h"
+
 typedef AccountDialogContextIface AccountDialogContextInterface;
 
 G_DEFINE_INTERFACE(
@@ -98,6 +100,9 @@ account_dialog_context_finish(AccountDialogContext *context, GError **error)
 
   iface = ACCOUNT_DIALOG_CONTEXT_GET_IFACE(context);
 
+  /* the credentials are likely to change */
+  _accounts_verification_cache_invalidate_edited(context);
+
   if (iface->finish)
     return iface->finish(context, error);
 
@@ -0,0 +1,50 @@
+/*
+ * account-item-async.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:account-item-async
+ * @short_description: native asynchronous operations on accounts.
+ *
+ * #AccountItemAsync is implemented by #AccountItem subclasses whose plugin
+ * can perform operations on an account without blocking, for example over
+ * D-Bus. account_item_set_enabled_async() then calls the interface methods
+ * instead of running account_item_set_enabled() in place or in a worker
+ * thread. Plugins which can verify the credentials of their accounts
+ * implement the verify methods, used by account_item_verify_async().
+ *
+ * The methods live in an interface rather than in #AccountItemClass so that
+ * the class structure, which plugins subclass, keeps its size.
+ */
+
+#include "config.h"
+
+#include "account-item-async.h"
+#include "account-item.h"
+
+typedef AccountItemAsyncIface AccountItemAsyncInterface;
+
+G_DEFINE_INTERFACE(
+  AccountItemAsync,
+  account_item_async,
+  ACCOUNT_TYPE_ITEM
+)
+
+static void
+account_item_async_default_init(AccountItemAsyncIface *iface)
+{}
@@ -0,0 +1,62 @@
+/*
+ * account-item-async.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNT_ITEM_ASYNC_H_
+#define _ACCOUNT_ITEM_ASYNC_H_
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNT_TYPE_ITEM_ASYNC             (account_item_async_get_type ())
+#define ACCOUNT_ITEM_ASYNC(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNT_TYPE_ITEM_ASYNC, AccountItemAsync))
+#define ACCOUNT_IS_ITEM_ASYNC(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNT_TYPE_ITEM_ASYNC))
+#define ACCOUNT_ITEM_ASYNC_GET_IFACE(obj)   (G_TYPE_INSTANCE_GET_INTERFACE ((obj), ACCOUNT_TYPE_ITEM_ASYNC, AccountItemAsyncIface))
+
+typedef struct _AccountItemAsyncIface AccountItemAsyncIface;
+typedef struct _AccountItemAsync AccountItemAsync;
+
+struct _AccountItemAsyncIface
+{
+    GTypeInterface g_iface;
+
+    /* methods */
+    void     (* set_enabled_async)  (AccountItemAsync *item,
+                                     gboolean enabled,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+    gboolean (* set_enabled_finish) (AccountItemAsync *item,
+                                     GAsyncResult *result,
+                                     GError **error);
+    void     (* verify_async)       (AccountItemAsync *item,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+    gboolean (* verify_finish)      (AccountItemAsync *item,
+                                     GAsyncResult *result,
+                                     GError **error);
+};
+
+GType account_item_async_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* _ACCOUNT_ITEM_ASYNC_H_ */
@@ -28,13 +28,56 @@
  *
  * Account plugins must subclass of #AccountItem and implement the
  * account_item_set_enabled() method.
+ *
+ * User interfaces should prefer account_item_set_enabled_async(), which
+ * doesn't block the main loop for plugins which implement it natively or
+ * which declare, through account_item_class_set_thread_safe(), that their
+ * synchronous implementation can run in a worker thread.
+ *
+ * The avatar can be given either decoded, through the #AccountItem:avatar
+ * property, or as an #AccountsImage through #AccountItem:avatar-image. In the
+ * latter case it is only decoded when #AccountItem:avatar is read, in a
+ * worker thread: the property is %NULL, so that user interfaces show a
+ * placeholder, until it is notified once the avatar is ready. Avatars which
+ * are never displayed are thus never decoded, so plugins with many accounts
+ * should prefer it; they can also give the
+ * encoded image data with account_item_set_avatar_data(). User interfaces
+ * should then get the avatar at the size they display it at, with
+ * account_item_get_avatar_at_size(), so that the full resolution image is
+ * never decoded.
  */
 
 #include "config.h"
 
 #include "account-item.h"
+#include "accounts-image-cache.h"
+#include "accounts-private.h"
+
+#include "account-marshal.h"
+
+struct _AccountItemPrivate
+{
+  AccountsImage *avatar_image;
+  /* the last avatar_image pixbuf returned as transfer none, kept until
+   * release_id runs, so that the image cache owns the decoded pixels */
+  GdkPixbuf *avatar_loaded;
+  guint release_id;
+  /* while avatar_image is decoded */
+  GCancellable *avatar_loading;
+  /* the sizes avatar_image is decoded at, to their GCancellable */
+  GHashTable *sized_avatars_loading;
+  /* the key of the scaled copies of avatar in the default image cache, and
+   * the avatar they were scaled from */
+  gchar *scaled_key;
+  GdkPixbuf *scaled_from;
+};
+
+typedef struct _AccountItemPrivate AccountItemPrivate;
+
+#define PRIVATE(item) \
+  ((AccountItemPrivate *)account_item_get_instance_private((AccountItem *)(item)))
 
-G_DEFINE_TYPE(
+G_DEFINE_TYPE_WITH_PRIVATE(
   AccountItem,
   account_item,
   G_TYPE_OBJECT
@@ -52,11 +95,17 @@ enum
   PROP_ENABLED,
   PROP_DRAFT,
   PROP_CONNECTED,
+  PROP_AVATAR_IMAGE,
+  N_PROPERTIES
 };
 
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
 enum
 {
   VERIFIED,
+  VERIFICATION_FINISHED,
+  PROPERTIES_CHANGED,
   LAST_SIGNAL
 };
 
@@ -77,17 +126,358 @@ NOT_IMPLEMENTED(set_enabled,
                 return FALSE;)
 /* *INDENT-ON* */
 
+static GQuark
+thread_safe_quark(void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string("account-item-thread-safe");
+
+  return quark;
+}
+
+/* for thread-safe classes, whose set_enabled() doesn't touch the item */
+static void
+apply_enabled(AccountItem *item, gboolean enabled)
+{
+  enabled = !!enabled;
+
+  if (item->enabled == enabled)
+    return;
+
+  item->enabled = enabled;
+  g_object_notify_by_pspec(G_OBJECT(item), properties[PROP_ENABLED]);
+}
+
+static void
+set_enabled_thread(GTask *task, gpointer source_object, gpointer task_data,
+                   GCancellable *cancellable)
+{
+  AccountItem *item = source_object;
+  GError *error = NULL;
+
+  if (ACCOUNT_ITEM_GET_CLASS(item)->set_enabled(
+        item, GPOINTER_TO_INT(task_data), &error))
+  {
+    g_task_return_boolean(task, TRUE);
+  }
+  else
+    g_task_return_error(task, error);
+}
+
+static void
+set_enabled_thread_done(GObject *source_object, GAsyncResult *result,
+                        gpointer user_data)
+{
+  GTask *task = user_data;
+  GError *error = NULL;
+
+  if (g_task_propagate_boolean(G_TASK(result), &error))
+  {
+    /* back in the main thread, where the item can be changed */
+    apply_enabled(ACCOUNT_ITEM(source_object),
+                  GPOINTER_TO_INT(g_task_get_task_data(G_TASK(result))));
+    g_task_return_boolean(task, TRUE);
+  }
+  else
+    g_task_return_error(task, error);
+
+  g_object_unref(task);
+}
+
+static void
+_account_item_set_enabled_async(AccountItem *item, gboolean enabled,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+  GTask *task = g_task_new(item, cancellable, callback, user_data);
+  GError *error = NULL;
+
+  g_task_set_source_tag(task, _account_item_set_enabled_async);
+
+  if (g_task_return_error_if_cancelled(task))
+  {
+    g_object_unref(task);
+    return;
+  }
+
+  /* once started, report what really happened to the account */
+  g_task_set_check_cancellable(task, FALSE);
+
+  if (account_item_class_get_thread_safe(ACCOUNT_ITEM_GET_CLASS(item)))
+  {
+    /* the synchronous call can't be cancelled once started */
+    GTask *thread_task = g_task_new(item, NULL, set_enabled_thread_done, task);
+
+    g_task_set_task_data(thread_task, GINT_TO_POINTER(enabled), NULL);
+    g_task_run_in_thread(thread_task, set_enabled_thread);
+    g_object_unref(thread_task);
+
+    return;
+  }
+
+  if (account_item_set_enabled(item, enabled, &error))
+    g_task_return_boolean(task, TRUE);
+  else
+    g_task_return_error(task, error);
+
+  g_object_unref(task);
+}
+
+static gboolean
+_account_item_set_enabled_finish(AccountItem *item, GAsyncResult *result,
+                                 GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, item), FALSE);
+
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+static void
+_account_item_verify_async(AccountItem *item, GCancellable *cancellable,
+                           GAsyncReadyCallback callback, gpointer user_data)
+{
+  g_task_report_new_error(item, callback, user_data,
+                          _account_item_verify_async,
+                          G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                          "AccountItem::verify not implemented for `%s'",
+                          g_type_name(G_TYPE_FROM_INSTANCE(item)));
+}
+
+static gboolean
+_account_item_verify_finish(AccountItem *item, GAsyncResult *result,
+                            GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, item), FALSE);
+
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+static void
+cancel_avatar_loading(AccountItemPrivate *priv)
+{
+  if (priv->avatar_loading)
+  {
+    g_cancellable_cancel(priv->avatar_loading);
+    g_object_unref(priv->avatar_loading);
+    priv->avatar_loading = NULL;
+  }
+
+  if (priv->sized_avatars_loading)
+  {
+    GHashTableIter iter;
+    gpointer cancellable;
+
+    g_hash_table_iter_init(&iter, priv->sized_avatars_loading);
+
+    while (g_hash_table_iter_next(&iter, NULL, &cancellable))
+    {
+      g_cancellable_cancel(cancellable);
+      g_hash_table_iter_remove(&iter);
+    }
+  }
+}
+
+static gboolean
+release_avatar_idle(gpointer user_data)
+{
+  AccountItemPrivate *priv = PRIVATE(user_data);
+
+  priv->release_id = 0;
+  g_clear_object(&priv->avatar_loaded);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* keeps avatar for the callers of account_item_get_avatar() in this main
+ * loop iteration, takes the reference */
+static void
+hold_avatar(AccountItem *item, GdkPixbuf *avatar)
+{
+  AccountItemPrivate *priv = PRIVATE(item);
+
+  g_clear_object(&priv->avatar_loaded);
+  priv->avatar_loaded = avatar;
+
+  if (!priv->release_id)
+    priv->release_id = g_idle_add(release_avatar_idle, item);
+}
+
+static void
+avatar_loaded_cb(GObject *source_object, GAsyncResult *result,
+                 gpointer user_data)
+{
+  AccountItem *item = user_data;
+  AccountItemPrivate *priv = PRIVATE(item);
+  GError *error = NULL;
+  GdkPixbuf *avatar;
+
+  avatar = accounts_image_load_finish(ACCOUNTS_IMAGE(source_object), result,
+                                      &error);
+
+  /* unless the avatar changed in the meantime */
+  if (ACCOUNTS_IMAGE(source_object) == priv->avatar_image)
+  {
+    g_clear_object(&priv->avatar_loading);
+
+    if (avatar)
+    {
+      hold_avatar(item, g_object_ref(avatar));
+      g_object_notify_by_pspec(G_OBJECT(item), properties[PROP_AVATAR]);
+    }
+    else
+    {
+      g_warning("Cannot load the avatar of `%s': %s", item->name,
+                error->message);
+    }
+  }
+
+  if (avatar)
+    g_object_unref(avatar);
+
+  if (error)
+    g_error_free(error);
+
+  g_object_unref(item);
+}
+
+typedef struct _SizedAvatarLoad
+{
+  AccountItem *item;
+  GCancellable *cancellable;
+  gint size;
+} SizedAvatarLoad;
+
+static void
+sized_avatar_loaded_cb(GObject *source_object, GAsyncResult *result,
+                       gpointer user_data)
+{
+  SizedAvatarLoad *load = user_data;
+  AccountItemPrivate *priv = PRIVATE(load->item);
+  GError *error = NULL;
+  GdkPixbuf *avatar;
+
+  avatar = accounts_image_load_finish(ACCOUNTS_IMAGE(source_object), result,
+                                      &error);
+
+  /* unless the avatar changed in the meantime, the cache has it now */
+  if (g_hash_table_lookup(priv->sized_avatars_loading,
+                          GINT_TO_POINTER(load->size)) == load->cancellable)
+  {
+    g_hash_table_remove(priv->sized_avatars_loading,
+                        GINT_TO_POINTER(load->size));
+
+    if (avatar)
+    {
+      g_object_notify_by_pspec(G_OBJECT(load->item),
+                               properties[PROP_AVATAR]);
+    }
+    else
+    {
+      g_warning("Cannot load the avatar of `%s': %s", load->item->name,
+                error->message);
+    }
+  }
+
+  if (avatar)
+    g_object_unref(avatar);
+
+  if (error)
+    g_error_free(error);
+
+  g_object_unref(load->cancellable);
+  g_object_unref(load->item);
+  g_slice_free(SizedAvatarLoad, load);
+}
+
+static void
+load_sized_avatar(AccountItem *item, gint size)
+{
+  AccountItemPrivate *priv = PRIVATE(item);
+  SizedAvatarLoad *load;
+
+  if (!priv->sized_avatars_loading)
+  {
+    priv->sized_avatars_loading =
+      g_hash_table_new_full(NULL, NULL, NULL, g_object_unref);
+  }
+  else if (g_hash_table_contains(priv->sized_avatars_loading,
+                                 GINT_TO_POINTER(size)))
+  {
+    return;
+  }
+
+  load = g_slice_new(SizedAvatarLoad);
+  load->item = g_object_ref(item);
+  load->cancellable = g_cancellable_new();
+  load->size = size;
+  g_hash_table_insert(priv->sized_avatars_loading, GINT_TO_POINTER(size),
+                      g_object_ref(load->cancellable));
+  accounts_image_load_async(priv->avatar_image, size, load->cancellable,
+                            sized_avatar_loaded_cb, load);
+}
+
+static void
+on_service_icon_notify(AccountService *service, GParamSpec *pspec,
+                       AccountItem *item)
+{
+  /* don't decode an icon nobody asked for yet */
+  GdkPixbuf *icon = service->icon;
+
+  if (item->service_icon == icon)
+    return;
+
+  if (icon)
+    g_object_ref(icon);
+
+  if (item->service_icon)
+    g_object_unref(item->service_icon);
+
+  item->service_icon = icon;
+  g_object_notify_by_pspec(G_OBJECT(item), properties[PROP_SEVICE_ICON]);
+}
+
+static void
+drop_scaled_avatars(AccountItemPrivate *priv)
+{
+  if (priv->scaled_from)
+  {
+    accounts_image_cache_remove(accounts_image_cache_get_default(),
+                                priv->scaled_key);
+    priv->scaled_from = NULL;
+  }
+}
+
 static void
 account_item_dispose(GObject *object)
 {
   AccountItem *item = ACCOUNT_ITEM(object);
 
+  cancel_avatar_loading(PRIVATE(item));
+  drop_scaled_avatars(PRIVATE(item));
+
   if (item->avatar)
   {
     g_object_unref(item->avatar);
     item->avatar = NULL;
   }
 
+  if (PRIVATE(item)->avatar_image)
+  {
+    g_object_unref(PRIVATE(item)->avatar_image);
+    PRIVATE(item)->avatar_image = NULL;
+  }
+
+  g_clear_object(&PRIVATE(item)->avatar_loaded);
+
+  if (PRIVATE(item)->release_id)
+  {
+    g_source_remove(PRIVATE(item)->release_id);
+    PRIVATE(item)->release_id = 0;
+  }
+
   if (item->service_icon)
   {
     g_object_unref(item->service_icon);
@@ -111,10 +501,24 @@ account_item_finalize(GObject *object)
   g_free(item->name);
   g_free(item->display_name);
   g_free(item->service_name);
+  g_free(PRIVATE(item)->scaled_key);
+
+  if (PRIVATE(item)->sized_avatars_loading)
+    g_hash_table_destroy(PRIVATE(item)->sized_avatars_loading);
 
   G_OBJECT_CLASS(account_item_parent_class)->finalize(object);
 }
 
+static void
+account_item_dispatch_properties_changed(GObject *object, guint n_pspecs,
+                                         GParamSpec **pspecs)
+{
+  g_signal_emit(object, signals[PROPERTIES_CHANGED], 0, n_pspecs, pspecs);
+
+  G_OBJECT_CLASS(account_item_parent_class)->dispatch_properties_changed(
+    object, n_pspecs, pspecs);
+}
+
 static void
 account_item_set_property(GObject *object, guint property_id,
                           const GValue *value, GParamSpec *pspec)
@@ -129,27 +533,27 @@ account_item_set_property(GObject *object, guint property_id,
   {
     case PROP_NAME:
     {
-      g_free(item->name);
-      item->name = g_value_dup_string(value);
+      account_item_set_name(item, g_value_get_string(value));
       break;
     }
     case PROP_DISPLAY_NAME:
     {
-      g_free(item->display_name);
-      item->display_name = g_value_dup_string(value);
+      account_item_set_display_name(item, g_value_get_string(value));
       break;
     }
     case PROP_AVATAR:
     {
-      if (item->avatar)
-        g_object_unref(item->avatar);
-
-      item->avatar = g_value_dup_object(value);
+      account_item_set_avatar(item, g_value_get_object(value));
+      break;
+    }
+    case PROP_AVATAR_IMAGE:
+    {
+      account_item_set_avatar_image(item, g_value_get_object(value));
       break;
     }
     case PROP_SUPPORS_AVATAR:
     {
-      item->supports_avatar = g_value_get_boolean(value);
+      account_item_set_supports_avatar(item, g_value_get_boolean(value));
       break;
     }
     case PROP_SEVICE:
@@ -166,10 +570,17 @@ account_item_set_property(GObject *object, guint property_id,
 
         g_object_get(item->service,
                      "display-name", &item->service_name,
-                     "icon", &item->service_icon,
                      "supports-avatar", &supports_avatar,
                      NULL);
         item->supports_avatar = supports_avatar;
+
+        /* icons given by name are resolved on first access */
+        if (item->service->icon)
+          item->service_icon = g_object_ref(item->service->icon);
+
+        /* for icons which are decoded after the item is created */
+        g_signal_connect_object(item->service, "notify::icon",
+                                G_CALLBACK(on_service_icon_notify), item, 0);
       }
 
       break;
@@ -206,7 +617,12 @@ account_item_get_property(GObject *object, guint property_id, GValue *value,
     }
     case PROP_AVATAR:
     {
-      g_value_set_object(value, item->avatar);
+      g_value_set_object(value, account_item_get_avatar(item));
+      break;
+    }
+    case PROP_AVATAR_IMAGE:
+    {
+      g_value_set_object(value, PRIVATE(item)->avatar_image);
       break;
     }
     case PROP_SUPPORS_AVATAR:
@@ -221,7 +637,7 @@ account_item_get_property(GObject *object, guint property_id, GValue *value,
     }
     case PROP_SEVICE_ICON:
     {
-      g_value_set_object(value, item->service_icon);
+      g_value_set_object(value, account_item_get_service_icon(item));
       break;
     }
     case PROP_SEVICE:
@@ -261,84 +677,117 @@ account_item_class_init(AccountItemClass *klass)
   object_class->finalize = account_item_finalize;
   object_class->set_property = account_item_set_property;
   object_class->get_property = account_item_get_property;
+  object_class->dispatch_properties_changed =
+    account_item_dispatch_properties_changed;
 
   klass->set_enabled = _account_item_set_enabled;
 
-  g_object_class_install_property(
-    object_class, PROP_NAME,
+  properties[PROP_NAME] =
     g_param_spec_string("name",
                         "Name",
                         "Account name", NULL,
-                        G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_DISPLAY_NAME,
+                        G_PARAM_WRITABLE | G_PARAM_READABLE |
+                        G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_DISPLAY_NAME] =
     g_param_spec_string("display-name",
                         "Display name",
                         "Display name",
                         NULL,
-                        G_PARAM_WRITABLE | G_PARAM_READABLE));
-
-  g_object_class_install_property(
-    object_class, PROP_AVATAR,
+                        G_PARAM_WRITABLE | G_PARAM_READABLE |
+                        G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_AVATAR] =
     g_param_spec_object("avatar",
                         "Avatar",
                         "Account avatar",
                         GDK_TYPE_PIXBUF,
-                        G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_SUPPORS_AVATAR,
+                        G_PARAM_WRITABLE | G_PARAM_READABLE |
+                        G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_AVATAR_IMAGE] =
+    g_param_spec_object("avatar-image",
+                        "Avatar image",
+                        "Account avatar, decoded on demand",
+                        ACCOUNTS_TYPE_IMAGE,
+                        G_PARAM_WRITABLE | G_PARAM_READABLE |
+                        G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_SUPPORS_AVATAR] =
     g_param_spec_boolean("supports-avatar",
                          "Supports avatar",
                          "Supports avatar",
                          FALSE,
-                         G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_SEVICE_NAME,
+                         G_PARAM_WRITABLE | G_PARAM_READABLE |
+                         G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_SEVICE_NAME] =
     g_param_spec_string("service-name",
                         "Service name",
                         "Service name",
                         0,
-                        G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_SEVICE_ICON,
+                        G_PARAM_READABLE);
+  properties[PROP_SEVICE_ICON] =
     g_param_spec_object("service-icon",
                         "Service icon",
                         "Service icon",
                         GDK_TYPE_PIXBUF,
-                        G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_SEVICE,
+                        G_PARAM_READABLE);
+  properties[PROP_SEVICE] =
     g_param_spec_object(
       "service",
       "Service",
       "Service",
       ACCOUNT_TYPE_SERVICE,
-      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_ENABLED,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_READABLE);
+  properties[PROP_ENABLED] =
     g_param_spec_boolean("enabled",
                          "Enabled",
                          "Account enabled",
                          FALSE,
-                         G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_CONNECTED,
+                         G_PARAM_READABLE);
+  properties[PROP_CONNECTED] =
     g_param_spec_boolean("connected",
                          "Connected",
                          "Account connected",
                          FALSE,
-                         G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_DRAFT,
+                         G_PARAM_READABLE);
+  properties[PROP_DRAFT] =
     g_param_spec_boolean("draft",
                          "Draft",
                          "Account in draft status",
                          FALSE,
-                         G_PARAM_READABLE));
+                         G_PARAM_READABLE);
+  g_object_class_install_properties(object_class, N_PROPERTIES, properties);
+
   signals[VERIFIED] = g_signal_new(
       "verified", G_TYPE_FROM_CLASS(klass),
       G_SIGNAL_ACTION | G_SIGNAL_RUN_LAST, 0, NULL, NULL,
       g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+  /**
+   * AccountItem::verification-finished:
+   * @account: the #AccountItem.
+   * @error:(nullable): a #GError, or %NULL if the verification succeeded.
+   *
+   * Emitted by the #AccountsVerifier when a verification of the account
+   * credentials it runs completes, including when it times out.
+   */
+  signals[VERIFICATION_FINISHED] = g_signal_new(
+      "verification-finished", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, g_cclosure_marshal_VOID__BOXED, G_TYPE_NONE, 1,
+      G_TYPE_ERROR);
+
+  /**
+   * AccountItem::properties-changed:
+   * @account: the #AccountItem.
+   * @n_pspecs: the number of properties which changed.
+   * @pspecs:(array length=n_pspecs): the #GParamSpec of each of them.
+   *
+   * Emitted once for all the properties whose notifications were dispatched
+   * together, just before the #GObject::notify emissions. Outside of
+   * g_object_freeze_notify() this means once per property; for the changes
+   * made with account_item_update(), once in total.
+   */
+  signals[PROPERTIES_CHANGED] = g_signal_new(
+      "properties-changed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST, 0,
+      NULL, NULL, account_marshal_VOID__UINT_POINTER, G_TYPE_NONE, 2,
+      G_TYPE_UINT, G_TYPE_POINTER);
 }
 
 static void
@@ -356,7 +805,10 @@ account_item_init(AccountItem *item)
  * This is a virtual method that must be implemented by account plugins by
  * subclassing #AccountItem. The method's task is to enable/disable the account;
  * to do so, set the #AccountItem:enabled member to the desired value and call
- * g_object_notify() on the #AccountItem:enabled property.
+ * g_object_notify() on the #AccountItem:enabled property. Plugins which
+ * declared their implementation thread-safe with
+ * account_item_class_set_thread_safe() must not do that, the property is
+ * then set when the method returns %TRUE.
  *
  * Returns: %TRUE if success, %FALSE on error.
  *
@@ -368,51 +820,780 @@ account_item_init(AccountItem *item)
 gboolean
 account_item_set_enabled(AccountItem *account, gboolean enabled, GError **error)
 {
+  AccountItemClass *klass;
+
   g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
 
-  return ACCOUNT_ITEM_GET_CLASS(account)->set_enabled(account, enabled, error);
+  klass = ACCOUNT_ITEM_GET_CLASS(account);
+
+  if (!klass->set_enabled(account, enabled, error))
+    return FALSE;
+
+  if (account_item_class_get_thread_safe(klass))
+    apply_enabled(account, enabled);
+
+  return TRUE;
 }
 
 /**
- * account_item_get_plugin:
+ * account_item_set_enabled_async:
  * @account: the #AccountItem.
+ * @enabled: whether to enable or disable the account.
+ * @cancellable:(nullable): a #GCancellable, or %NULL.
+ * @callback: a #GAsyncReadyCallback to call when done.
+ * @user_data: the data to pass to @callback.
  *
- * Gets the plugin which manages this account item.
+ * Asynchronously enables or disables @account; call
+ * account_item_set_enabled_finish() from @callback to get the result.
  *
- * Returns:(transfer none): the #AccountPlugin of this @account
+ * Plugins can implement this natively through the #AccountItemAsync
+ * interface. Otherwise the
+ * synchronous account_item_set_enabled() is used: in a worker thread if the
+ * plugin declared it thread-safe with account_item_class_set_thread_safe(),
+ * in which case #AccountItem:enabled is set in the main thread once it
+ * returns, or else right away, in the calling thread.
+ */
+void
+account_item_set_enabled_async(AccountItem *account, gboolean enabled,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+  g_return_if_fail(!cancellable || G_IS_CANCELLABLE(cancellable));
+
+  if (ACCOUNT_IS_ITEM_ASYNC(account) &&
+      ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->set_enabled_async)
+  {
+    ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->set_enabled_async(
+      ACCOUNT_ITEM_ASYNC(account), enabled, cancellable, callback, user_data);
+  }
+  else
+  {
+    _account_item_set_enabled_async(account, enabled, cancellable, callback,
+                                    user_data);
+  }
+}
+
+/**
+ * account_item_set_enabled_finish:
+ * @account: the #AccountItem.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: a GError for error reporting, or %NULL.
  *
+ * Finishes an operation started with account_item_set_enabled_async().
+ *
+ * Returns: %TRUE if success, %FALSE on error.
  */
-AccountPlugin *
-account_item_get_plugin(AccountItem *account)
+gboolean
+account_item_set_enabled_finish(AccountItem *account, GAsyncResult *result,
+                                GError **error)
 {
-  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+  g_return_val_if_fail(G_IS_ASYNC_RESULT(result), FALSE);
 
-  if (account->service)
-    return account_service_get_plugin(account->service);
+  if (ACCOUNT_IS_ITEM_ASYNC(account) &&
+      ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->set_enabled_finish)
+  {
+    return ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->set_enabled_finish(
+      ACCOUNT_ITEM_ASYNC(account), result, error);
+  }
 
-  return NULL;
+  return _account_item_set_enabled_finish(account, result, error);
 }
 
 /**
- * account_item_get_service:
+ * account_item_verify_async:
  * @account: the #AccountItem.
+ * @cancellable:(nullable): a #GCancellable, or %NULL.
+ * @callback: a #GAsyncReadyCallback to call when done.
+ * @user_data: the data to pass to @callback.
  *
- * Gets the service which this account item provides.
+ * Asynchronously verifies the credentials of @account against its service;
+ * call account_item_verify_finish() from @callback to get the result.
  *
- * Returns:(transfer none): the #AccountService of this account
+ * Plugins which support verification implement the verify methods of
+ * #AccountItemAsync and should honour @cancellable; for other accounts this
+ * fails with %G_IO_ERROR_NOT_SUPPORTED. To verify many accounts, use an
+ * #AccountsVerifier.
  */
-AccountService *
-account_item_get_service(AccountItem *account)
+void
+account_item_verify_async(AccountItem *account, GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data)
 {
-  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+  g_return_if_fail(!cancellable || G_IS_CANCELLABLE(cancellable));
 
-  return account->service;
+  if (ACCOUNT_IS_ITEM_ASYNC(account) &&
+      ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->verify_async)
+  {
+    ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->verify_async(
+      ACCOUNT_ITEM_ASYNC(account), cancellable, callback, user_data);
+  }
+  else
+    _account_item_verify_async(account, cancellable, callback, user_data);
 }
 
+/**
+ * account_item_verify_finish:
+ * @account: the #AccountItem.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with account_item_verify_async().
+ *
+ * Returns: %TRUE if the credentials are valid, %FALSE on error.
+ */
 gboolean
-account_item_is_connected(AccountItem *account)
+account_item_verify_finish(AccountItem *account, GAsyncResult *result,
+                           GError **error)
 {
   g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+  g_return_val_if_fail(G_IS_ASYNC_RESULT(result), FALSE);
 
-  return account->connected;
+  if (ACCOUNT_IS_ITEM_ASYNC(account) &&
+      ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->verify_finish)
+  {
+    return ACCOUNT_ITEM_ASYNC_GET_IFACE(account)->verify_finish(
+      ACCOUNT_ITEM_ASYNC(account), result, error);
+  }
+
+  return _account_item_verify_finish(account, result, error);
+}
+
+/**
+ * account_item_class_set_thread_safe:
+ * @klass: an #AccountItemClass.
+ * @thread_safe: whether the #AccountItemClass.set_enabled() implementation of
+ * @klass can run in a worker thread.
+ *
+ * Declares whether the synchronous account_item_set_enabled() implementation
+ * of @klass and of its subclasses can be called from a worker thread while
+ * the main loop keeps running. This is meant to be called from the class_init
+ * function of plugins which don't implement #AccountItemAsync.
+ *
+ * The implementation then runs while the main thread keeps using the
+ * #AccountItem, so it must neither change the item nor emit signals on it:
+ * #AccountItem:enabled is set by account_item_set_enabled() and
+ * account_item_set_enabled_async() once it returns %TRUE, in the thread
+ * they were called from.
+ */
+void
+account_item_class_set_thread_safe(AccountItemClass *klass,
+                                   gboolean thread_safe)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM_CLASS(klass));
+
+  /* 0 means not set, so that subclasses inherit the value */
+  g_type_set_qdata(G_TYPE_FROM_CLASS(klass), thread_safe_quark(),
+                   GINT_TO_POINTER(thread_safe ? 1 : 2));
+}
+
+/**
+ * account_item_class_get_thread_safe:
+ * @klass: an #AccountItemClass.
+ *
+ * Returns: %TRUE if @klass, or the closest of its ancestors which declared
+ * it, has been declared thread-safe with account_item_class_set_thread_safe().
+ */
+gboolean
+account_item_class_get_thread_safe(AccountItemClass *klass)
+{
+  GType type;
+
+  g_return_val_if_fail(ACCOUNT_IS_ITEM_CLASS(klass), FALSE);
+
+  for (type = G_TYPE_FROM_CLASS(klass); type; type = g_type_parent(type))
+  {
+    gint thread_safe = GPOINTER_TO_INT(g_type_get_qdata(type,
+                                                        thread_safe_quark()));
+
+    if (thread_safe)
+      return thread_safe == 1;
+
+    if (type == ACCOUNT_TYPE_ITEM)
+      break;
+  }
+
+  return FALSE;
+}
+
+/**
+ * account_item_update:
+ * @account: the #AccountItem.
+ * @first_property_name: the name of the first property to set.
+ * @...: the value of the first property, followed optionally by more
+ * name/value pairs, followed by %NULL.
+ *
+ * Sets several properties of @account at once, like g_object_set(), but
+ * with the notifications frozen: the properties which actually changed are
+ * reported by a single #AccountItem::properties-changed emission, and thus a
+ * single #AccountsModel::item-changed, instead of one each.
+ *
+ * Plugins updating read-only state too, such as with
+ * account_item_set_connected(), can get the same result by wrapping all the
+ * changes between g_object_freeze_notify() and g_object_thaw_notify().
+ */
+void
+account_item_update(AccountItem *account, const gchar *first_property_name,
+                    ...)
+{
+  va_list args;
+
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  g_object_freeze_notify(G_OBJECT(account));
+  va_start(args, first_property_name);
+  g_object_set_valist(G_OBJECT(account), first_property_name, args);
+  va_end(args);
+  g_object_thaw_notify(G_OBJECT(account));
+}
+
+/**
+ * account_item_get_plugin:
+ * @account: the #AccountItem.
+ *
+ * Gets the plugin which manages this account item.
+ *
+ * Returns:(transfer none): the #AccountPlugin of this @account
+ *
+ */
+AccountPlugin *
+account_item_get_plugin(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  if (account->service)
+    return account_service_get_plugin(account->service);
+
+  return NULL;
+}
+
+/**
+ * account_item_get_service:
+ * @account: the #AccountItem.
+ *
+ * Gets the service which this account item provides.
+ *
+ * Returns:(transfer none): the #AccountService of this account
+ */
+AccountService *
+account_item_get_service(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  return account->service;
+}
+
+gboolean
+account_item_is_connected(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+
+  return account->connected;
+}
+
+/**
+ * account_item_get_name:
+ * @account: the #AccountItem.
+ *
+ * Returns:(transfer none): the value of the #AccountItem:name property.
+ */
+const gchar *
+account_item_get_name(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  return account->name;
+}
+
+/**
+ * account_item_set_name:
+ * @account: the #AccountItem.
+ * @name: the new name.
+ *
+ * Sets the #AccountItem:name property, notifying it only if it changes.
+ */
+void
+account_item_set_name(AccountItem *account, const gchar *name)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  if (!g_strcmp0(account->name, name))
+    return;
+
+  g_free(account->name);
+  account->name = g_strdup(name);
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_NAME]);
+}
+
+/**
+ * account_item_get_display_name:
+ * @account: the #AccountItem.
+ *
+ * Returns:(transfer none): the value of the #AccountItem:display-name
+ * property.
+ */
+const gchar *
+account_item_get_display_name(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  return account->display_name;
+}
+
+/**
+ * account_item_set_display_name:
+ * @account: the #AccountItem.
+ * @display_name: the new display name.
+ *
+ * Sets the #AccountItem:display-name property, notifying it only if it
+ * changes.
+ */
+void
+account_item_set_display_name(AccountItem *account, const gchar *display_name)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  if (!g_strcmp0(account->display_name, display_name))
+    return;
+
+  g_free(account->display_name);
+  account->display_name = g_strdup(display_name);
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_DISPLAY_NAME]);
+}
+
+/**
+ * account_item_get_avatar:
+ * @account: the #AccountItem.
+ *
+ * Gets the avatar. If it is given as an #AccountsImage which is not decoded
+ * yet, this starts decoding it in a worker thread and returns %NULL; the
+ * #AccountItem:avatar property is notified when it is ready. The decoded
+ * avatar is owned by the default #AccountsImageCache: the returned pixbuf is
+ * only guaranteed to stay valid until the next main loop iteration, take a
+ * reference to keep it longer. Once evicted from the cache, the avatar is
+ * decoded again when it is read.
+ *
+ * Returns:(transfer none)(nullable): the value of the #AccountItem:avatar
+ * property.
+ */
+GdkPixbuf *
+account_item_get_avatar(AccountItem *account)
+{
+  AccountItemPrivate *priv;
+  GdkPixbuf *avatar;
+
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  priv = PRIVATE(account);
+
+  if (account->avatar || !priv->avatar_image)
+    return account->avatar;
+
+  if (priv->avatar_loaded)
+    return priv->avatar_loaded;
+
+  avatar = accounts_image_lookup(priv->avatar_image, 0);
+
+  if (!avatar)
+  {
+    if (!priv->avatar_loading)
+    {
+      priv->avatar_loading = g_cancellable_new();
+      accounts_image_load_async(priv->avatar_image, 0, priv->avatar_loading,
+                                avatar_loaded_cb, g_object_ref(account));
+    }
+
+    return NULL;
+  }
+
+  /* takes the reference returned by the cache */
+  hold_avatar(account, avatar);
+
+  return avatar;
+}
+
+/**
+ * account_item_set_avatar:
+ * @account: the #AccountItem.
+ * @avatar:(nullable): the new avatar.
+ *
+ * Sets the #AccountItem:avatar property, notifying it only if it changes.
+ * This unsets #AccountItem:avatar-image.
+ */
+void
+account_item_set_avatar(AccountItem *account, GdkPixbuf *avatar)
+{
+  AccountItemPrivate *priv;
+
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  priv = PRIVATE(account);
+
+  if (account->avatar == avatar && (avatar || !priv->avatar_image))
+    return;
+
+  g_object_freeze_notify(G_OBJECT(account));
+  drop_scaled_avatars(priv);
+
+  if (avatar)
+    g_object_ref(avatar);
+
+  if (account->avatar)
+    g_object_unref(account->avatar);
+
+  account->avatar = avatar;
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_AVATAR]);
+
+  if (priv->avatar_image)
+  {
+    cancel_avatar_loading(priv);
+    g_object_unref(priv->avatar_image);
+    priv->avatar_image = NULL;
+    g_clear_object(&priv->avatar_loaded);
+    g_object_notify_by_pspec(G_OBJECT(account),
+                             properties[PROP_AVATAR_IMAGE]);
+  }
+
+  g_object_thaw_notify(G_OBJECT(account));
+}
+
+/**
+ * account_item_get_avatar_at_size:
+ * @account: the #AccountItem.
+ * @size: the size of the square the avatar must fit in, in pixels.
+ *
+ * Gets the avatar scaled down, if needed, to fit in a square of @size
+ * pixels. If it is given as an #AccountsImage, it is decoded directly at
+ * that size, in a worker thread, see accounts_image_load_async(): %NULL is
+ * returned until then, and #AccountItem:avatar is notified once it is ready,
+ * so that it can be gotten again. Otherwise the scaled copies are kept in
+ * the default #AccountsImageCache until the avatar changes.
+ *
+ * Returns:(transfer full)(nullable): the avatar, or %NULL.
+ */
+GdkPixbuf *
+account_item_get_avatar_at_size(AccountItem *account, gint size)
+{
+  static gint serial = 0;
+  AccountsImageCache *cache = accounts_image_cache_get_default();
+  AccountItemPrivate *priv;
+  GdkPixbuf *avatar;
+  gint width, height;
+
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+  g_return_val_if_fail(size > 0, NULL);
+
+  priv = PRIVATE(account);
+
+  if (priv->avatar_image)
+  {
+    avatar = accounts_image_lookup(priv->avatar_image, size);
+
+    if (!avatar)
+      load_sized_avatar(account, size);
+
+    return avatar;
+  }
+
+  if (!account->avatar)
+    return NULL;
+
+  width = gdk_pixbuf_get_width(account->avatar);
+  height = gdk_pixbuf_get_height(account->avatar);
+
+  if (width <= size && height <= size)
+    return g_object_ref(account->avatar);
+
+  /* plugins may also replace the avatar field directly */
+  if (priv->scaled_from != account->avatar)
+    drop_scaled_avatars(priv);
+
+  if (!priv->scaled_key)
+  {
+    priv->scaled_key = g_strdup_printf("avatar:%d",
+                                       g_atomic_int_add(&serial, 1));
+  }
+  else if ((avatar = accounts_image_cache_lookup(cache, priv->scaled_key,
+                                                 size)))
+  {
+    return avatar;
+  }
+
+  if (width >= height)
+  {
+    height = MAX(1, height * size / width);
+    width = size;
+  }
+  else
+  {
+    width = MAX(1, width * size / height);
+    height = size;
+  }
+
+  avatar = gdk_pixbuf_scale_simple(account->avatar, width, height,
+                                   GDK_INTERP_BILINEAR);
+
+  if (avatar)
+  {
+    accounts_image_cache_insert(cache, priv->scaled_key, size, avatar);
+    priv->scaled_from = account->avatar;
+  }
+
+  return avatar;
+}
+
+/**
+ * account_item_set_avatar_data:
+ * @account: the #AccountItem.
+ * @data:(nullable): the encoded avatar, in any format supported by
+ * #GdkPixbufLoader, or %NULL.
+ *
+ * Sets the avatar from its encoded data, through #AccountItem:avatar-image.
+ * Nothing is decoded until the avatar is read, preferably at the size it is
+ * displayed at, with account_item_get_avatar_at_size().
+ */
+void
+account_item_set_avatar_data(AccountItem *account, GBytes *data)
+{
+  AccountsImage *image = NULL;
+
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  if (data)
+    image = accounts_image_new_from_bytes(data);
+
+  account_item_set_avatar_image(account, image);
+
+  if (image)
+    g_object_unref(image);
+}
+
+/**
+ * account_item_get_avatar_image:
+ * @account: the #AccountItem.
+ *
+ * Returns:(transfer none)(nullable): the value of the
+ * #AccountItem:avatar-image property.
+ */
+AccountsImage *
+account_item_get_avatar_image(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  return PRIVATE(account)->avatar_image;
+}
+
+/**
+ * account_item_set_avatar_image:
+ * @account: the #AccountItem.
+ * @image:(nullable): the new avatar.
+ *
+ * Sets the #AccountItem:avatar-image property, to provide an avatar which is
+ * only decoded when #AccountItem:avatar is read. This unsets any avatar given
+ * decoded; both properties are notified if they change.
+ */
+void
+account_item_set_avatar_image(AccountItem *account, AccountsImage *image)
+{
+  AccountItemPrivate *priv;
+
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+  g_return_if_fail(!image || ACCOUNTS_IS_IMAGE(image));
+
+  priv = PRIVATE(account);
+
+  if (priv->avatar_image == image && (image || !account->avatar))
+    return;
+
+  g_object_freeze_notify(G_OBJECT(account));
+
+  if (image)
+    g_object_ref(image);
+
+  cancel_avatar_loading(priv);
+
+  if (priv->avatar_image)
+    g_object_unref(priv->avatar_image);
+
+  priv->avatar_image = image;
+  g_clear_object(&priv->avatar_loaded);
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_AVATAR_IMAGE]);
+
+  if (account->avatar)
+  {
+    g_object_unref(account->avatar);
+    account->avatar = NULL;
+  }
+
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_AVATAR]);
+  g_object_thaw_notify(G_OBJECT(account));
+}
+
+/**
+ * account_item_get_supports_avatar:
+ * @account: the #AccountItem.
+ *
+ * Returns: the value of the #AccountItem:supports-avatar property.
+ */
+gboolean
+account_item_get_supports_avatar(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+
+  return account->supports_avatar;
+}
+
+/**
+ * account_item_set_supports_avatar:
+ * @account: the #AccountItem.
+ * @supports_avatar: whether the account supports avatars.
+ *
+ * Sets the #AccountItem:supports-avatar property, notifying it only if it
+ * changes.
+ */
+void
+account_item_set_supports_avatar(AccountItem *account,
+                                 gboolean supports_avatar)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  supports_avatar = !!supports_avatar;
+
+  if (account->supports_avatar == supports_avatar)
+    return;
+
+  account->supports_avatar = supports_avatar;
+  g_object_notify_by_pspec(G_OBJECT(account),
+                           properties[PROP_SUPPORS_AVATAR]);
+}
+
+/**
+ * account_item_get_service_name:
+ * @account: the #AccountItem.
+ *
+ * Returns:(transfer none): the value of the #AccountItem:service-name
+ * property.
+ */
+const gchar *
+account_item_get_service_name(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  return account->service_name;
+}
+
+/**
+ * account_item_get_service_icon:
+ * @account: the #AccountItem.
+ *
+ * Gets the icon of the service of the account, decoding it if this is the
+ * first time it is needed, see account_service_get_icon().
+ *
+ * Returns:(transfer none)(nullable): the value of the
+ * #AccountItem:service-icon property.
+ */
+GdkPixbuf *
+account_item_get_service_icon(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), NULL);
+
+  if (!account->service_icon && account->service)
+  {
+    GdkPixbuf *icon = account_service_get_icon(account->service);
+
+    if (icon)
+      account->service_icon = g_object_ref(icon);
+  }
+
+  return account->service_icon;
+}
+
+/**
+ * account_item_get_enabled:
+ * @account: the #AccountItem.
+ *
+ * Returns: the value of the #AccountItem:enabled property.
+ */
+gboolean
+account_item_get_enabled(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+
+  return account->enabled;
+}
+
+/**
+ * account_item_get_draft:
+ * @account: the #AccountItem.
+ *
+ * Returns: the value of the #AccountItem:draft property.
+ */
+gboolean
+account_item_get_draft(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+
+  return account->draft;
+}
+
+/**
+ * account_item_set_draft:
+ * @account: the #AccountItem.
+ * @draft: whether the account is a draft.
+ *
+ * Sets the #AccountItem:draft property, notifying it only if it changes. The
+ * property is read-only for the users of the account: this is meant to be
+ * called by the plugin managing it.
+ */
+void
+account_item_set_draft(AccountItem *account, gboolean draft)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  draft = !!draft;
+
+  if (account->draft == draft)
+    return;
+
+  account->draft = draft;
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_DRAFT]);
+}
+
+/**
+ * account_item_get_connected:
+ * @account: the #AccountItem.
+ *
+ * Returns: the value of the #AccountItem:connected property.
+ */
+gboolean
+account_item_get_connected(AccountItem *account)
+{
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(account), FALSE);
+
+  return account->connected;
+}
+
+/**
+ * account_item_set_connected:
+ * @account: the #AccountItem.
+ * @connected: whether the account is connected.
+ *
+ * Sets the #AccountItem:connected property, notifying it only if it changes.
+ * The property is read-only for the users of the account: this is meant to be
+ * called by the plugin managing it.
+ */
+void
+account_item_set_connected(AccountItem *account, gboolean connected)
+{
+  g_return_if_fail(ACCOUNT_IS_ITEM(account));
+
+  connected = !!connected;
+
+  if (account->connected == connected)
+    return;
+
+  account->connected = connected;
+  g_object_notify_by_pspec(G_OBJECT(account), properties[PROP_CONNECTED]);
 }
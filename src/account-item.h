@@ -20,6 +20,7 @@
 #define _ACCOUNT_ITEM_H_
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
 
 G_BEGIN_DECLS
@@ -35,6 +36,8 @@ typedef struct _AccountItemClass AccountItemClass;
 typedef struct _AccountItem AccountItem;
 
 #include "account-service.h"
+#include "account-item-async.h"
+#include "accounts-image.h"
 
 struct _AccountItemClass
 {
@@ -51,8 +54,11 @@ struct _AccountItem
     /*< protected >*/
     gchar *name;
     gchar *display_name;
+    /* NULL when the avatar is loaded on demand from an AccountsImage */
     GdkPixbuf *avatar;
     gchar *service_name;
+    /* NULL until first read if the service icon is given by name, use
+     * account_item_get_service_icon() */
     GdkPixbuf *service_icon;
     AccountService *service;
     guint enabled : 1;
@@ -66,10 +72,56 @@ GType account_item_get_type (void) G_GNUC_CONST;
 gboolean account_item_set_enabled (AccountItem *account, gboolean enabled,
                                    GError **error);
 
+void account_item_set_enabled_async (AccountItem *account, gboolean enabled,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+gboolean account_item_set_enabled_finish (AccountItem *account,
+                                          GAsyncResult *result,
+                                          GError **error);
+
+void account_item_verify_async (AccountItem *account,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data);
+gboolean account_item_verify_finish (AccountItem *account,
+                                     GAsyncResult *result, GError **error);
+
+void account_item_class_set_thread_safe (AccountItemClass *klass,
+                                         gboolean thread_safe);
+gboolean account_item_class_get_thread_safe (AccountItemClass *klass);
+
+void account_item_update (AccountItem *account,
+                          const gchar *first_property_name,
+                          ...) G_GNUC_NULL_TERMINATED;
+
 AccountPlugin *account_item_get_plugin (AccountItem *account);
 AccountService *account_item_get_service (AccountItem *account);
 gboolean account_item_is_connected (AccountItem *account) G_GNUC_DEPRECATED;
 
+const gchar *account_item_get_name (AccountItem *account);
+void account_item_set_name (AccountItem *account, const gchar *name);
+const gchar *account_item_get_display_name (AccountItem *account);
+void account_item_set_display_name (AccountItem *account,
+                                    const gchar *display_name);
+GdkPixbuf *account_item_get_avatar (AccountItem *account);
+void account_item_set_avatar (AccountItem *account, GdkPixbuf *avatar);
+GdkPixbuf *account_item_get_avatar_at_size (AccountItem *account, gint size);
+void account_item_set_avatar_data (AccountItem *account, GBytes *data);
+AccountsImage *account_item_get_avatar_image (AccountItem *account);
+void account_item_set_avatar_image (AccountItem *account,
+                                    AccountsImage *image);
+gboolean account_item_get_supports_avatar (AccountItem *account);
+void account_item_set_supports_avatar (AccountItem *account,
+                                       gboolean supports_avatar);
+const gchar *account_item_get_service_name (AccountItem *account);
+GdkPixbuf *account_item_get_service_icon (AccountItem *account);
+gboolean account_item_get_enabled (AccountItem *account);
+gboolean account_item_get_draft (AccountItem *account);
+void account_item_set_draft (AccountItem *account, gboolean draft);
+gboolean account_item_get_connected (AccountItem *account);
+void account_item_set_connected (AccountItem *account, gboolean connected);
+
 G_END_DECLS
 
 #endif /* _ACCOUNT_ITEM_H_ */
@@ -29,18 +29,56 @@
  *
  * The account_plugin_manager_list() method can be used to retrieve the list of
  * the known #AccountPlugin objects.
+ *
+ * The manager also keeps a registry of the services of all plugins: use
+ * account_plugin_manager_get_services() to get them sorted by priority, as
+ * they are presented to the user, and account_plugin_manager_find_service()
+ * or account_plugin_manager_find_service_by_service_name() to look one up.
+ * The registry is updated when a plugin emits
+ * #AccountPlugin::services-changed, and #AccountPluginManager::services-changed
+ * is emitted after.
+ *
+ * The registry is saved in a service catalog in the user cache directory.
+ * A manager created with account_plugin_manager_new_on_demand() reads it
+ * instead of loading the plugins, as long as no plugin module was added,
+ * removed or modified since. The services it lists are then placeholders,
+ * and account_plugin_manager_load_service() loads the plugin of one of them
+ * when it is actually needed, for example when the user picks it to create
+ * a new account. As plugins report their accounts only once loaded, this is
+ * meant for processes which only need the list of services.
  */
 
 #include "config.h"
 
+#include <glib/gstdio.h>
+
+#include <string.h>
+
 #include "account-plugin-manager.h"
 
+#define CATALOG_VERSION 1
+#define CATALOG_GROUP "Catalog"
+#define MODULE_GROUP_PREFIX "Module "
+#define SERVICE_GROUP_PREFIX "Service "
+
 struct _AccountPluginManagerPrivate
 {
   GList *plugin_paths;
   AccountsList *accounts_list;
   GList *plugins;
   guint pending_count;
+  /* AccountPlugin -> GList of its AccountService, referenced */
+  GHashTable *plugin_services;
+  GHashTable *services_by_name;
+  GHashTable *services_by_service_name;
+  /* all services sorted by priority, NULL until needed */
+  GPtrArray *services;
+  /* AccountPlugin -> path of the module it comes from */
+  GHashTable *plugin_files;
+  /* module path -> GList of placeholder AccountService from the catalog,
+   * until the module is loaded */
+  GHashTable *catalog;
+  gboolean load_on_demand;
 };
 
 typedef struct _AccountPluginManagerPrivate AccountPluginManagerPrivate;
@@ -60,9 +98,499 @@ enum
 {
   PROP_PLUGIN_PATHS = 1,
   PROP_ACCOUNTS_LIST,
-  PROP_PLUGINS_INITIALIZED
+  PROP_PLUGINS_INITIALIZED,
+  PROP_LOAD_ON_DEMAND
 };
 
+enum
+{
+  SERVICES_CHANGED,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+static void save_catalog(AccountPluginManagerPrivate *priv);
+
+static gint
+compare_services(gconstpointer a, gconstpointer b)
+{
+  AccountService *service_a = *(AccountService **)a;
+  AccountService *service_b = *(AccountService **)b;
+  gint res;
+
+  if (service_a->priority != service_b->priority)
+    return service_a->priority < service_b->priority ? -1 : 1;
+
+  res = g_utf8_collate(service_a->display_name ? service_a->display_name : "",
+                       service_b->display_name ? service_b->display_name : "");
+
+  if (res)
+    return res;
+
+  return g_strcmp0(service_a->name, service_b->name);
+}
+
+/* the first service in priority order wins a key */
+static void
+index_service(GHashTable *index, const gchar *key, AccountService *service)
+{
+  AccountService *old;
+
+  if (!key)
+    return;
+
+  old = g_hash_table_lookup(index, key);
+
+  if (!old || compare_services(&service, &old) < 0)
+    g_hash_table_insert(index, g_strdup(key), service);
+}
+
+/* calls @func on the services of loaded plugins and the catalog */
+static void
+foreach_service(AccountPluginManagerPrivate *priv, GFunc func,
+                gpointer user_data)
+{
+  GHashTable *tables[] = { priv->plugin_services, priv->catalog };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS(tables); i++)
+  {
+    GHashTableIter iter;
+    gpointer services;
+
+    g_hash_table_iter_init(&iter, tables[i]);
+
+    while (g_hash_table_iter_next(&iter, NULL, &services))
+      g_list_foreach(services, func, user_data);
+  }
+}
+
+static void
+reindex_service(AccountService *service, AccountPluginManagerPrivate *priv)
+{
+  index_service(priv->services_by_name, service->name, service);
+  index_service(priv->services_by_service_name, service->service_name,
+                service);
+}
+
+static void
+rebuild_indexes(AccountPluginManagerPrivate *priv)
+{
+  g_hash_table_remove_all(priv->services_by_name);
+  g_hash_table_remove_all(priv->services_by_service_name);
+  foreach_service(priv, (GFunc)reindex_service, priv);
+}
+
+static void
+invalidate_services(AccountPluginManagerPrivate *priv)
+{
+  if (priv->services)
+  {
+    g_ptr_array_unref(priv->services);
+    priv->services = NULL;
+  }
+}
+
+static void
+on_service_notify(AccountService *service, GParamSpec *pspec,
+                  AccountPluginManager *manager)
+{
+  AccountPluginManagerPrivate *priv = PRIVATE(manager);
+
+  /* renames and priority changes are rare, the registry is small */
+  rebuild_indexes(priv);
+  invalidate_services(priv);
+  save_catalog(priv);
+  g_signal_emit(manager, signals[SERVICES_CHANGED], 0);
+}
+
+static void
+registry_remove_plugin(AccountPluginManager *manager, AccountPlugin *plugin)
+{
+  AccountPluginManagerPrivate *priv = PRIVATE(manager);
+  GList *services = g_hash_table_lookup(priv->plugin_services, plugin);
+  GList *l;
+
+  if (!services)
+    return;
+
+  for (l = services; l; l = l->next)
+  {
+    AccountService *service = l->data;
+
+    g_signal_handlers_disconnect_by_func(service, on_service_notify, manager);
+
+    if (service->name &&
+        g_hash_table_lookup(priv->services_by_name, service->name) == service)
+    {
+      g_hash_table_remove(priv->services_by_name, service->name);
+    }
+
+    if (service->service_name &&
+        g_hash_table_lookup(priv->services_by_service_name,
+                            service->service_name) == service)
+    {
+      g_hash_table_remove(priv->services_by_service_name,
+                          service->service_name);
+    }
+  }
+
+  g_hash_table_remove(priv->plugin_services, plugin);
+  invalidate_services(priv);
+}
+
+static void
+registry_add_plugin(AccountPluginManager *manager, AccountPlugin *plugin)
+{
+  AccountPluginManagerPrivate *priv = PRIVATE(manager);
+  GList *services = account_plugin_list_services(plugin);
+  GList *l;
+
+  for (l = services; l; l = l->next)
+  {
+    AccountService *service = g_object_ref(l->data);
+
+    index_service(priv->services_by_name, service->name, service);
+    index_service(priv->services_by_service_name, service->service_name,
+                  service);
+    g_signal_connect(service, "notify::name",
+                     G_CALLBACK(on_service_notify), manager);
+    g_signal_connect(service, "notify::display-name",
+                     G_CALLBACK(on_service_notify), manager);
+    g_signal_connect(service, "notify::service-name",
+                     G_CALLBACK(on_service_notify), manager);
+    g_signal_connect(service, "notify::priority",
+                     G_CALLBACK(on_service_notify), manager);
+  }
+
+  if (services)
+    g_hash_table_insert(priv->plugin_services, plugin, services);
+
+  invalidate_services(priv);
+}
+
+static void
+registry_reload_plugin(AccountPluginManager *manager, AccountPlugin *plugin)
+{
+  registry_remove_plugin(manager, plugin);
+  registry_add_plugin(manager, plugin);
+
+  /* removed services might have hidden others with the same key */
+  rebuild_indexes(PRIVATE(manager));
+}
+
+static void
+on_plugin_services_changed(AccountPlugin *plugin,
+                           AccountPluginManager *manager)
+{
+  registry_reload_plugin(manager, plugin);
+  save_catalog(PRIVATE(manager));
+  g_signal_emit(manager, signals[SERVICES_CHANGED], 0);
+}
+
+static void
+free_services(GList *services)
+{
+  g_list_free_full(services, g_object_unref);
+}
+
+static gchar *
+catalog_path(void)
+{
+  return g_build_filename(g_get_user_cache_dir(), "libaccounts",
+                          "services.catalog", NULL);
+}
+
+/* the plugin modules in the plugin paths */
+static GList *
+list_modules(AccountPluginManagerPrivate *priv)
+{
+  GList *modules = NULL;
+  GList *l;
+
+  for (l = priv->plugin_paths; l; l = l->next)
+  {
+    GDir *dir = g_dir_open(l->data, 0, NULL);
+
+    if (dir)
+    {
+      const gchar *name;
+
+      while ((name = g_dir_read_name(dir)))
+      {
+        if (g_str_has_suffix(name, ".so"))
+          modules = g_list_prepend(modules, g_build_filename(l->data, name,
+                                                             NULL));
+      }
+
+      g_dir_close(dir);
+    }
+  }
+
+  return g_list_reverse(modules);
+}
+
+static gint64
+module_mtime(const gchar *path)
+{
+  GStatBuf buf;
+
+  if (g_stat(path, &buf))
+    return -1;
+
+  return buf.st_mtime;
+}
+
+static void
+add_catalog_service(GKeyFile *key_file, guint *n_services,
+                    AccountService *service, const gchar *module)
+{
+  gchar *group = g_strdup_printf(SERVICE_GROUP_PREFIX "%u", (*n_services)++);
+  const gchar *icon_name = account_service_get_icon_name(service);
+
+  g_key_file_set_string(key_file, group, "Module", module);
+  g_key_file_set_string(key_file, group, "Name",
+                        service->name ? service->name : "");
+
+  if (service->display_name)
+  {
+    g_key_file_set_string(key_file, group, "DisplayName",
+                          service->display_name);
+  }
+
+  if (service->service_name)
+  {
+    g_key_file_set_string(key_file, group, "ServiceName",
+                          service->service_name);
+  }
+
+  g_key_file_set_integer(key_file, group, "Priority", service->priority);
+  g_key_file_set_boolean(key_file, group, "SupportsAvatar",
+                         service->supports_avatar);
+
+  /* icons only given as pixbufs can't be saved */
+  if (icon_name)
+    g_key_file_set_string(key_file, group, "Icon", icon_name);
+
+  g_free(group);
+}
+
+static void
+add_catalog_module(GKeyFile *key_file, const gchar *module)
+{
+  gchar *group = g_strconcat(MODULE_GROUP_PREFIX, module, NULL);
+
+  g_key_file_set_int64(key_file, group, "MTime", module_mtime(module));
+  g_free(group);
+}
+
+/* plugins still initializing might not list all their services yet, the
+ * catalog is saved again once they are done */
+static void
+save_catalog(AccountPluginManagerPrivate *priv)
+{
+  GKeyFile *key_file;
+  GList *modules;
+  guint n_services = 0;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  GList *l;
+  gchar *path;
+  gchar *dir;
+  gchar *data;
+  gchar *old_data = NULL;
+  gsize length;
+
+  if (priv->pending_count)
+    return;
+
+  key_file = g_key_file_new();
+  modules = list_modules(priv);
+  g_key_file_set_integer(key_file, CATALOG_GROUP, "Version", CATALOG_VERSION);
+
+  /* including those which failed to load, not to retry them every time */
+  for (l = modules; l; l = l->next)
+    add_catalog_module(key_file, l->data);
+
+  g_list_free_full(modules, g_free);
+  g_hash_table_iter_init(&iter, priv->plugin_files);
+
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    for (l = g_hash_table_lookup(priv->plugin_services, key); l; l = l->next)
+      add_catalog_service(key_file, &n_services, l->data, value);
+  }
+
+  g_hash_table_iter_init(&iter, priv->catalog);
+
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    for (l = value; l; l = l->next)
+      add_catalog_service(key_file, &n_services, l->data, key);
+  }
+
+  data = g_key_file_to_data(key_file, &length, NULL);
+  g_key_file_free(key_file);
+
+  path = catalog_path();
+  dir = g_path_get_dirname(path);
+
+  /* don't wear out flash for nothing */
+  if ((!g_file_get_contents(path, &old_data, NULL, NULL) ||
+       strcmp(old_data, data)) && !g_mkdir_with_parents(dir, 0700))
+  {
+    GError *error = NULL;
+
+    if (!g_file_set_contents(path, data, length, &error))
+    {
+      g_warning("%s: cannot save service catalog: %s", __FUNCTION__,
+                error->message);
+      g_error_free(error);
+    }
+  }
+
+  g_free(old_data);
+  g_free(data);
+  g_free(dir);
+  g_free(path);
+}
+
+/* whether the catalog describes exactly the modules in the plugin paths */
+static gboolean
+catalog_is_current(AccountPluginManagerPrivate *priv, GKeyFile *key_file)
+{
+  GList *modules = list_modules(priv);
+  gchar **groups = g_key_file_get_groups(key_file, NULL);
+  gboolean current = TRUE;
+  guint n_modules = 0;
+  GList *l;
+  gchar **group;
+
+  if (g_key_file_get_integer(key_file, CATALOG_GROUP, "Version", NULL) !=
+      CATALOG_VERSION)
+  {
+    current = FALSE;
+  }
+
+  for (group = groups; *group && current; group++)
+  {
+    if (g_str_has_prefix(*group, MODULE_GROUP_PREFIX))
+      n_modules++;
+  }
+
+  if (n_modules != g_list_length(modules))
+    current = FALSE;
+
+  for (l = modules; l && current; l = l->next)
+  {
+    gchar *group = g_strconcat(MODULE_GROUP_PREFIX, l->data, NULL);
+    GError *error = NULL;
+    gint64 mtime = g_key_file_get_int64(key_file, group, "MTime", &error);
+
+    if (error)
+    {
+      g_error_free(error);
+      current = FALSE;
+    }
+    else if (mtime != module_mtime(l->data))
+      current = FALSE;
+
+    g_free(group);
+  }
+
+  g_strfreev(groups);
+  g_list_free_full(modules, g_free);
+
+  return current;
+}
+
+static AccountService *
+create_catalog_service(GKeyFile *key_file, const gchar *group)
+{
+  gchar *name = g_key_file_get_string(key_file, group, "Name", NULL);
+  gchar *display_name = g_key_file_get_string(key_file, group, "DisplayName",
+                                              NULL);
+  gchar *service_name = g_key_file_get_string(key_file, group, "ServiceName",
+                                              NULL);
+  gchar *icon_name = g_key_file_get_string(key_file, group, "Icon", NULL);
+  AccountService *service;
+
+  service = g_object_new(
+      ACCOUNT_TYPE_SERVICE,
+      "name", name,
+      "display-name", display_name,
+      "service-name", service_name,
+      "supports-avatar",
+      g_key_file_get_boolean(key_file, group, "SupportsAvatar", NULL),
+      "icon-name", icon_name,
+      NULL);
+  service->priority = g_key_file_get_integer(key_file, group, "Priority",
+                                             NULL);
+
+  g_free(name);
+  g_free(display_name);
+  g_free(service_name);
+  g_free(icon_name);
+
+  return service;
+}
+
+static gboolean
+load_catalog(AccountPluginManagerPrivate *priv)
+{
+  GKeyFile *key_file = g_key_file_new();
+  gchar *path = catalog_path();
+  gboolean loaded = FALSE;
+
+  if (g_key_file_load_from_file(key_file, path, G_KEY_FILE_NONE, NULL) &&
+      catalog_is_current(priv, key_file))
+  {
+    gchar **groups = g_key_file_get_groups(key_file, NULL);
+    gchar **group;
+
+    for (group = groups; *group; group++)
+    {
+      if (g_str_has_prefix(*group, MODULE_GROUP_PREFIX))
+      {
+        const gchar *module = *group + strlen(MODULE_GROUP_PREFIX);
+
+        /* modules without services still need to be known */
+        if (!g_hash_table_contains(priv->catalog, module))
+          g_hash_table_insert(priv->catalog, g_strdup(module), NULL);
+      }
+      else if (g_str_has_prefix(*group, SERVICE_GROUP_PREFIX))
+      {
+        gchar *module = g_key_file_get_string(key_file, *group, "Module",
+                                              NULL);
+
+        if (module)
+        {
+          gpointer old_module = NULL;
+          gpointer services = NULL;
+
+          g_hash_table_steal_extended(priv->catalog, module, &old_module,
+                                      &services);
+          g_free(old_module);
+          services = g_list_append(services,
+                                   create_catalog_service(key_file, *group));
+          g_hash_table_insert(priv->catalog, module, services);
+        }
+      }
+    }
+
+    g_strfreev(groups);
+    rebuild_indexes(priv);
+    loaded = TRUE;
+  }
+
+  g_free(path);
+  g_key_file_free(key_file);
+
+  return loaded;
+}
+
 static void
 on_plugin_initialized(AccountPlugin *plugin,
                       GParamSpec *pspec,
@@ -77,12 +605,20 @@ on_plugin_initialized(AccountPlugin *plugin,
 
   if (initialized)
   {
-    if (priv->pending_count-- == 1)
-      g_object_notify(G_OBJECT(manager), "plugins-initialized");
-
     g_signal_handlers_disconnect_matched(
       plugin, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
       on_plugin_initialized, manager);
+
+    /* services might only be known once the plugin is initialized */
+    registry_reload_plugin(manager, plugin);
+
+    if (priv->pending_count-- == 1)
+    {
+      save_catalog(priv);
+      g_object_notify(G_OBJECT(manager), "plugins-initialized");
+    }
+
+    g_signal_emit(manager, signals[SERVICES_CHANGED], 0);
   }
 }
 
@@ -103,6 +639,9 @@ account_plugin_manager_dispose(GObject *object)
     g_signal_handlers_disconnect_matched(
       l->data, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
       on_plugin_initialized, object);
+    g_signal_handlers_disconnect_by_func(l->data, on_plugin_services_changed,
+                                         object);
+    registry_remove_plugin(ACCOUNT_PLUGIN_MANAGER(object), l->data);
     g_object_unref(l->data);
   }
 
@@ -115,44 +654,70 @@ account_plugin_manager_dispose(GObject *object)
   G_OBJECT_CLASS(account_plugin_manager_parent_class)->dispose(object);
 }
 
+static GList *
+load_module(AccountPluginManagerPrivate *priv, const gchar *path)
+{
+  AccountPluginLoader *loader = account_plugin_loader_new(path);
+  GList *plugins = NULL;
+  GList *l;
+
+  if (g_type_module_use(G_TYPE_MODULE(loader)))
+    plugins = account_plugin_loader_get_objects(loader);
+  else
+    g_warning("%s: could not load plugin %s", __FUNCTION__, path);
+
+  for (l = plugins; l; l = l->next)
+    g_hash_table_insert(priv->plugin_files, l->data, g_strdup(path));
+
+  return plugins;
+}
+
 static GList *
 list_plugins(AccountPluginManagerPrivate *priv)
 {
+  GList *modules = list_modules(priv);
   GList *l;
   GList *plugins = 0;
 
-  for (l = priv->plugin_paths; l; l = l->next)
+  for (l = modules; l; l = l->next)
+    plugins = g_list_concat(plugins, load_module(priv, l->data));
+
+  g_list_free_full(modules, g_free);
+
+  return plugins;
+}
+
+static void
+setup_plugins(AccountPluginManager *manager, GList *plugins)
+{
+  AccountPluginManagerPrivate *priv = PRIVATE(manager);
+  GList *l;
+
+  for (l = plugins; l; l = l->next)
   {
-    GDir *dir = g_dir_open(l->data, 0, NULL);
+    gboolean initialized = FALSE;
 
-    if (dir)
+    if (!account_plugin_setup(l->data, priv->accounts_list))
     {
-      const gchar *name;
+      g_warning( "%s: Initialization of plugin %s failed", __FUNCTION__,
+                 g_type_name(G_TYPE_FROM_INSTANCE(l->data)));
+    }
 
-      while ((name = g_dir_read_name(dir)))
-      {
-        if (g_str_has_suffix(name, ".so"))
-        {
-          gchar *path = g_build_filename(l->data, name, NULL);
-          AccountPluginLoader *loader = account_plugin_loader_new(path);
-
-          g_free(path);
-
-          if (g_type_module_use(G_TYPE_MODULE(loader)))
-          {
-            plugins = g_list_concat(plugins,
-                                    account_plugin_loader_get_objects(loader));
-          }
-          else
-            g_warning("%s: could not load plugin %s", __FUNCTION__, name);
-        }
-      }
+    registry_add_plugin(manager, l->data);
+    g_signal_connect(l->data, "services-changed",
+                     G_CALLBACK(on_plugin_services_changed), manager);
 
-      g_dir_close(dir);
+    g_object_get(l->data, "initialized", &initialized, NULL);
+
+    if (!initialized)
+    {
+      priv->pending_count++;
+      g_signal_connect(l->data, "notify::initialized",
+                       G_CALLBACK(on_plugin_initialized), manager);
     }
   }
 
-  return plugins;
+  priv->plugins = g_list_concat(priv->plugins, g_list_copy(plugins));
 }
 
 static GObject *
@@ -160,7 +725,6 @@ account_plugin_manager_constructor(GType type, guint n_construct_properties,
                                    GObjectConstructParam *construct_properties)
 {
   AccountPluginManagerPrivate *priv;
-  GList *l;
   GObject *object;
 
   object = G_OBJECT_CLASS(account_plugin_manager_parent_class)->constructor(
@@ -171,26 +735,14 @@ account_plugin_manager_constructor(GType type, guint n_construct_properties,
   if (!priv->accounts_list)
     return NULL;
 
-  priv->plugins = list_plugins(priv);
-
-  for (l = priv->plugins; l; l = l->next)
+  /* plugins are loaded by account_plugin_manager_load_service() then */
+  if (!priv->load_on_demand || !load_catalog(priv))
   {
-    gboolean initialized = FALSE;
-
-    if (!account_plugin_setup(l->data, priv->accounts_list))
-    {
-      g_warning( "%s: Initialization of plugin %s failed", __FUNCTION__,
-                 g_type_name(G_TYPE_FROM_INSTANCE(l->data)));
-    }
-
-    g_object_get(l->data, "initialized", &initialized, NULL);
+    GList *plugins = list_plugins(priv);
 
-    if (!initialized)
-    {
-      priv->pending_count++;
-      g_signal_connect(l->data, "notify::initialized",
-                       G_CALLBACK(on_plugin_initialized), object);
-    }
+    setup_plugins(ACCOUNT_PLUGIN_MANAGER(object), plugins);
+    g_list_free(plugins);
+    save_catalog(priv);
   }
 
   if (!priv->pending_count)
@@ -205,6 +757,12 @@ account_plugin_manager_finalize(GObject *object)
   AccountPluginManagerPrivate *priv = PRIVATE(object);
 
   g_list_free_full(priv->plugin_paths, g_free);
+  g_hash_table_destroy(priv->plugin_services);
+  g_hash_table_destroy(priv->services_by_name);
+  g_hash_table_destroy(priv->services_by_service_name);
+  g_hash_table_destroy(priv->plugin_files);
+  g_hash_table_destroy(priv->catalog);
+  invalidate_services(priv);
   G_OBJECT_CLASS(account_plugin_manager_parent_class)->finalize(object);
 }
 
@@ -236,6 +794,11 @@ account_plugin_manager_set_property(GObject *object, guint property_id,
       priv->accounts_list = g_value_dup_object(value);
       break;
     }
+    case PROP_LOAD_ON_DEMAND:
+    {
+      priv->load_on_demand = g_value_get_boolean(value);
+      break;
+    }
     default:
     {
       G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
@@ -271,6 +834,11 @@ account_plugin_manager_get_property(GObject *object, guint property_id,
       g_value_set_pointer(value, priv->plugin_paths);
       break;
     }
+    case PROP_LOAD_ON_DEMAND:
+    {
+      g_value_set_boolean(value, priv->load_on_demand);
+      break;
+    }
     default:
     {
       G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
@@ -313,11 +881,43 @@ account_plugin_manager_class_init(AccountPluginManagerClass *klass)
       "Whether plugins have been initialized",
       FALSE,
       G_PARAM_READABLE));
+  g_object_class_install_property(
+    object_class, PROP_LOAD_ON_DEMAND,
+    g_param_spec_boolean(
+      "load-on-demand",
+      "Load on demand",
+      "Whether plugins are only loaded when one of their services is needed",
+      FALSE,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+
+  /**
+   * AccountPluginManager::services-changed:
+   * @plugin_manager: the #AccountPluginManager.
+   *
+   * Emitted when services were added, removed or renamed, after the service
+   * registry was updated. Arrays returned by
+   * account_plugin_manager_get_services() before are no longer current.
+   */
+  signals[SERVICES_CHANGED] = g_signal_new(
+      "services-changed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 }
 
 static void
 account_plugin_manager_init(AccountPluginManager *manager)
-{}
+{
+  AccountPluginManagerPrivate *priv = PRIVATE(manager);
+
+  priv->plugin_services = g_hash_table_new_full(
+      NULL, NULL, NULL, (GDestroyNotify)free_services);
+  priv->services_by_name = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                 g_free, NULL);
+  priv->services_by_service_name = g_hash_table_new_full(
+      g_str_hash, g_str_equal, g_free, NULL);
+  priv->plugin_files = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+  priv->catalog = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                        (GDestroyNotify)free_services);
+}
 
 /**
  * account_plugin_manager_list:
@@ -357,3 +957,209 @@ account_plugin_manager_new(GList *plugin_paths, AccountsList *accounts_list)
                       "accounts-list", accounts_list,
                       NULL);
 }
+
+/**
+ * account_plugin_manager_new_on_demand:
+ * @plugin_paths: #GList of plugin paths.
+ * @accounts_list: the #AccountsList.
+ *
+ * Like account_plugin_manager_new(), but takes the services from the service
+ * catalog if it is current, instead of loading the plugins. Plugins are then
+ * loaded by account_plugin_manager_load_service().
+ *
+ * Returns:(transfer full): an #AccountPluginManager.
+ */
+AccountPluginManager *
+account_plugin_manager_new_on_demand(GList *plugin_paths,
+                                     AccountsList *accounts_list)
+{
+  g_return_val_if_fail(plugin_paths != NULL, NULL);
+  g_return_val_if_fail(accounts_list != NULL, NULL);
+
+  return g_object_new(ACCOUNT_TYPE_PLUGIN_MANAGER,
+                      "plugin-paths", plugin_paths,
+                      "accounts-list", accounts_list,
+                      "load-on-demand", TRUE,
+                      NULL);
+}
+
+static void
+add_service(AccountService *service, GPtrArray *services)
+{
+  g_ptr_array_add(services, g_object_ref(service));
+}
+
+/**
+ * account_plugin_manager_get_services:
+ * @plugin_manager: the #AccountPluginManager.
+ *
+ * Gets the services of all plugins, sorted by ascending priority, then by
+ * display name. Services of plugins which are not loaded yet are
+ * placeholders taken from the service catalog, see
+ * account_plugin_manager_load_service(). The array is built on the first call
+ * after the services changed and shared by all callers until the next change,
+ * so it must not be modified; take a reference to keep it past
+ * #AccountPluginManager::services-changed.
+ *
+ * Returns:(transfer none)(element-type AccountService): a #GPtrArray of
+ * #AccountService objects.
+ */
+GPtrArray *
+account_plugin_manager_get_services(AccountPluginManager *plugin_manager)
+{
+  AccountPluginManagerPrivate *priv;
+
+  g_return_val_if_fail(ACCOUNT_IS_PLUGIN_MANAGER(plugin_manager), NULL);
+
+  priv = PRIVATE(plugin_manager);
+
+  if (!priv->services)
+  {
+    priv->services = g_ptr_array_new_with_free_func(g_object_unref);
+    foreach_service(priv, (GFunc)add_service, priv->services);
+    g_ptr_array_sort(priv->services, compare_services);
+  }
+
+  return priv->services;
+}
+
+/**
+ * account_plugin_manager_find_service:
+ * @plugin_manager: the #AccountPluginManager.
+ * @name: the name of the service.
+ *
+ * Looks up a service by its #AccountService:name. If several plugins provide
+ * services with the same name, the first one in priority order is returned.
+ *
+ * Returns:(transfer none)(nullable): the #AccountService, or %NULL.
+ */
+AccountService *
+account_plugin_manager_find_service(AccountPluginManager *plugin_manager,
+                                    const gchar *name)
+{
+  g_return_val_if_fail(ACCOUNT_IS_PLUGIN_MANAGER(plugin_manager), NULL);
+  g_return_val_if_fail(name != NULL, NULL);
+
+  return g_hash_table_lookup(PRIVATE(plugin_manager)->services_by_name, name);
+}
+
+/**
+ * account_plugin_manager_find_service_by_service_name:
+ * @plugin_manager: the #AccountPluginManager.
+ * @service_name: the service name of the service.
+ *
+ * Looks up a service by its #AccountService:service-name, see
+ * account_plugin_manager_find_service().
+ *
+ * Returns:(transfer none)(nullable): the #AccountService, or %NULL.
+ */
+AccountService *
+account_plugin_manager_find_service_by_service_name(
+  AccountPluginManager *plugin_manager, const gchar *service_name)
+{
+  g_return_val_if_fail(ACCOUNT_IS_PLUGIN_MANAGER(plugin_manager), NULL);
+  g_return_val_if_fail(service_name != NULL, NULL);
+
+  return g_hash_table_lookup(PRIVATE(plugin_manager)->services_by_service_name,
+                             service_name);
+}
+
+static gchar *
+find_catalog_module(AccountPluginManagerPrivate *priv, AccountService *service)
+{
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+
+  g_hash_table_iter_init(&iter, priv->catalog);
+
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    if (g_list_find(value, service))
+      return g_strdup(key);
+  }
+
+  return NULL;
+}
+
+/**
+ * account_plugin_manager_load_service:
+ * @plugin_manager: the #AccountPluginManager.
+ * @service: an #AccountService from @plugin_manager.
+ *
+ * Makes sure the plugin of @service is loaded. If @service is a placeholder
+ * from the service catalog, its plugin module is loaded and set up, the
+ * placeholders of the module are replaced by the actual services in the
+ * registry, and #AccountPluginManager::services-changed is emitted.
+ *
+ * Placeholders are released once the registry is updated, so @service
+ * might be finalized by the time this returns unless the caller holds a
+ * reference to it.
+ *
+ * Returns:(transfer none)(nullable): the loaded service with the name of
+ * @service, which is @service itself if its plugin was already loaded, or
+ * %NULL if the plugin does not provide it any more.
+ */
+AccountService *
+account_plugin_manager_load_service(AccountPluginManager *plugin_manager,
+                                    AccountService *service)
+{
+  AccountPluginManagerPrivate *priv;
+  AccountService *loaded = NULL;
+  gpointer catalog_module = NULL;
+  gpointer placeholders = NULL;
+  GList *plugins;
+  GList *l;
+  gchar *module;
+  gchar *name;
+
+  g_return_val_if_fail(ACCOUNT_IS_PLUGIN_MANAGER(plugin_manager), NULL);
+  g_return_val_if_fail(ACCOUNT_IS_SERVICE(service), NULL);
+
+  if (service->plugin)
+    return service;
+
+  priv = PRIVATE(plugin_manager);
+  module = find_catalog_module(priv, service);
+
+  g_return_val_if_fail(module != NULL, NULL);
+
+  /* @service goes away with the placeholders, which stay alive until the
+   * registry does not reference them any more */
+  name = g_strdup(service->name);
+  g_hash_table_steal_extended(priv->catalog, module, &catalog_module,
+                              &placeholders);
+  g_free(catalog_module);
+  rebuild_indexes(priv);
+  invalidate_services(priv);
+
+  plugins = load_module(priv, module);
+  setup_plugins(plugin_manager, plugins);
+
+  for (l = plugins; l && !loaded; l = l->next)
+  {
+    GList *s = g_hash_table_lookup(priv->plugin_services, l->data);
+
+    for (; s && !loaded; s = s->next)
+    {
+      if (!g_strcmp0(ACCOUNT_SERVICE(s->data)->name, name))
+        loaded = s->data;
+    }
+  }
+
+  if (!loaded)
+  {
+    g_warning("%s: plugin %s does not provide service `%s' any more",
+              __FUNCTION__, module, name);
+  }
+
+  save_catalog(priv);
+  g_signal_emit(plugin_manager, signals[SERVICES_CHANGED], 0);
+
+  free_services(placeholders);
+  g_list_free(plugins);
+  g_free(name);
+  g_free(module);
+
+  return loaded;
+}
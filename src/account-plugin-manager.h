@@ -49,6 +49,17 @@ GType account_plugin_manager_get_type (void) G_GNUC_CONST;
 GList *account_plugin_manager_list (AccountPluginManager *plugin_manager);
 AccountPluginManager* account_plugin_manager_new (GList *plugin_paths,
                                                   AccountsList *accounts_list);
+AccountPluginManager *account_plugin_manager_new_on_demand (
+    GList *plugin_paths, AccountsList *accounts_list);
+
+GPtrArray *account_plugin_manager_get_services (
+    AccountPluginManager *plugin_manager);
+AccountService *account_plugin_manager_find_service (
+    AccountPluginManager *plugin_manager, const gchar *name);
+AccountService *account_plugin_manager_find_service_by_service_name (
+    AccountPluginManager *plugin_manager, const gchar *service_name);
+AccountService *account_plugin_manager_load_service (
+    AccountPluginManager *plugin_manager, AccountService *service);
 
 G_END_DECLS
 
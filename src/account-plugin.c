@@ -40,6 +40,11 @@
  * implement all the virtual methods of the #AccountPluginClass.
  *
  * Plugins are created in the #AccountPluginManager.
+ *
+ * Plugins whose list of services changes after they were set up, for example
+ * when services are discovered at runtime, must call
+ * account_plugin_services_changed() so that the #AccountPluginManager updates
+ * its service registry.
  */
 
 #include "config.h"
@@ -69,6 +74,14 @@ enum
   PROP_INITIALIZED
 };
 
+enum
+{
+  SERVICES_CHANGED,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
 #define NOT_IMPLEMENTED(fun, parameters, code) \
   _account_plugin_ ## fun parameters \
   { \
@@ -218,6 +231,19 @@ account_plugin_class_init(AccountPluginClass *klass)
                          "Whether plugin has been initialized",
                          FALSE,
                          G_PARAM_READABLE));
+
+  /**
+   * AccountPlugin::services-changed:
+   * @plugin: the #AccountPlugin.
+   *
+   * Emitted by account_plugin_services_changed() when the list of services
+   * returned by account_plugin_list_services() changed.
+   */
+  /* no class closure, AccountPluginClass is subclassed by plugins built
+   * against older headers */
+  signals[SERVICES_CHANGED] = g_signal_new(
+      "services-changed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 }
 
 static void
@@ -337,3 +363,18 @@ account_plugin_list_services(AccountPlugin *plugin)
 
   return ACCOUNT_PLUGIN_GET_CLASS(plugin)->list_services(plugin);
 }
+
+/**
+ * account_plugin_services_changed:
+ * @plugin: the AccountPlugin.
+ *
+ * Emits the #AccountPlugin::services-changed signal. Plugins call this when
+ * the services they handle changed after they were set up.
+ */
+void
+account_plugin_services_changed(AccountPlugin *plugin)
+{
+  g_return_if_fail(ACCOUNT_IS_PLUGIN(plugin));
+
+  g_signal_emit(plugin, signals[SERVICES_CHANGED], 0);
+}
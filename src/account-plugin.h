@@ -96,6 +96,7 @@ const gchar *account_plugin_get_name (AccountPlugin *plugin);
 const gchar *account_plugin_get_display_name (AccountPlugin *plugin);
 
 GList *account_plugin_list_services (AccountPlugin *plugin);
+void account_plugin_services_changed (AccountPlugin *plugin);
 
 AccountEditContext *account_plugin_begin_new (AccountPlugin *plugin,
                                               AccountService *service);
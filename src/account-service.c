@@ -19,7 +19,11 @@
 
 #include "config.h"
 
+#include <gtk/gtk.h>
+
 #include "account-service.h"
+#include "accounts-image.h"
+#include "accounts-private.h"
 
 /**
  * SECTION:account-service
@@ -28,9 +32,39 @@
  * An #AccountService represents a service which accounts can access. Services
  * are created by #AccountPlugin objects and are means by which the same plugin
  * could provide support for different types of accounts.
+ *
+ * The icon of the service can be given as encoded image data with
+ * account_service_set_icon_data(), to have it decoded in a worker thread
+ * instead of at plugin initialization. Better yet, it can be given as an icon
+ * name or a path with #AccountService:icon-name, to have it decoded only when
+ * the #AccountService:icon property is read for the first time, which most
+ * of the time is never. Icons resolved that way go through the shared
+ * #AccountsImageCache, so services with the same icon share its pixbuf.
  */
 
-G_DEFINE_TYPE(
+/* the size icons are looked up at in the icon theme and decoded at */
+#define ICON_SIZE 48
+
+struct _AccountServicePrivate
+{
+  /* while the icon is decoded */
+  AccountsImage *icon_image;
+  GCancellable *icon_loading;
+  gchar *icon_name;
+  /* whether the icon was resolved from icon_name, even if that failed */
+  gboolean icon_resolved;
+  /* interned copies of name and display_name, shared by snapshot records */
+  gchar *name_ref;
+  gchar *display_name_ref;
+};
+
+typedef struct _AccountServicePrivate AccountServicePrivate;
+
+#define PRIVATE(service) \
+  ((AccountServicePrivate *) \
+   account_service_get_instance_private((AccountService *)(service)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
   AccountService,
   account_service,
   G_TYPE_OBJECT
@@ -43,14 +77,71 @@ enum
   PROP_SUPPORTS_AVATAR,
   PROP_ICON,
   PROP_PLUGIN,
-  PROP_SERVICE_NAME
+  PROP_SERVICE_NAME,
+  PROP_ICON_NAME,
+  PROP_PRIORITY,
+  N_PROPERTIES
 };
 
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+static void
+cancel_icon_loading(AccountServicePrivate *priv)
+{
+  if (priv->icon_loading)
+  {
+    g_cancellable_cancel(priv->icon_loading);
+    g_object_unref(priv->icon_loading);
+    priv->icon_loading = NULL;
+  }
+
+  if (priv->icon_image)
+  {
+    g_object_unref(priv->icon_image);
+    priv->icon_image = NULL;
+  }
+}
+
+static void
+icon_loaded_cb(GObject *source_object, GAsyncResult *result,
+               gpointer user_data)
+{
+  AccountService *service = user_data;
+  GError *error = NULL;
+  GdkPixbuf *icon;
+
+  icon = accounts_image_load_finish(ACCOUNTS_IMAGE(source_object), result,
+                                    &error);
+
+  /* unless the icon changed in the meantime */
+  if (ACCOUNTS_IMAGE(source_object) == PRIVATE(service)->icon_image)
+  {
+    if (icon)
+      account_service_set_icon(service, icon);
+    else
+    {
+      g_warning("Cannot load the icon of service `%s': %s", service->name,
+                error->message);
+      cancel_icon_loading(PRIVATE(service));
+    }
+  }
+
+  if (icon)
+    g_object_unref(icon);
+
+  if (error)
+    g_error_free(error);
+
+  g_object_unref(service);
+}
+
 static void
 account_service_dispose(GObject *object)
 {
   AccountService *service = ACCOUNT_SERVICE(object);
 
+  cancel_icon_loading(PRIVATE(service));
+
   if (service->plugin)
   {
     g_object_remove_weak_pointer(G_OBJECT(service->plugin),
@@ -75,6 +166,9 @@ account_service_finalize(GObject *object)
   g_free(service->name);
   g_free(service->display_name);
   g_free(service->service_name);
+  _accounts_ref_string_release(PRIVATE(service)->name_ref);
+  _accounts_ref_string_release(PRIVATE(service)->display_name_ref);
+  g_free(PRIVATE(service)->icon_name);
 
   G_OBJECT_CLASS(account_service_parent_class)->finalize(object);
 }
@@ -93,29 +187,23 @@ account_service_set_property(GObject *object, guint property_id,
   {
     case PROP_NAME:
     {
-      g_free(service->name);
-      service->name = g_value_dup_string(value);
+      account_service_set_name(service, g_value_get_string(value));
       break;
     }
     case PROP_DISPLAY_NAME:
     {
-      g_free(service->display_name);
-      service->display_name = g_value_dup_string(value);
+      account_service_set_display_name(service, g_value_get_string(value));
       break;
     }
     case PROP_SUPPORTS_AVATAR:
     {
-      service->supports_avatar = g_value_get_boolean(value);
+      account_service_set_supports_avatar(service,
+                                          g_value_get_boolean(value));
       break;
     }
     case PROP_ICON:
     {
-      service->icon = service->icon;
-
-      if (service->icon)
-        g_object_unref(service->icon);
-
-      service->icon = g_value_dup_object(value);
+      account_service_set_icon(service, g_value_get_object(value));
       break;
     }
     case PROP_PLUGIN:
@@ -130,8 +218,17 @@ account_service_set_property(GObject *object, guint property_id,
     }
     case PROP_SERVICE_NAME:
     {
-      g_free(service->service_name);
-      service->service_name = g_value_dup_string(value);
+      account_service_set_service_name(service, g_value_get_string(value));
+      break;
+    }
+    case PROP_ICON_NAME:
+    {
+      account_service_set_icon_name(service, g_value_get_string(value));
+      break;
+    }
+    case PROP_PRIORITY:
+    {
+      account_service_set_priority(service, g_value_get_int(value));
       break;
     }
     default:
@@ -171,7 +268,7 @@ account_service_get_property(GObject *object, guint property_id, GValue *value,
     }
     case PROP_ICON:
     {
-      g_value_set_object(value, service->icon);
+      g_value_set_object(value, account_service_get_icon(service));
       break;
     }
     case PROP_PLUGIN:
@@ -184,6 +281,16 @@ account_service_get_property(GObject *object, guint property_id, GValue *value,
       g_value_set_string(value, service->service_name);
       break;
     }
+    case PROP_ICON_NAME:
+    {
+      g_value_set_string(value, PRIVATE(service)->icon_name);
+      break;
+    }
+    case PROP_PRIORITY:
+    {
+      g_value_set_int(value, service->priority);
+      break;
+    }
     default:
     {
       G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
@@ -202,54 +309,79 @@ account_service_class_init(AccountServiceClass *klass)
   object_class->set_property = account_service_set_property;
   object_class->get_property = account_service_get_property;
 
-  g_object_class_install_property(
-    object_class, PROP_NAME,
+  properties[PROP_NAME] =
     g_param_spec_string(
       "name",
       "Name",
       "Account name",
       NULL,
-      G_PARAM_CONSTRUCT | G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_DISPLAY_NAME,
+      G_PARAM_CONSTRUCT | G_PARAM_WRITABLE | G_PARAM_READABLE |
+      G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_DISPLAY_NAME] =
     g_param_spec_string(
       "display-name",
       "Display name",
       "Display name",
       NULL,
-      G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_SUPPORTS_AVATAR,
+      G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_SUPPORTS_AVATAR] =
     g_param_spec_boolean(
       "supports-avatar",
       "Supports avatar",
       "Supports avatar",
       FALSE,
-      G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_ICON,
+      G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_ICON] =
     g_param_spec_object(
       "icon",
       "Icon",
       "Icon",
       GDK_TYPE_PIXBUF,
-      G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_PLUGIN,
+      G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+  properties[PROP_PLUGIN] =
     g_param_spec_object(
       "plugin",
       "Plugin",
       "Plugin",
       ACCOUNT_TYPE_PLUGIN,
-      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_READABLE));
-  g_object_class_install_property(
-    object_class, PROP_SERVICE_NAME,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_READABLE);
+  properties[PROP_SERVICE_NAME] =
     g_param_spec_string(
       "service-name",
       "Service name",
       "Service name",
       NULL,
-      G_PARAM_WRITABLE | G_PARAM_READABLE));
+      G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * AccountService:icon-name:
+   *
+   * The name of the icon of the service in the icon theme, or the absolute
+   * path of its file. The icon is only decoded when #AccountService:icon is
+   * read, unless it was set explicitly.
+   */
+  properties[PROP_ICON_NAME] =
+    g_param_spec_string(
+      "icon-name",
+      "Icon name",
+      "Icon name or path",
+      NULL,
+      G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * AccountService:priority:
+   *
+   * The priority of the service; services with a lower priority are listed
+   * first.
+   */
+  properties[PROP_PRIORITY] =
+    g_param_spec_int(
+      "priority",
+      "Priority",
+      "Priority",
+      G_MININT, G_MAXINT, 0,
+      G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+  g_object_class_install_properties(object_class, N_PROPERTIES, properties);
 }
 
 static void
@@ -335,3 +467,354 @@ account_service_get_priority (AccountService *service)
 
   return service->priority;
 }
+
+/**
+ * account_service_set_priority:
+ * @service: the #AccountService.
+ * @priority: the new priority.
+ *
+ * Sets the #AccountService:priority property, notifying it only if it
+ * changes.
+ */
+void
+account_service_set_priority(AccountService *service, gint priority)
+{
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  if (service->priority == priority)
+    return;
+
+  service->priority = priority;
+  g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_PRIORITY]);
+}
+
+/**
+ * account_service_set_name:
+ * @service: the #AccountService.
+ * @name: the new name.
+ *
+ * Sets the #AccountService:name property, notifying it only if it changes.
+ */
+void
+account_service_set_name(AccountService *service, const gchar *name)
+{
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  if (!g_strcmp0(service->name, name))
+    return;
+
+  g_free(service->name);
+  service->name = g_strdup(name);
+  g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_NAME]);
+}
+
+/**
+ * account_service_set_display_name:
+ * @service: the #AccountService.
+ * @display_name: the new display name.
+ *
+ * Sets the #AccountService:display-name property, notifying it only if it
+ * changes.
+ */
+void
+account_service_set_display_name(AccountService *service,
+                                 const gchar *display_name)
+{
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  if (!g_strcmp0(service->display_name, display_name))
+    return;
+
+  g_free(service->display_name);
+  service->display_name = g_strdup(display_name);
+  g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_DISPLAY_NAME]);
+}
+
+/**
+ * account_service_get_supports_avatar:
+ * @service: the #AccountService.
+ *
+ * Returns: the value of the #AccountService:supports-avatar property.
+ */
+gboolean
+account_service_get_supports_avatar(AccountService *service)
+{
+  g_return_val_if_fail(ACCOUNT_IS_SERVICE(service), FALSE);
+
+  return service->supports_avatar;
+}
+
+/**
+ * account_service_set_supports_avatar:
+ * @service: the #AccountService.
+ * @supports_avatar: whether the accounts of @service support avatars.
+ *
+ * Sets the #AccountService:supports-avatar property, notifying it only if it
+ * changes.
+ */
+void
+account_service_set_supports_avatar(AccountService *service,
+                                    gboolean supports_avatar)
+{
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  supports_avatar = !!supports_avatar;
+
+  if (service->supports_avatar == supports_avatar)
+    return;
+
+  service->supports_avatar = supports_avatar;
+  g_object_notify_by_pspec(G_OBJECT(service),
+                           properties[PROP_SUPPORTS_AVATAR]);
+}
+
+static GdkPixbuf *
+resolve_icon(const gchar *icon_name, GError **error)
+{
+  AccountsImage *image;
+  GdkPixbuf *icon;
+
+  if (g_path_is_absolute(icon_name))
+    image = accounts_image_new_from_file(icon_name);
+  else
+  {
+    GtkIconInfo *info = gtk_icon_theme_lookup_icon(
+        gtk_icon_theme_get_default(), icon_name, ICON_SIZE, 0);
+
+    if (!info)
+    {
+      g_set_error(error, GTK_ICON_THEME_ERROR, GTK_ICON_THEME_NOT_FOUND,
+                  "Icon `%s' not present in theme", icon_name);
+      return NULL;
+    }
+
+    image = accounts_image_new_from_file(gtk_icon_info_get_filename(info));
+    gtk_icon_info_free(info);
+  }
+
+  icon = accounts_image_load_at_size(image, ICON_SIZE, error);
+  g_object_unref(image);
+
+  return icon;
+}
+
+/**
+ * account_service_get_icon:
+ * @service: the #AccountService.
+ *
+ * Gets the icon of the service, decoding it from #AccountService:icon-name
+ * if this is the first time it is needed.
+ *
+ * Returns:(transfer none)(nullable): the value of the #AccountService:icon
+ * property.
+ */
+GdkPixbuf *
+account_service_get_icon(AccountService *service)
+{
+  AccountServicePrivate *priv;
+
+  g_return_val_if_fail(ACCOUNT_IS_SERVICE(service), NULL);
+
+  priv = PRIVATE(service);
+
+  if (!service->icon && priv->icon_name && !priv->icon_resolved)
+  {
+    GError *error = NULL;
+
+    /* the icon was there all along, as far as observers are concerned */
+    priv->icon_resolved = TRUE;
+    service->icon = resolve_icon(priv->icon_name, &error);
+
+    if (!service->icon)
+    {
+      g_warning("Cannot load icon `%s' of service `%s': %s", priv->icon_name,
+                service->name, error->message);
+      g_error_free(error);
+    }
+  }
+
+  return service->icon;
+}
+
+/**
+ * account_service_set_icon:
+ * @service: the #AccountService.
+ * @icon:(nullable): the new icon.
+ *
+ * Sets the #AccountService:icon property, notifying it only if it changes.
+ * This cancels the decoding of an icon given with
+ * account_service_set_icon_data(), and unsets #AccountService:icon-name.
+ */
+void
+account_service_set_icon(AccountService *service, GdkPixbuf *icon)
+{
+  AccountServicePrivate *priv;
+
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  priv = PRIVATE(service);
+  cancel_icon_loading(priv);
+
+  if (priv->icon_name)
+  {
+    g_free(priv->icon_name);
+    priv->icon_name = NULL;
+    priv->icon_resolved = FALSE;
+    g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_ICON_NAME]);
+  }
+
+  if (service->icon == icon)
+    return;
+
+  if (icon)
+    g_object_ref(icon);
+
+  if (service->icon)
+    g_object_unref(service->icon);
+
+  service->icon = icon;
+  g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_ICON]);
+}
+
+/**
+ * account_service_set_icon_data:
+ * @service: the #AccountService.
+ * @data: the encoded icon, in any format supported by #GdkPixbufLoader.
+ *
+ * Starts decoding @data in a worker thread, and sets the
+ * #AccountService:icon property when done. The current icon, if any, is kept
+ * until then.
+ */
+void
+account_service_set_icon_data(AccountService *service, GBytes *data)
+{
+  AccountServicePrivate *priv;
+
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+  g_return_if_fail(data != NULL);
+
+  priv = PRIVATE(service);
+  cancel_icon_loading(priv);
+
+  priv->icon_image = accounts_image_new_from_bytes(data);
+  priv->icon_loading = g_cancellable_new();
+  accounts_image_load_async(priv->icon_image, 0, priv->icon_loading,
+                            icon_loaded_cb, g_object_ref(service));
+}
+
+/**
+ * account_service_get_icon_name:
+ * @service: the #AccountService.
+ *
+ * Returns:(nullable): the value of the #AccountService:icon-name property.
+ */
+const gchar *
+account_service_get_icon_name(AccountService *service)
+{
+  g_return_val_if_fail(ACCOUNT_IS_SERVICE(service), NULL);
+
+  return PRIVATE(service)->icon_name;
+}
+
+/**
+ * account_service_set_icon_name:
+ * @service: the #AccountService.
+ * @icon_name:(nullable): an icon name in the icon theme, or the absolute path
+ * of an image file.
+ *
+ * Sets the #AccountService:icon-name property. The current icon is dropped,
+ * and the new one is only decoded when the #AccountService:icon property is
+ * read. Both properties are notified if @icon_name changes.
+ */
+void
+account_service_set_icon_name(AccountService *service, const gchar *icon_name)
+{
+  AccountServicePrivate *priv;
+
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  priv = PRIVATE(service);
+
+  if (!g_strcmp0(priv->icon_name, icon_name))
+    return;
+
+  cancel_icon_loading(priv);
+  g_free(priv->icon_name);
+  priv->icon_name = g_strdup(icon_name);
+  priv->icon_resolved = FALSE;
+
+  if (service->icon)
+  {
+    g_object_unref(service->icon);
+    service->icon = NULL;
+  }
+
+  g_object_freeze_notify(G_OBJECT(service));
+  g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_ICON_NAME]);
+  g_object_notify_by_pspec(G_OBJECT(service), properties[PROP_ICON]);
+  g_object_thaw_notify(G_OBJECT(service));
+}
+
+/**
+ * account_service_get_service_name:
+ * @service: the #AccountService.
+ *
+ * Returns:(transfer none): the value of the #AccountService:service-name
+ * property.
+ */
+const gchar *
+account_service_get_service_name(AccountService *service)
+{
+  g_return_val_if_fail(ACCOUNT_IS_SERVICE(service), NULL);
+
+  return service->service_name;
+}
+
+/**
+ * account_service_set_service_name:
+ * @service: the #AccountService.
+ * @service_name: the new service name.
+ *
+ * Sets the #AccountService:service-name property, notifying it only if it
+ * changes.
+ */
+void
+account_service_set_service_name(AccountService *service,
+                                 const gchar *service_name)
+{
+  g_return_if_fail(ACCOUNT_IS_SERVICE(service));
+
+  if (!g_strcmp0(service->service_name, service_name))
+    return;
+
+  g_free(service->service_name);
+  service->service_name = g_strdup(service_name);
+  g_object_notify_by_pspec(G_OBJECT(service),
+                           properties[PROP_SERVICE_NAME]);
+}
+
+/* the public fields may be written by plugins, so check they still match */
+static gchar *
+dup_ref(gchar **ref, const gchar *value)
+{
+  if (g_strcmp0(*ref, value))
+  {
+    _accounts_ref_string_release(*ref);
+    *ref = _accounts_ref_string_intern(value);
+  }
+
+  return _accounts_ref_string_acquire(*ref);
+}
+
+gchar *
+_account_service_dup_name_ref(AccountService *service)
+{
+  return dup_ref(&PRIVATE(service)->name_ref, service->name);
+}
+
+gchar *
+_account_service_dup_display_name_ref(AccountService *service)
+{
+  return dup_ref(&PRIVATE(service)->display_name_ref,
+                 service->display_name);
+}
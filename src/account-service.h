@@ -64,6 +64,23 @@ AccountPlugin *account_service_get_plugin (AccountService *service);
 const gchar *account_service_get_name (AccountService *service);
 const gchar *account_service_get_display_name (AccountService *service);
 gint account_service_get_priority (AccountService *service);
+void account_service_set_priority (AccountService *service, gint priority);
+
+void account_service_set_name (AccountService *service, const gchar *name);
+void account_service_set_display_name (AccountService *service,
+                                       const gchar *display_name);
+gboolean account_service_get_supports_avatar (AccountService *service);
+void account_service_set_supports_avatar (AccountService *service,
+                                          gboolean supports_avatar);
+GdkPixbuf *account_service_get_icon (AccountService *service);
+void account_service_set_icon (AccountService *service, GdkPixbuf *icon);
+void account_service_set_icon_data (AccountService *service, GBytes *data);
+const gchar *account_service_get_icon_name (AccountService *service);
+void account_service_set_icon_name (AccountService *service,
+                                    const gchar *icon_name);
+const gchar *account_service_get_service_name (AccountService *service);
+void account_service_set_service_name (AccountService *service,
+                                       const gchar *service_name);
 
 G_END_DECLS
 
@@ -55,6 +55,7 @@
 #include "account-wizard-context.h"
 
 #include "account-marshal.h"
+#include "accounts-private.h"
 
 typedef AccountWizardContextIface AccountWizardContextInterface;
 
@@ -311,6 +312,9 @@ account_wizard_context_finish(AccountWizardContext *context, GError **error)
 
   iface = ACCOUNT_WIZARD_CONTEXT_GET_IFACE(context);
 
+  /* the credentials are likely to change */
+  _accounts_verification_cache_invalidate_edited(context);
+
   if (iface->finish)
     return iface->finish(context, error);
 
@@ -0,0 +1,254 @@
+/*
+ * accounts-bulk.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-bulk
+ * @short_description: enable or disable many accounts at once.
+ *
+ * accounts_bulk_set_enabled_async() enables or disables a set of accounts,
+ * as needed by "go online" and "go offline" actions. Instead of waiting for
+ * each account in turn, the requests are made concurrently through
+ * account_item_set_enabled_async(), so the whole operation takes about as
+ * long as the slowest plugin.
+ *
+ * The number of requests in progress can be limited, both in total and for
+ * the accounts of a single plugin, for plugins which don't cope well with
+ * many concurrent requests. Accounts are dispatched in the order they were
+ * given, skipping those whose plugin is at its limit until one of its
+ * requests completes.
+ */
+
+#include "config.h"
+
+#include "account-error.h"
+#include "accounts-bulk.h"
+
+typedef struct _BulkData
+{
+  gboolean enabled;
+  guint max_parallel;
+  guint max_per_plugin;
+
+  /* AccountItem, not yet dispatched */
+  GQueue pending;
+  guint running;
+  /* AccountPlugin -> number of its requests in progress */
+  GHashTable *plugin_running;
+
+  /* AccountItem -> GError */
+  GHashTable *errors;
+  guint n_items;
+} BulkData;
+
+static void
+bulk_data_free(BulkData *data)
+{
+  g_queue_clear_full(&data->pending, g_object_unref);
+  g_hash_table_destroy(data->plugin_running);
+  g_hash_table_unref(data->errors);
+
+  g_slice_free(BulkData, data);
+}
+
+static guint
+plugin_running(BulkData *data, AccountPlugin *plugin)
+{
+  return GPOINTER_TO_UINT(g_hash_table_lookup(data->plugin_running, plugin));
+}
+
+static void
+bulk_complete(GTask *task)
+{
+  BulkData *data = g_task_get_task_data(task);
+  guint n_failed = g_hash_table_size(data->errors);
+
+  if (!n_failed)
+    g_task_return_boolean(task, TRUE);
+  else if (!g_task_return_error_if_cancelled(task))
+  {
+    g_task_return_new_error(task, ACCOUNT_ERROR, ACCOUNT_ERROR_UNKNOWN,
+                            "%u of %u accounts could not be %s", n_failed,
+                            data->n_items,
+                            data->enabled ? "enabled" : "disabled");
+  }
+}
+
+static void bulk_dispatch(GTask *task);
+
+static void
+bulk_item_done(GObject *source_object, GAsyncResult *result,
+               gpointer user_data)
+{
+  GTask *task = user_data;
+  BulkData *data = g_task_get_task_data(task);
+  AccountItem *item = ACCOUNT_ITEM(source_object);
+  AccountPlugin *plugin = account_item_get_plugin(item);
+  GError *error = NULL;
+  guint count;
+
+  if (!account_item_set_enabled_finish(item, result, &error))
+    g_hash_table_insert(data->errors, g_object_ref(item), error);
+
+  count = plugin_running(data, plugin);
+
+  if (count > 1)
+  {
+    g_hash_table_insert(data->plugin_running, plugin,
+                        GUINT_TO_POINTER(count - 1));
+  }
+  else
+    g_hash_table_remove(data->plugin_running, plugin);
+
+  data->running--;
+
+  if (!data->running && g_queue_is_empty(&data->pending))
+    bulk_complete(task);
+  else
+    bulk_dispatch(task);
+
+  g_object_unref(task);
+}
+
+static void
+bulk_dispatch(GTask *task)
+{
+  BulkData *data = g_task_get_task_data(task);
+  GList *l = data->pending.head;
+
+  while (l && (!data->max_parallel || data->running < data->max_parallel))
+  {
+    AccountItem *item = l->data;
+    AccountPlugin *plugin = account_item_get_plugin(item);
+    guint count = plugin_running(data, plugin);
+    GList *next = l->next;
+
+    if (!data->max_per_plugin || count < data->max_per_plugin)
+    {
+      g_queue_delete_link(&data->pending, l);
+      g_hash_table_insert(data->plugin_running, plugin,
+                          GUINT_TO_POINTER(count + 1));
+      data->running++;
+
+      /* cancellation is handled by the item, which fails right away */
+      account_item_set_enabled_async(item, data->enabled,
+                                     g_task_get_cancellable(task),
+                                     bulk_item_done, g_object_ref(task));
+      g_object_unref(item);
+    }
+
+    l = next;
+  }
+}
+
+/**
+ * accounts_bulk_set_enabled_async:
+ * @items:(element-type AccountItem): the #AccountItem objects to enable or
+ * disable.
+ * @enabled: whether to enable or disable the accounts.
+ * @max_parallel: the maximum number of requests in progress, or 0 for no
+ * limit.
+ * @max_per_plugin: the maximum number of requests in progress for the
+ * accounts of a single plugin, or 0 for no limit.
+ * @cancellable:(nullable): a #GCancellable, or %NULL.
+ * @callback: a #GAsyncReadyCallback to call when all the requests completed.
+ * @user_data: the data to pass to @callback.
+ *
+ * Enables or disables all the @items, making up to @max_parallel concurrent
+ * calls to account_item_set_enabled_async(). Call
+ * accounts_bulk_set_enabled_finish() from @callback to get the result.
+ *
+ * Cancelling @cancellable fails the requests which didn't start yet; those in
+ * progress are cancelled as far as their plugins allow it.
+ */
+void
+accounts_bulk_set_enabled_async(GList *items, gboolean enabled,
+                                guint max_parallel, guint max_per_plugin,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+  GTask *task;
+  BulkData *data;
+  GList *l;
+
+  g_return_if_fail(!cancellable || G_IS_CANCELLABLE(cancellable));
+
+  for (l = items; l; l = l->next)
+    g_return_if_fail(ACCOUNT_IS_ITEM(l->data));
+
+  task = g_task_new(NULL, cancellable, callback, user_data);
+  g_task_set_source_tag(task, accounts_bulk_set_enabled_async);
+  /* cancellation only matters if it made some of the requests fail */
+  g_task_set_check_cancellable(task, FALSE);
+
+  data = g_slice_new0(BulkData);
+  data->enabled = enabled;
+  data->max_parallel = max_parallel;
+  data->max_per_plugin = max_per_plugin;
+  data->plugin_running = g_hash_table_new(g_direct_hash, g_direct_equal);
+  data->errors = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                       g_object_unref,
+                                       (GDestroyNotify)g_error_free);
+  g_task_set_task_data(task, data, (GDestroyNotify)bulk_data_free);
+
+  for (l = items; l; l = l->next)
+    g_queue_push_tail(&data->pending, g_object_ref(l->data));
+
+  data->n_items = g_queue_get_length(&data->pending);
+
+  if (data->n_items)
+    bulk_dispatch(task);
+  else
+    g_task_return_boolean(task, TRUE);
+
+  g_object_unref(task);
+}
+
+/**
+ * accounts_bulk_set_enabled_finish:
+ * @result: the #GAsyncResult passed to the callback.
+ * @errors:(out)(optional)(transfer full)(element-type AccountItem GError):
+ * return location for a #GHashTable mapping each #AccountItem which failed to
+ * its #GError, or %NULL.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with accounts_bulk_set_enabled_async().
+ * When some of the accounts failed, @error is set to a summary error and
+ * @errors, which is always set, holds the reason of each failure.
+ *
+ * Returns: %TRUE if all the accounts were enabled or disabled, %FALSE
+ * otherwise.
+ */
+gboolean
+accounts_bulk_set_enabled_finish(GAsyncResult *result, GHashTable **errors,
+                                 GError **error)
+{
+  BulkData *data;
+
+  g_return_val_if_fail(g_task_is_valid(result, NULL), FALSE);
+  g_return_val_if_fail(g_task_get_source_tag(G_TASK(result)) ==
+                       accounts_bulk_set_enabled_async, FALSE);
+
+  data = g_task_get_task_data(G_TASK(result));
+
+  if (errors)
+    *errors = g_hash_table_ref(data->errors);
+
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
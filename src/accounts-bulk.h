@@ -0,0 +1,42 @@
+/*
+ * accounts-bulk.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_BULK_H_
+#define _ACCOUNTS_BULK_H_
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include "account-item.h"
+
+G_BEGIN_DECLS
+
+void accounts_bulk_set_enabled_async (GList *items, gboolean enabled,
+                                      guint max_parallel,
+                                      guint max_per_plugin,
+                                      GCancellable *cancellable,
+                                      GAsyncReadyCallback callback,
+                                      gpointer user_data);
+gboolean accounts_bulk_set_enabled_finish (GAsyncResult *result,
+                                           GHashTable **errors,
+                                           GError **error);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_BULK_H_ */
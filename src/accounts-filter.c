@@ -0,0 +1,466 @@
+/*
+ * accounts-filter.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-filter
+ * @short_description: a live query over the accounts.
+ *
+ * An #AccountsFilter holds the accounts of an #AccountsModel which match the
+ * conditions of accounts_model_query(), for example "the connected accounts
+ * of plugin X". It is filled from the model indexes when created, and then
+ * kept up to date one account at a time: an account is only checked again
+ * when it is added to the model or when one of its state properties changes.
+ * Accounts entering and leaving the filter are reported through the
+ * #AccountsFilter::item-added and #AccountsFilter::item-removed signals.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "accounts-filter.h"
+#include "accounts-private.h"
+
+struct _AccountsFilterPrivate
+{
+  AccountsModel *model;
+  gchar *service;
+  gchar *plugin;
+  /* their interned copies, once some account has them */
+  const gchar *service_key;
+  const gchar *plugin_key;
+  AccountsStateFlags required;
+  AccountsStateFlags rejected;
+  /* set of AccountItem */
+  GHashTable *items;
+};
+
+typedef struct _AccountsFilterPrivate AccountsFilterPrivate;
+
+#define PRIVATE(filter) \
+  ((AccountsFilterPrivate *) \
+   accounts_filter_get_instance_private((AccountsFilter *)(filter)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsFilter,
+  accounts_filter,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_MODEL = 1,
+  PROP_SERVICE,
+  PROP_PLUGIN,
+  PROP_REQUIRED,
+  PROP_REJECTED
+};
+
+enum
+{
+  ITEM_ADDED,
+  ITEM_REMOVED,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+/* the names are looked up rather than interned, so that any string can be
+ * given without growing the intern table; until a name is interned, no
+ * account has it */
+static gboolean
+resolve_names(AccountsFilterPrivate *priv)
+{
+  if (priv->service && !priv->service_key)
+    priv->service_key = _accounts_lookup_interned(priv->service);
+
+  if (priv->plugin && !priv->plugin_key)
+    priv->plugin_key = _accounts_lookup_interned(priv->plugin);
+
+  return (!priv->service || priv->service_key) &&
+         (!priv->plugin || priv->plugin_key);
+}
+
+static void
+update_item(AccountsFilter *filter, AccountItem *item)
+{
+  AccountsFilterPrivate *priv = PRIVATE(filter);
+  gboolean matches = resolve_names(priv) &&
+    _accounts_model_item_matches(priv->model, item, priv->service_key,
+                                 priv->plugin_key, priv->required,
+                                 priv->rejected);
+
+  if (matches == g_hash_table_contains(priv->items, item))
+    return;
+
+  if (matches)
+  {
+    g_hash_table_add(priv->items, g_object_ref(item));
+    g_signal_emit(filter, signals[ITEM_ADDED], 0, item);
+  }
+  else
+  {
+    g_hash_table_steal(priv->items, item);
+    g_signal_emit(filter, signals[ITEM_REMOVED], 0, item);
+    g_object_unref(item);
+  }
+}
+
+static void
+on_item_added(AccountsModel *model, AccountItem *item, AccountsFilter *filter)
+{
+  update_item(filter, item);
+}
+
+static void
+on_item_removed(AccountsModel *model, AccountItem *item,
+                AccountsFilter *filter)
+{
+  /* no longer part of the model, so it does not match anymore */
+  update_item(filter, item);
+}
+
+static void
+on_item_changed(AccountsModel *model, AccountItem *item, guint n_pspecs,
+                GParamSpec **pspecs, AccountsFilter *filter)
+{
+  guint i;
+
+  /* service and plugin never change, only the state can */
+  for (i = 0; i < n_pspecs; i++)
+  {
+    if (!strcmp(pspecs[i]->name, "enabled") ||
+        !strcmp(pspecs[i]->name, "connected") ||
+        !strcmp(pspecs[i]->name, "draft"))
+    {
+      update_item(filter, item);
+      break;
+    }
+  }
+}
+
+static void
+accounts_filter_constructed(GObject *object)
+{
+  AccountsFilterPrivate *priv = PRIVATE(object);
+  GList *items;
+  GList *l;
+
+  G_OBJECT_CLASS(accounts_filter_parent_class)->constructed(object);
+
+  if (!priv->model)
+    return;
+
+  g_signal_connect(priv->model, "item-added",
+                   G_CALLBACK(on_item_added), object);
+  g_signal_connect(priv->model, "item-removed",
+                   G_CALLBACK(on_item_removed), object);
+  g_signal_connect(priv->model, "item-changed",
+                   G_CALLBACK(on_item_changed), object);
+
+  items = accounts_model_query(priv->model, priv->service, priv->plugin,
+                               priv->required, priv->rejected);
+
+  for (l = items; l; l = l->next)
+    g_hash_table_add(priv->items, g_object_ref(l->data));
+
+  g_list_free(items);
+}
+
+static void
+accounts_filter_dispose(GObject *object)
+{
+  AccountsFilterPrivate *priv = PRIVATE(object);
+
+  if (priv->model)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->model, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->model);
+    priv->model = NULL;
+  }
+
+  g_hash_table_remove_all(priv->items);
+
+  G_OBJECT_CLASS(accounts_filter_parent_class)->dispose(object);
+}
+
+static void
+accounts_filter_finalize(GObject *object)
+{
+  g_hash_table_destroy(PRIVATE(object)->items);
+  g_free(PRIVATE(object)->service);
+  g_free(PRIVATE(object)->plugin);
+
+  G_OBJECT_CLASS(accounts_filter_parent_class)->finalize(object);
+}
+
+static void
+accounts_filter_set_property(GObject *object, guint property_id,
+                             const GValue *value, GParamSpec *pspec)
+{
+  AccountsFilterPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_FILTER(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      priv->model = g_value_dup_object(value);
+      break;
+    }
+    case PROP_SERVICE:
+    {
+      priv->service = g_value_dup_string(value);
+      break;
+    }
+    case PROP_PLUGIN:
+    {
+      priv->plugin = g_value_dup_string(value);
+      break;
+    }
+    case PROP_REQUIRED:
+    {
+      priv->required = g_value_get_uint(value);
+      break;
+    }
+    case PROP_REJECTED:
+    {
+      priv->rejected = g_value_get_uint(value);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_filter_get_property(GObject *object, guint property_id,
+                             GValue *value, GParamSpec *pspec)
+{
+  AccountsFilterPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_FILTER(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      g_value_set_object(value, priv->model);
+      break;
+    }
+    case PROP_SERVICE:
+    {
+      g_value_set_string(value, priv->service);
+      break;
+    }
+    case PROP_PLUGIN:
+    {
+      g_value_set_string(value, priv->plugin);
+      break;
+    }
+    case PROP_REQUIRED:
+    {
+      g_value_set_uint(value, priv->required);
+      break;
+    }
+    case PROP_REJECTED:
+    {
+      g_value_set_uint(value, priv->rejected);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_filter_class_init(AccountsFilterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_filter_constructed;
+  object_class->dispose = accounts_filter_dispose;
+  object_class->finalize = accounts_filter_finalize;
+  object_class->set_property = accounts_filter_set_property;
+  object_class->get_property = accounts_filter_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_MODEL,
+    g_param_spec_object(
+      "model",
+      "Model",
+      "AccountsModel being filtered",
+      ACCOUNTS_TYPE_MODEL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_SERVICE,
+    g_param_spec_string(
+      "service",
+      "Service",
+      "Name of the service of the accounts, NULL for any",
+      NULL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_PLUGIN,
+    g_param_spec_string(
+      "plugin",
+      "Plugin",
+      "Name of the plugin of the accounts, NULL for any",
+      NULL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_REQUIRED,
+    g_param_spec_uint(
+      "required-state",
+      "Required state",
+      "AccountsStateFlags the accounts must have",
+      0, G_MAXUINT, 0,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_REJECTED,
+    g_param_spec_uint(
+      "rejected-state",
+      "Rejected state",
+      "AccountsStateFlags the accounts must not have",
+      0, G_MAXUINT, 0,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+
+  signals[ITEM_ADDED] = g_signal_new(
+      "item-added", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsFilterClass, item_added), NULL, NULL,
+      g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1, ACCOUNT_TYPE_ITEM);
+  signals[ITEM_REMOVED] = g_signal_new(
+      "item-removed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsFilterClass, item_removed), NULL, NULL,
+      g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1, ACCOUNT_TYPE_ITEM);
+}
+
+static void
+accounts_filter_init(AccountsFilter *filter)
+{
+  PRIVATE(filter)->items = g_hash_table_new_full(NULL, NULL, g_object_unref,
+                                                 NULL);
+}
+
+/**
+ * accounts_filter_new:
+ * @model: the #AccountsModel to filter.
+ * @service:(nullable): the name of an #AccountService, or %NULL for any.
+ * @plugin:(nullable): the name of an #AccountPlugin, or %NULL for any.
+ * @required: the state flags the accounts must have.
+ * @rejected: the state flags the accounts must not have.
+ *
+ * Creates an #AccountsFilter holding the accounts of @model which match the
+ * given conditions, see accounts_model_query().
+ *
+ * Returns:(transfer full): a new #AccountsFilter.
+ */
+AccountsFilter *
+accounts_filter_new(AccountsModel *model, const gchar *service,
+                    const gchar *plugin, AccountsStateFlags required,
+                    AccountsStateFlags rejected)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_FILTER,
+                      "model", model,
+                      "service", service,
+                      "plugin", plugin,
+                      "required-state", required,
+                      "rejected-state", rejected,
+                      NULL);
+}
+
+static gint
+compare_item_id(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  guint id_a = accounts_model_get_item_id(user_data, (AccountItem *)a);
+  guint id_b = accounts_model_get_item_id(user_data, (AccountItem *)b);
+
+  if (id_a == id_b)
+    return 0;
+
+  return id_a < id_b ? -1 : 1;
+}
+
+/**
+ * accounts_filter_list:
+ * @filter: the #AccountsFilter.
+ *
+ * Gets the accounts currently matching @filter.
+ *
+ * Returns:(transfer container)(element-type AccountItem): the accounts, in
+ * the order they were added to the model; free the list with g_list_free().
+ */
+GList *
+accounts_filter_list(AccountsFilter *filter)
+{
+  AccountsFilterPrivate *priv;
+
+  g_return_val_if_fail(ACCOUNTS_IS_FILTER(filter), NULL);
+
+  priv = PRIVATE(filter);
+
+  if (!priv->model)
+    return NULL;
+
+  return g_list_sort_with_data(g_hash_table_get_keys(priv->items),
+                               compare_item_id, priv->model);
+}
+
+/**
+ * accounts_filter_get_n_items:
+ * @filter: the #AccountsFilter.
+ *
+ * Returns: the number of accounts currently matching @filter.
+ */
+guint
+accounts_filter_get_n_items(AccountsFilter *filter)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_FILTER(filter), 0);
+
+  return g_hash_table_size(PRIVATE(filter)->items);
+}
+
+/**
+ * accounts_filter_contains:
+ * @filter: the #AccountsFilter.
+ * @item: an #AccountItem.
+ *
+ * Returns: %TRUE if @item currently matches @filter.
+ */
+gboolean
+accounts_filter_contains(AccountsFilter *filter, AccountItem *item)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_FILTER(filter), FALSE);
+
+  return g_hash_table_contains(PRIVATE(filter)->items, item);
+}
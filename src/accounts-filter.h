@@ -0,0 +1,67 @@
+/*
+ * accounts-filter.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_FILTER_H_
+#define _ACCOUNTS_FILTER_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_FILTER             (accounts_filter_get_type ())
+#define ACCOUNTS_FILTER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_FILTER, AccountsFilter))
+#define ACCOUNTS_FILTER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_FILTER, AccountsFilterClass))
+#define ACCOUNTS_IS_FILTER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_FILTER))
+#define ACCOUNTS_IS_FILTER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_FILTER))
+#define ACCOUNTS_FILTER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_FILTER, AccountsFilterClass))
+
+typedef struct _AccountsFilterClass AccountsFilterClass;
+typedef struct _AccountsFilter AccountsFilter;
+
+#include "accounts-model.h"
+
+struct _AccountsFilterClass
+{
+    GObjectClass parent_class;
+
+    /* signals */
+    void (*item_added) (AccountsFilter *filter, AccountItem *item);
+    void (*item_removed) (AccountsFilter *filter, AccountItem *item);
+};
+
+struct _AccountsFilter
+{
+    GObject parent_instance;
+};
+
+GType accounts_filter_get_type (void) G_GNUC_CONST;
+
+AccountsFilter *accounts_filter_new (AccountsModel *model,
+                                     const gchar *service,
+                                     const gchar *plugin,
+                                     AccountsStateFlags required,
+                                     AccountsStateFlags rejected);
+
+GList *accounts_filter_list (AccountsFilter *filter);
+guint accounts_filter_get_n_items (AccountsFilter *filter);
+gboolean accounts_filter_contains (AccountsFilter *filter, AccountItem *item);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_FILTER_H_ */
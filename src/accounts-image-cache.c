@@ -0,0 +1,462 @@
+/*
+ * accounts-image-cache.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-image-cache
+ * @short_description: memory-budgeted cache of decoded images.
+ *
+ * An #AccountsImageCache keeps decoded #GdkPixbuf objects by key and by the
+ * size they were decoded at, evicting the least recently used ones when
+ * their pixel data exceed #AccountsImageCache:budget bytes. The default
+ * cache, see accounts_image_cache_get_default(), holds the avatars of the
+ * #AccountItem objects and their scaled copies, so that their memory use
+ * doesn't grow with the number of accounts.
+ *
+ * The most recently inserted image is never evicted by its own insertion, so
+ * that a pixbuf just decoded stays alive until the next one is, even if it
+ * doesn't fit in the budget.
+ *
+ * The cache can be used from any thread.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "accounts-image-cache.h"
+
+typedef struct _CacheEntry
+{
+  gchar *key;
+  gint size;
+  GdkPixbuf *pixbuf;
+  gsize length;
+} CacheEntry;
+
+struct _AccountsImageCachePrivate
+{
+  GMutex mutex;
+  gsize budget;
+  gsize size;
+  /* CacheEntry, the most recently used first */
+  GQueue lru;
+  /* CacheEntry -> GList link in lru */
+  GHashTable *entries;
+};
+
+typedef struct _AccountsImageCachePrivate AccountsImageCachePrivate;
+
+#define PRIVATE(cache) \
+  ((AccountsImageCachePrivate *) \
+   accounts_image_cache_get_instance_private((AccountsImageCache *)(cache)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsImageCache,
+  accounts_image_cache,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_BUDGET = 1,
+  PROP_SIZE
+};
+
+#define DEFAULT_BUDGET (4 * 1024 * 1024)
+
+static guint
+cache_entry_hash(gconstpointer key)
+{
+  const CacheEntry *entry = key;
+
+  return g_str_hash(entry->key) * 31 + entry->size;
+}
+
+static gboolean
+cache_entry_equal(gconstpointer a, gconstpointer b)
+{
+  const CacheEntry *entry_a = a;
+  const CacheEntry *entry_b = b;
+
+  return entry_a->size == entry_b->size && !strcmp(entry_a->key, entry_b->key);
+}
+
+static void
+cache_entry_free(CacheEntry *entry)
+{
+  g_free(entry->key);
+  g_object_unref(entry->pixbuf);
+  g_slice_free(CacheEntry, entry);
+}
+
+/* with the mutex held */
+static void
+remove_link(AccountsImageCachePrivate *priv, GList *link)
+{
+  CacheEntry *entry = link->data;
+
+  g_hash_table_remove(priv->entries, entry);
+  g_queue_delete_link(&priv->lru, link);
+  priv->size -= entry->length;
+  cache_entry_free(entry);
+}
+
+/* with the mutex held, keeps @keep */
+static void
+evict(AccountsImageCachePrivate *priv, GList *keep)
+{
+  GList *l = priv->lru.tail;
+
+  while (l && priv->size > priv->budget)
+  {
+    GList *prev = l->prev;
+
+    if (l != keep)
+      remove_link(priv, l);
+
+    l = prev;
+  }
+}
+
+static void
+accounts_image_cache_finalize(GObject *object)
+{
+  AccountsImageCachePrivate *priv = PRIVATE(object);
+
+  g_hash_table_destroy(priv->entries);
+  g_queue_clear_full(&priv->lru, (GDestroyNotify)cache_entry_free);
+  g_mutex_clear(&priv->mutex);
+
+  G_OBJECT_CLASS(accounts_image_cache_parent_class)->finalize(object);
+}
+
+static void
+accounts_image_cache_set_property(GObject *object, guint property_id,
+                                  const GValue *value, GParamSpec *pspec)
+{
+  g_return_if_fail(ACCOUNTS_IS_IMAGE_CACHE(object));
+
+  switch (property_id)
+  {
+    case PROP_BUDGET:
+    {
+      accounts_image_cache_set_budget(ACCOUNTS_IMAGE_CACHE(object),
+                                      g_value_get_uint64(value));
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_image_cache_get_property(GObject *object, guint property_id,
+                                  GValue *value, GParamSpec *pspec)
+{
+  g_return_if_fail(ACCOUNTS_IS_IMAGE_CACHE(object));
+
+  switch (property_id)
+  {
+    case PROP_BUDGET:
+    {
+      g_value_set_uint64(value, accounts_image_cache_get_budget(
+                           ACCOUNTS_IMAGE_CACHE(object)));
+      break;
+    }
+    case PROP_SIZE:
+    {
+      g_value_set_uint64(value, accounts_image_cache_get_size(
+                           ACCOUNTS_IMAGE_CACHE(object)));
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_image_cache_class_init(AccountsImageCacheClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->finalize = accounts_image_cache_finalize;
+  object_class->set_property = accounts_image_cache_set_property;
+  object_class->get_property = accounts_image_cache_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_BUDGET,
+    g_param_spec_uint64(
+      "budget",
+      "Budget",
+      "Maximum size of the cached pixel data, in bytes",
+      0, G_MAXSIZE, DEFAULT_BUDGET,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_SIZE,
+    g_param_spec_uint64(
+      "size",
+      "Size",
+      "Size of the cached pixel data, in bytes",
+      0, G_MAXSIZE, 0,
+      G_PARAM_READABLE));
+}
+
+static void
+accounts_image_cache_init(AccountsImageCache *cache)
+{
+  AccountsImageCachePrivate *priv = PRIVATE(cache);
+
+  g_mutex_init(&priv->mutex);
+  g_queue_init(&priv->lru);
+  priv->entries = g_hash_table_new(cache_entry_hash, cache_entry_equal);
+}
+
+/**
+ * accounts_image_cache_new:
+ * @budget: the maximum size of the cached pixel data, in bytes.
+ *
+ * Creates an #AccountsImageCache.
+ *
+ * Returns:(transfer full): a new #AccountsImageCache.
+ */
+AccountsImageCache *
+accounts_image_cache_new(gsize budget)
+{
+  return g_object_new(ACCOUNTS_TYPE_IMAGE_CACHE,
+                      "budget", (guint64)budget,
+                      NULL);
+}
+
+/**
+ * accounts_image_cache_get_default:
+ *
+ * Gets the cache shared by the whole process, which holds the avatars of the
+ * accounts.
+ *
+ * Returns:(transfer none): the default #AccountsImageCache.
+ */
+AccountsImageCache *
+accounts_image_cache_get_default(void)
+{
+  static AccountsImageCache *cache = NULL;
+
+  if (g_once_init_enter(&cache))
+    g_once_init_leave(&cache, accounts_image_cache_new(DEFAULT_BUDGET));
+
+  return cache;
+}
+
+/**
+ * accounts_image_cache_lookup:
+ * @cache: the #AccountsImageCache.
+ * @key: the key of the image.
+ * @size: the size the image was decoded at, or 0 for its natural size.
+ *
+ * Looks up the image cached for @key and @size, making it the most recently
+ * used one.
+ *
+ * Returns:(transfer full)(nullable): the cached #GdkPixbuf, or %NULL.
+ */
+GdkPixbuf *
+accounts_image_cache_lookup(AccountsImageCache *cache, const gchar *key,
+                            gint size)
+{
+  AccountsImageCachePrivate *priv;
+  GdkPixbuf *pixbuf = NULL;
+  CacheEntry lookup = { (gchar *)key, size, NULL, 0 };
+  GList *link;
+
+  g_return_val_if_fail(ACCOUNTS_IS_IMAGE_CACHE(cache), NULL);
+  g_return_val_if_fail(key != NULL, NULL);
+
+  priv = PRIVATE(cache);
+
+  g_mutex_lock(&priv->mutex);
+
+  link = g_hash_table_lookup(priv->entries, &lookup);
+
+  if (link)
+  {
+    g_queue_unlink(&priv->lru, link);
+    g_queue_push_head_link(&priv->lru, link);
+    pixbuf = g_object_ref(((CacheEntry *)link->data)->pixbuf);
+  }
+
+  g_mutex_unlock(&priv->mutex);
+
+  return pixbuf;
+}
+
+/**
+ * accounts_image_cache_insert:
+ * @cache: the #AccountsImageCache.
+ * @key: the key of the image.
+ * @size: the size the image was decoded at, or 0 for its natural size.
+ * @pixbuf: the decoded image.
+ *
+ * Caches @pixbuf for @key and @size, replacing any image cached for them,
+ * and evicts the least recently used images if the budget is exceeded.
+ */
+void
+accounts_image_cache_insert(AccountsImageCache *cache, const gchar *key,
+                            gint size, GdkPixbuf *pixbuf)
+{
+  AccountsImageCachePrivate *priv;
+  CacheEntry *entry;
+  GList *link;
+
+  g_return_if_fail(ACCOUNTS_IS_IMAGE_CACHE(cache));
+  g_return_if_fail(key != NULL);
+  g_return_if_fail(GDK_IS_PIXBUF(pixbuf));
+
+  priv = PRIVATE(cache);
+
+  entry = g_slice_new(CacheEntry);
+  entry->key = g_strdup(key);
+  entry->size = size;
+  entry->pixbuf = g_object_ref(pixbuf);
+  entry->length = gdk_pixbuf_get_byte_length(pixbuf);
+
+  g_mutex_lock(&priv->mutex);
+
+  link = g_hash_table_lookup(priv->entries, entry);
+
+  if (link)
+    remove_link(priv, link);
+
+  g_queue_push_head(&priv->lru, entry);
+  g_hash_table_insert(priv->entries, entry, priv->lru.head);
+  priv->size += entry->length;
+  evict(priv, priv->lru.head);
+
+  g_mutex_unlock(&priv->mutex);
+}
+
+/**
+ * accounts_image_cache_remove:
+ * @cache: the #AccountsImageCache.
+ * @key: the key of the image.
+ *
+ * Drops the images cached for @key, at all sizes.
+ */
+void
+accounts_image_cache_remove(AccountsImageCache *cache, const gchar *key)
+{
+  AccountsImageCachePrivate *priv;
+  GList *l;
+
+  g_return_if_fail(ACCOUNTS_IS_IMAGE_CACHE(cache));
+  g_return_if_fail(key != NULL);
+
+  priv = PRIVATE(cache);
+
+  g_mutex_lock(&priv->mutex);
+
+  for (l = priv->lru.head; l; )
+  {
+    GList *next = l->next;
+
+    if (!strcmp(((CacheEntry *)l->data)->key, key))
+      remove_link(priv, l);
+
+    l = next;
+  }
+
+  g_mutex_unlock(&priv->mutex);
+}
+
+/**
+ * accounts_image_cache_get_budget:
+ * @cache: the #AccountsImageCache.
+ *
+ * Returns: the value of the #AccountsImageCache:budget property.
+ */
+gsize
+accounts_image_cache_get_budget(AccountsImageCache *cache)
+{
+  AccountsImageCachePrivate *priv;
+  gsize budget;
+
+  g_return_val_if_fail(ACCOUNTS_IS_IMAGE_CACHE(cache), 0);
+
+  priv = PRIVATE(cache);
+
+  g_mutex_lock(&priv->mutex);
+  budget = priv->budget;
+  g_mutex_unlock(&priv->mutex);
+
+  return budget;
+}
+
+/**
+ * accounts_image_cache_set_budget:
+ * @cache: the #AccountsImageCache.
+ * @budget: the maximum size of the cached pixel data, in bytes.
+ *
+ * Sets the #AccountsImageCache:budget property, evicting images right away if
+ * it shrinks.
+ */
+void
+accounts_image_cache_set_budget(AccountsImageCache *cache, gsize budget)
+{
+  AccountsImageCachePrivate *priv;
+  gboolean changed;
+
+  g_return_if_fail(ACCOUNTS_IS_IMAGE_CACHE(cache));
+
+  priv = PRIVATE(cache);
+
+  g_mutex_lock(&priv->mutex);
+  changed = priv->budget != budget;
+  priv->budget = budget;
+  evict(priv, NULL);
+  g_mutex_unlock(&priv->mutex);
+
+  if (changed)
+    g_object_notify(G_OBJECT(cache), "budget");
+}
+
+/**
+ * accounts_image_cache_get_size:
+ * @cache: the #AccountsImageCache.
+ *
+ * Returns: the size of the cached pixel data, in bytes.
+ */
+gsize
+accounts_image_cache_get_size(AccountsImageCache *cache)
+{
+  AccountsImageCachePrivate *priv;
+  gsize size;
+
+  g_return_val_if_fail(ACCOUNTS_IS_IMAGE_CACHE(cache), 0);
+
+  priv = PRIVATE(cache);
+
+  g_mutex_lock(&priv->mutex);
+  size = priv->size;
+  g_mutex_unlock(&priv->mutex);
+
+  return size;
+}
@@ -0,0 +1,68 @@
+/*
+ * accounts-image-cache.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_IMAGE_CACHE_H_
+#define _ACCOUNTS_IMAGE_CACHE_H_
+
+#include <glib-object.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_IMAGE_CACHE             (accounts_image_cache_get_type ())
+#define ACCOUNTS_IMAGE_CACHE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_IMAGE_CACHE, AccountsImageCache))
+#define ACCOUNTS_IMAGE_CACHE_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_IMAGE_CACHE, AccountsImageCacheClass))
+#define ACCOUNTS_IS_IMAGE_CACHE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_IMAGE_CACHE))
+#define ACCOUNTS_IS_IMAGE_CACHE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_IMAGE_CACHE))
+#define ACCOUNTS_IMAGE_CACHE_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_IMAGE_CACHE, AccountsImageCacheClass))
+
+typedef struct _AccountsImageCacheClass AccountsImageCacheClass;
+typedef struct _AccountsImageCache AccountsImageCache;
+
+struct _AccountsImageCacheClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsImageCache
+{
+    GObject parent_instance;
+};
+
+GType accounts_image_cache_get_type (void) G_GNUC_CONST;
+
+AccountsImageCache *accounts_image_cache_new (gsize budget);
+AccountsImageCache *accounts_image_cache_get_default (void);
+
+GdkPixbuf *accounts_image_cache_lookup (AccountsImageCache *cache,
+                                        const gchar *key, gint size);
+void accounts_image_cache_insert (AccountsImageCache *cache,
+                                  const gchar *key, gint size,
+                                  GdkPixbuf *pixbuf);
+void accounts_image_cache_remove (AccountsImageCache *cache,
+                                  const gchar *key);
+
+gsize accounts_image_cache_get_budget (AccountsImageCache *cache);
+void accounts_image_cache_set_budget (AccountsImageCache *cache,
+                                      gsize budget);
+gsize accounts_image_cache_get_size (AccountsImageCache *cache);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_IMAGE_CACHE_H_ */
@@ -0,0 +1,886 @@
+/*
+ * accounts-image.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-image
+ * @short_description: reference to an image decoded on demand.
+ *
+ * An #AccountsImage references an image by its source instead of holding its
+ * decoded pixels: a file, a #GBytes with the encoded data, or a callback
+ * decoding it. accounts_image_load() decodes it the first time it is needed,
+ * and keeps the result in the default #AccountsImageCache, so that images
+ * which are not displayed don't use any memory, and those which were
+ * displayed long ago are evicted.
+ *
+ * Images are usually displayed much smaller than they are stored, so
+ * accounts_image_load_at_size() decodes them directly at the size they are
+ * needed at, which is faster than decoding them at full resolution and
+ * scaling them, and caches only the result. Files are memory mapped rather
+ * than read, so keeping them around doesn't cost memory either.
+ *
+ * accounts_image_load_async() decodes the image in a worker thread, so that
+ * the main loop is not blocked, for example when many accounts are loaded at
+ * startup.
+ *
+ * Images given as encoded data, either as a file or a #GBytes, are cached by
+ * the SHA-256 hash of that data rather than by their source. The same avatar
+ * used by several accounts, or the same icon used by several services or
+ * plugins, is thus decoded only once and all of them share the resulting
+ * #GdkPixbuf, however many #AccountsImage reference it.
+ *
+ * Those images are also kept, at each size they were decoded at, in a
+ * thumbnail cache in the user cache directory. Thumbnails are stored as raw
+ * pixels, so they are memory mapped rather than decoded on the next start.
+ * The least recently written ones are removed once they take more than
+ * accounts_image_get_thumbnail_budget() bytes.
+ *
+ * Plugins use it to provide the avatar of their accounts, see
+ * account_item_set_avatar_image().
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include "accounts-image.h"
+#include "accounts-image-cache.h"
+
+#define THUMBNAIL_MAGIC 0x5443414cu /* "LACT" */
+#define THUMBNAIL_VERSION 1
+/* bigger images are decoded faster than they are read raw */
+#define THUMBNAIL_MAX_BYTES (1024 * 1024)
+#define THUMBNAIL_DEFAULT_BUDGET (32 * 1024 * 1024)
+
+/* followed by the pixels, 8 bits per sample RGB or RGBA, in host byte order */
+typedef struct
+{
+  guint32 magic;
+  guint32 version;
+  gint32 width;
+  gint32 height;
+  gint32 rowstride;
+  guint32 has_alpha;
+  guint32 reserved[2];
+} ThumbnailHeader;
+
+typedef struct
+{
+  gchar *path;
+  gsize size;
+  gint64 mtime;
+} ThumbnailFile;
+
+/* protects the thumbnail directory bookkeeping below */
+static GMutex thumbnails_mutex;
+static gsize thumbnails_budget = THUMBNAIL_DEFAULT_BUDGET;
+/* what the thumbnails take, according to the last scan and the thumbnails
+ * saved since, or -1 before the first scan */
+static gint64 thumbnails_size = -1;
+
+typedef enum
+{
+  SOURCE_FILE,
+  SOURCE_BYTES,
+  SOURCE_LOADER
+} SourceType;
+
+struct _AccountsImagePrivate
+{
+  SourceType type;
+  gchar *path;
+  GMutex mutex;
+  /* the hash of the data, computed when it is first needed */
+  gchar *key;
+  /* the mapped file for SOURCE_FILE, mapped on first use */
+  GBytes *bytes;
+  AccountsImageLoadFunc func;
+  gpointer user_data;
+  GDestroyNotify destroy;
+};
+
+typedef struct _AccountsImagePrivate AccountsImagePrivate;
+
+#define PRIVATE(image) \
+  ((AccountsImagePrivate *) \
+   accounts_image_get_instance_private((AccountsImage *)(image)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsImage,
+  accounts_image,
+  G_TYPE_OBJECT
+)
+
+/* scales to fit in a @size square, preserving the aspect ratio */
+static void
+fit_size(gint size, gint *width, gint *height)
+{
+  if (*width >= *height)
+  {
+    *height = MAX(1, *height * size / *width);
+    *width = size;
+  }
+  else
+  {
+    *width = MAX(1, *width * size / *height);
+    *height = size;
+  }
+}
+
+static void
+on_size_prepared(GdkPixbufLoader *loader, gint width, gint height,
+                 gpointer user_data)
+{
+  gint size = GPOINTER_TO_INT(user_data);
+
+  if (width > size || height > size)
+  {
+    fit_size(size, &width, &height);
+    gdk_pixbuf_loader_set_size(loader, width, height);
+  }
+}
+
+/* takes @pixbuf */
+static GdkPixbuf *
+scale_down(GdkPixbuf *pixbuf, gint size)
+{
+  gint width = gdk_pixbuf_get_width(pixbuf);
+  gint height = gdk_pixbuf_get_height(pixbuf);
+  GdkPixbuf *scaled;
+
+  if (!size || (width <= size && height <= size))
+    return pixbuf;
+
+  fit_size(size, &width, &height);
+  scaled = gdk_pixbuf_scale_simple(pixbuf, width, height,
+                                   GDK_INTERP_BILINEAR);
+  g_object_unref(pixbuf);
+
+  return scaled;
+}
+
+static GdkPixbuf *
+decode_bytes(GBytes *bytes, gint size, GError **error)
+{
+  GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
+  GdkPixbuf *pixbuf = NULL;
+  gsize length;
+  const guchar *data = g_bytes_get_data(bytes, &length);
+
+  if (size)
+  {
+    g_signal_connect(loader, "size-prepared", G_CALLBACK(on_size_prepared),
+                     GINT_TO_POINTER(size));
+  }
+
+  if (gdk_pixbuf_loader_write(loader, data, length, error) &&
+      gdk_pixbuf_loader_close(loader, error))
+  {
+    pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+
+    if (pixbuf)
+      g_object_ref(pixbuf);
+    else
+    {
+      g_set_error(error, GDK_PIXBUF_ERROR, GDK_PIXBUF_ERROR_FAILED,
+                  "Image data could not be decoded");
+    }
+  }
+  else
+    gdk_pixbuf_loader_close(loader, NULL);
+
+  g_object_unref(loader);
+
+  return pixbuf;
+}
+
+static gchar *
+thumbnail_dir(void)
+{
+  return g_build_filename(g_get_user_cache_dir(), "libaccounts", "thumbnails",
+                          NULL);
+}
+
+static gchar *
+thumbnail_path(const gchar *key, gint size)
+{
+  gchar *dir;
+  gchar *name;
+  gchar *path;
+
+  /* only content keys are stable across processes */
+  if (!g_str_has_prefix(key, "sha256:"))
+    return NULL;
+
+  dir = thumbnail_dir();
+  name = g_strdup_printf("%s-%d.raw", key + strlen("sha256:"), size);
+  path = g_build_filename(dir, name, NULL);
+  g_free(name);
+  g_free(dir);
+
+  return path;
+}
+
+static gint
+compare_thumbnail_age(gconstpointer a, gconstpointer b)
+{
+  const ThumbnailFile *file_a = a;
+  const ThumbnailFile *file_b = b;
+
+  if (file_a->mtime != file_b->mtime)
+    return file_a->mtime < file_b->mtime ? -1 : 1;
+
+  return strcmp(file_a->path, file_b->path);
+}
+
+/* called with thumbnails_mutex held. Once over the budget, the oldest
+ * thumbnails are removed down to 3/4 of it, so that the directory is not
+ * scanned again on every save. */
+static void
+thumbnails_prune(void)
+{
+  gchar *path = thumbnail_dir();
+  GDir *dir = g_dir_open(path, 0, NULL);
+  GArray *files;
+  const gchar *name;
+  gsize total = 0;
+  guint i;
+
+  if (!dir)
+  {
+    thumbnails_size = 0;
+    g_free(path);
+    return;
+  }
+
+  files = g_array_new(FALSE, FALSE, sizeof(ThumbnailFile));
+
+  while ((name = g_dir_read_name(dir)))
+  {
+    ThumbnailFile file;
+    GStatBuf buf;
+
+    /* leaves the temporary files of concurrent saves alone */
+    if (!g_str_has_suffix(name, ".raw"))
+      continue;
+
+    file.path = g_build_filename(path, name, NULL);
+
+    if (g_stat(file.path, &buf))
+    {
+      g_free(file.path);
+      continue;
+    }
+
+    file.size = buf.st_size;
+    file.mtime = buf.st_mtime;
+    total += file.size;
+    g_array_append_val(files, file);
+  }
+
+  g_dir_close(dir);
+
+  if (total > thumbnails_budget)
+  {
+    gsize target = thumbnails_budget / 4 * 3;
+
+    g_array_sort(files, compare_thumbnail_age);
+
+    for (i = 0; i < files->len && total > target; i++)
+    {
+      ThumbnailFile *file = &g_array_index(files, ThumbnailFile, i);
+
+      if (!g_unlink(file->path))
+        total -= file->size;
+    }
+  }
+
+  for (i = 0; i < files->len; i++)
+    g_free(g_array_index(files, ThumbnailFile, i).path);
+
+  g_array_free(files, TRUE);
+  g_free(path);
+  thumbnails_size = total;
+}
+
+/* whether @header describes pixels which fit in the @length bytes after it */
+static gboolean
+thumbnail_header_is_valid(const ThumbnailHeader *header, gsize length)
+{
+  gsize n_channels = header->has_alpha ? 4 : 3;
+  gsize row;
+  gsize needed;
+
+  if (header->magic != THUMBNAIL_MAGIC ||
+      header->version != THUMBNAIL_VERSION ||
+      header->width <= 0 || header->width > THUMBNAIL_MAX_BYTES ||
+      header->height <= 0 || header->height > THUMBNAIL_MAX_BYTES ||
+      header->rowstride <= 0 || header->rowstride > THUMBNAIL_MAX_BYTES)
+  {
+    return FALSE;
+  }
+
+  /* the last row doesn't need to be padded to the rowstride */
+  if (!g_size_checked_mul(&row, header->width, n_channels) ||
+      row > (gsize)header->rowstride ||
+      !g_size_checked_mul(&needed, header->rowstride, header->height - 1) ||
+      !g_size_checked_add(&needed, needed, row))
+  {
+    return FALSE;
+  }
+
+  return needed <= length;
+}
+
+static GdkPixbuf *
+thumbnail_load(const gchar *key, gint size)
+{
+  gchar *path = thumbnail_path(key, size);
+  GdkPixbuf *pixbuf = NULL;
+  GMappedFile *file;
+
+  if (!path)
+    return NULL;
+
+  file = g_mapped_file_new(path, FALSE, NULL);
+
+  if (file)
+  {
+    const ThumbnailHeader *header =
+      (const ThumbnailHeader *)g_mapped_file_get_contents(file);
+    gsize length = g_mapped_file_get_length(file);
+
+    if (length >= sizeof(*header) &&
+        thumbnail_header_is_valid(header, length - sizeof(*header)))
+    {
+      GBytes *bytes = g_mapped_file_get_bytes(file);
+      GBytes *pixels = g_bytes_new_from_bytes(bytes, sizeof(*header),
+                                              length - sizeof(*header));
+
+      /* the pixbuf keeps the file mapped */
+      pixbuf = gdk_pixbuf_new_from_bytes(pixels, GDK_COLORSPACE_RGB,
+                                         header->has_alpha != 0, 8,
+                                         header->width, header->height,
+                                         header->rowstride);
+      g_bytes_unref(pixels);
+      g_bytes_unref(bytes);
+    }
+    else
+    {
+      /* it would only be ignored again */
+      g_unlink(path);
+    }
+
+    g_mapped_file_unref(file);
+  }
+
+  g_free(path);
+
+  return pixbuf;
+}
+
+static void
+thumbnail_save(const gchar *key, gint size, GdkPixbuf *pixbuf)
+{
+  gsize length = gdk_pixbuf_get_byte_length(pixbuf);
+  ThumbnailHeader header;
+  GError *error = NULL;
+  gchar *path;
+  gchar *dir;
+  gchar *contents;
+
+  if (gdk_pixbuf_get_bits_per_sample(pixbuf) != 8 ||
+      gdk_pixbuf_get_colorspace(pixbuf) != GDK_COLORSPACE_RGB ||
+      gdk_pixbuf_get_n_channels(pixbuf) !=
+      (gdk_pixbuf_get_has_alpha(pixbuf) ? 4 : 3) ||
+      length > THUMBNAIL_MAX_BYTES)
+  {
+    return;
+  }
+
+  path = thumbnail_path(key, size);
+
+  if (!path)
+    return;
+
+  dir = g_path_get_dirname(path);
+
+  if (g_mkdir_with_parents(dir, 0700))
+  {
+    g_warning("Cannot create thumbnail directory %s: %s", dir,
+              g_strerror(errno));
+    goto out;
+  }
+
+  memset(&header, 0, sizeof(header));
+  header.magic = THUMBNAIL_MAGIC;
+  header.version = THUMBNAIL_VERSION;
+  header.width = gdk_pixbuf_get_width(pixbuf);
+  header.height = gdk_pixbuf_get_height(pixbuf);
+  header.rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+  header.has_alpha = gdk_pixbuf_get_has_alpha(pixbuf);
+
+  contents = g_malloc(sizeof(header) + length);
+  memcpy(contents, &header, sizeof(header));
+  memcpy(contents + sizeof(header), gdk_pixbuf_read_pixels(pixbuf), length);
+
+  /* atomic, so concurrent readers never see a partial thumbnail */
+  if (g_file_set_contents(path, contents, sizeof(header) + length, &error))
+  {
+    g_mutex_lock(&thumbnails_mutex);
+
+    if (thumbnails_size < 0 ||
+        (thumbnails_size += sizeof(header) + length) >
+        (gint64)thumbnails_budget)
+    {
+      thumbnails_prune();
+    }
+
+    g_mutex_unlock(&thumbnails_mutex);
+  }
+  else
+  {
+    g_warning("Cannot save thumbnail %s: %s", path, error->message);
+    g_error_free(error);
+  }
+
+  g_free(contents);
+
+out:
+  g_free(dir);
+  g_free(path);
+}
+
+static void
+accounts_image_finalize(GObject *object)
+{
+  AccountsImagePrivate *priv = PRIVATE(object);
+
+  /* nobody can ask for this key any more, content keys may be shared though */
+  if (priv->type == SOURCE_LOADER)
+    accounts_image_cache_remove(accounts_image_cache_get_default(), priv->key);
+
+  if (priv->destroy)
+    priv->destroy(priv->user_data);
+
+  if (priv->bytes)
+    g_bytes_unref(priv->bytes);
+
+  g_free(priv->path);
+  g_free(priv->key);
+  g_mutex_clear(&priv->mutex);
+
+  G_OBJECT_CLASS(accounts_image_parent_class)->finalize(object);
+}
+
+static void
+accounts_image_class_init(AccountsImageClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->finalize = accounts_image_finalize;
+}
+
+static void
+accounts_image_init(AccountsImage *image)
+{
+  g_mutex_init(&PRIVATE(image)->mutex);
+}
+
+static gchar *
+content_key(GBytes *bytes)
+{
+  gchar *checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, bytes);
+  gchar *key = g_strconcat("sha256:", checksum, NULL);
+
+  g_free(checksum);
+
+  return key;
+}
+
+/**
+ * accounts_image_new_from_file:
+ * @path: the path of the image file.
+ *
+ * Creates an #AccountsImage decoded from the file at @path, which is mapped
+ * in memory, and hashed, the first time the image is decoded.
+ *
+ * Returns:(transfer full): a new #AccountsImage.
+ */
+AccountsImage *
+accounts_image_new_from_file(const gchar *path)
+{
+  AccountsImage *image;
+
+  g_return_val_if_fail(path != NULL, NULL);
+
+  image = g_object_new(ACCOUNTS_TYPE_IMAGE, NULL);
+  PRIVATE(image)->type = SOURCE_FILE;
+  PRIVATE(image)->path = g_strdup(path);
+
+  return image;
+}
+
+/**
+ * accounts_image_new_from_bytes:
+ * @bytes: the encoded image data.
+ *
+ * Creates an #AccountsImage decoded from @bytes, in any format supported by
+ * #GdkPixbufLoader. @bytes is hashed the first time the image is decoded, so
+ * images created from the same data share their decoded pixbufs.
+ *
+ * Returns:(transfer full): a new #AccountsImage.
+ */
+AccountsImage *
+accounts_image_new_from_bytes(GBytes *bytes)
+{
+  AccountsImage *image;
+
+  g_return_val_if_fail(bytes != NULL, NULL);
+
+  image = g_object_new(ACCOUNTS_TYPE_IMAGE, NULL);
+  PRIVATE(image)->type = SOURCE_BYTES;
+  PRIVATE(image)->bytes = g_bytes_ref(bytes);
+
+  return image;
+}
+
+/**
+ * accounts_image_new_from_loader:
+ * @func:(scope notified): the #AccountsImageLoadFunc decoding the image.
+ * @user_data: the data to pass to @func.
+ * @destroy:(nullable): the function to free @user_data with, or %NULL.
+ *
+ * Creates an #AccountsImage decoded by @func. @func may be called from any
+ * thread.
+ *
+ * Returns:(transfer full): a new #AccountsImage.
+ */
+AccountsImage *
+accounts_image_new_from_loader(AccountsImageLoadFunc func, gpointer user_data,
+                               GDestroyNotify destroy)
+{
+  static gint serial = 0;
+  AccountsImage *image;
+
+  g_return_val_if_fail(func != NULL, NULL);
+
+  image = g_object_new(ACCOUNTS_TYPE_IMAGE, NULL);
+  PRIVATE(image)->type = SOURCE_LOADER;
+  PRIVATE(image)->func = func;
+  PRIVATE(image)->user_data = user_data;
+  PRIVATE(image)->destroy = destroy;
+  PRIVATE(image)->key = g_strdup_printf("image:%d",
+                                        g_atomic_int_add(&serial, 1));
+
+  return image;
+}
+
+/**
+ * accounts_image_get_key:
+ * @image: the #AccountsImage.
+ *
+ * Gets the key @image is cached with in the #AccountsImageCache. For images
+ * with encoded data, this is the hash of the data, shared by all images with
+ * the same data, which is only known once the data was hashed, when the
+ * image is decoded for the first time.
+ *
+ * Returns:(nullable): the key of @image, or %NULL if not known yet.
+ */
+const gchar *
+accounts_image_get_key(AccountsImage *image)
+{
+  AccountsImagePrivate *priv;
+  const gchar *key;
+
+  g_return_val_if_fail(ACCOUNTS_IS_IMAGE(image), NULL);
+
+  /* the key never changes once set */
+  priv = PRIVATE(image);
+  g_mutex_lock(&priv->mutex);
+  key = priv->key;
+  g_mutex_unlock(&priv->mutex);
+
+  return key;
+}
+
+static GBytes *
+get_bytes(AccountsImagePrivate *priv, GError **error)
+{
+  GBytes *bytes = NULL;
+
+  g_mutex_lock(&priv->mutex);
+
+  if (!priv->bytes && priv->type == SOURCE_FILE)
+  {
+    GMappedFile *file = g_mapped_file_new(priv->path, FALSE, error);
+
+    if (file)
+    {
+      priv->bytes = g_mapped_file_get_bytes(file);
+      g_mapped_file_unref(file);
+    }
+  }
+
+  /* hashing takes a while, do it in the thread decoding the image */
+  if (priv->bytes && !priv->key)
+    priv->key = content_key(priv->bytes);
+
+  if (priv->bytes)
+    bytes = g_bytes_ref(priv->bytes);
+
+  g_mutex_unlock(&priv->mutex);
+
+  return bytes;
+}
+
+static void
+load_thread(GTask *task, gpointer source_object, gpointer task_data,
+            GCancellable *cancellable)
+{
+  GError *error = NULL;
+  GdkPixbuf *pixbuf;
+
+  pixbuf = accounts_image_load_at_size(source_object,
+                                       GPOINTER_TO_INT(task_data), &error);
+
+  if (pixbuf)
+    g_task_return_pointer(task, pixbuf, g_object_unref);
+  else
+    g_task_return_error(task, error);
+}
+
+/**
+ * accounts_image_load:
+ * @image: the #AccountsImage.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Gets the image at its natural size, see accounts_image_load_at_size().
+ *
+ * Returns:(transfer full): the decoded #GdkPixbuf, or %NULL on error.
+ */
+GdkPixbuf *
+accounts_image_load(AccountsImage *image, GError **error)
+{
+  return accounts_image_load_at_size(image, 0, error);
+}
+
+/**
+ * accounts_image_load_at_size:
+ * @image: the #AccountsImage.
+ * @size: the size of the square the image must fit in, in pixels, or 0 for
+ * its natural size.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Gets the image scaled down, if needed, to fit in a square of @size pixels,
+ * preserving its aspect ratio. The image is taken from the default
+ * #AccountsImageCache if it is still there, otherwise it is decoded at that
+ * size and added to the cache. This can be called from any thread.
+ *
+ * Returns:(transfer full): the decoded #GdkPixbuf, or %NULL on error.
+ */
+GdkPixbuf *
+accounts_image_load_at_size(AccountsImage *image, gint size, GError **error)
+{
+  AccountsImageCache *cache = accounts_image_cache_get_default();
+  AccountsImagePrivate *priv;
+  GdkPixbuf *pixbuf;
+
+  g_return_val_if_fail(ACCOUNTS_IS_IMAGE(image), NULL);
+  g_return_val_if_fail(size >= 0, NULL);
+
+  priv = PRIVATE(image);
+
+  if (priv->type == SOURCE_LOADER)
+  {
+    pixbuf = accounts_image_cache_lookup(cache, priv->key, size);
+
+    if (pixbuf)
+      return pixbuf;
+
+    pixbuf = priv->func(size, priv->user_data, error);
+
+    if (pixbuf)
+      pixbuf = scale_down(pixbuf, size);
+  }
+  else
+  {
+    /* this also gives the key of encoded data */
+    GBytes *bytes = get_bytes(priv, error);
+
+    if (!bytes)
+      return NULL;
+
+    pixbuf = accounts_image_cache_lookup(cache, priv->key, size);
+
+    if (pixbuf)
+    {
+      g_bytes_unref(bytes);
+
+      return pixbuf;
+    }
+
+    pixbuf = thumbnail_load(priv->key, size);
+
+    if (!pixbuf)
+    {
+      pixbuf = decode_bytes(bytes, size, error);
+
+      if (pixbuf)
+        thumbnail_save(priv->key, size, pixbuf);
+    }
+
+    g_bytes_unref(bytes);
+  }
+
+  if (pixbuf)
+    accounts_image_cache_insert(cache, priv->key, size, pixbuf);
+
+  return pixbuf;
+}
+
+/**
+ * accounts_image_lookup:
+ * @image: the #AccountsImage.
+ * @size: the size of the square the image must fit in, in pixels, or 0 for
+ * its natural size.
+ *
+ * Gets the image at @size from the default #AccountsImageCache, without
+ * decoding it if it is not there.
+ *
+ * Returns:(transfer full)(nullable): the cached #GdkPixbuf, or %NULL.
+ */
+GdkPixbuf *
+accounts_image_lookup(AccountsImage *image, gint size)
+{
+  const gchar *key;
+
+  g_return_val_if_fail(ACCOUNTS_IS_IMAGE(image), NULL);
+  g_return_val_if_fail(size >= 0, NULL);
+
+  key = accounts_image_get_key(image);
+
+  if (!key)
+    return NULL;
+
+  return accounts_image_cache_lookup(accounts_image_cache_get_default(), key,
+                                     size);
+}
+
+/**
+ * accounts_image_load_async:
+ * @image: the #AccountsImage.
+ * @size: the size of the square the image must fit in, in pixels, or 0 for
+ * its natural size.
+ * @cancellable:(nullable): a #GCancellable, or %NULL.
+ * @callback: a #GAsyncReadyCallback to call when done.
+ * @user_data: the data to pass to @callback.
+ *
+ * Asynchronously gets the image, like accounts_image_load_at_size() but
+ * decoding it in a worker thread if it is not cached. Call
+ * accounts_image_load_finish() from @callback to get the result, which is
+ * delivered in the thread-default main context of the caller.
+ */
+void
+accounts_image_load_async(AccountsImage *image, gint size,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data)
+{
+  GdkPixbuf *pixbuf;
+  GTask *task;
+
+  g_return_if_fail(ACCOUNTS_IS_IMAGE(image));
+  g_return_if_fail(size >= 0);
+  g_return_if_fail(!cancellable || G_IS_CANCELLABLE(cancellable));
+
+  task = g_task_new(image, cancellable, callback, user_data);
+  g_task_set_source_tag(task, accounts_image_load_async);
+  pixbuf = accounts_image_lookup(image, size);
+
+  if (pixbuf)
+    g_task_return_pointer(task, pixbuf, g_object_unref);
+  else
+  {
+    g_task_set_task_data(task, GINT_TO_POINTER(size), NULL);
+    /* the result is cached anyway, let the decoding complete */
+    g_task_set_return_on_cancel(task, TRUE);
+    g_task_run_in_thread(task, load_thread);
+  }
+
+  g_object_unref(task);
+}
+
+/**
+ * accounts_image_load_finish:
+ * @image: the #AccountsImage.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with accounts_image_load_async().
+ *
+ * Returns:(transfer full): the decoded #GdkPixbuf, or %NULL on error.
+ */
+GdkPixbuf *
+accounts_image_load_finish(AccountsImage *image, GAsyncResult *result,
+                           GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, image), NULL);
+
+  return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+/**
+ * accounts_image_get_thumbnail_budget:
+ *
+ * Gets how much disk space the thumbnail cache can take, see
+ * accounts_image_set_thumbnail_budget().
+ *
+ * Returns: the maximum size of the thumbnails, in bytes.
+ */
+gsize
+accounts_image_get_thumbnail_budget(void)
+{
+  gsize budget;
+
+  g_mutex_lock(&thumbnails_mutex);
+  budget = thumbnails_budget;
+  g_mutex_unlock(&thumbnails_mutex);
+
+  return budget;
+}
+
+/**
+ * accounts_image_set_thumbnail_budget:
+ * @budget: the maximum size of the thumbnails, in bytes.
+ *
+ * Sets how much disk space the thumbnail cache can take, 32 MiB by default.
+ * When a saved thumbnail makes it exceed @budget, the least recently written
+ * thumbnails are removed. They are also removed right away if @budget is
+ * already exceeded. This can be called from any thread.
+ */
+void
+accounts_image_set_thumbnail_budget(gsize budget)
+{
+  g_mutex_lock(&thumbnails_mutex);
+  thumbnails_budget = budget;
+  thumbnails_prune();
+  g_mutex_unlock(&thumbnails_mutex);
+}
@@ -0,0 +1,90 @@
+/*
+ * accounts-image.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_IMAGE_H_
+#define _ACCOUNTS_IMAGE_H_
+
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_IMAGE             (accounts_image_get_type ())
+#define ACCOUNTS_IMAGE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_IMAGE, AccountsImage))
+#define ACCOUNTS_IMAGE_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_IMAGE, AccountsImageClass))
+#define ACCOUNTS_IS_IMAGE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_IMAGE))
+#define ACCOUNTS_IS_IMAGE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_IMAGE))
+#define ACCOUNTS_IMAGE_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_IMAGE, AccountsImageClass))
+
+typedef struct _AccountsImageClass AccountsImageClass;
+typedef struct _AccountsImage AccountsImage;
+
+/**
+ * AccountsImageLoadFunc:
+ * @size: the size the image is needed at, or 0 for its natural size.
+ * @user_data: the data passed to accounts_image_new_from_loader().
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Decodes an image provided through a callback. The image should be decoded
+ * to fit in a square of @size pixels, if possible; a larger image is scaled
+ * down afterwards.
+ *
+ * Returns:(transfer full): the decoded #GdkPixbuf, or %NULL on error.
+ */
+typedef GdkPixbuf *(*AccountsImageLoadFunc) (gint size, gpointer user_data,
+                                             GError **error);
+
+struct _AccountsImageClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsImage
+{
+    GObject parent_instance;
+};
+
+GType accounts_image_get_type (void) G_GNUC_CONST;
+
+AccountsImage *accounts_image_new_from_file (const gchar *path);
+AccountsImage *accounts_image_new_from_bytes (GBytes *bytes);
+AccountsImage *accounts_image_new_from_loader (AccountsImageLoadFunc func,
+                                               gpointer user_data,
+                                               GDestroyNotify destroy);
+
+const gchar *accounts_image_get_key (AccountsImage *image);
+GdkPixbuf *accounts_image_load (AccountsImage *image, GError **error);
+GdkPixbuf *accounts_image_load_at_size (AccountsImage *image, gint size,
+                                        GError **error);
+GdkPixbuf *accounts_image_lookup (AccountsImage *image, gint size);
+
+void accounts_image_load_async (AccountsImage *image, gint size,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data);
+GdkPixbuf *accounts_image_load_finish (AccountsImage *image,
+                                       GAsyncResult *result, GError **error);
+
+gsize accounts_image_get_thumbnail_budget (void);
+void accounts_image_set_thumbnail_budget (gsize budget);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_IMAGE_H_ */
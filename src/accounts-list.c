@@ -27,11 +27,17 @@
  * it whenever an #AccountItem is created or deleted, and on the other end
  * listen to the #AccountsList::remove-item signal to know when an account has to
  * be deleted.
+ *
+ * Plugins which reload all of their accounts at once, for example because their
+ * backing store changed, should report them with
+ * accounts_list_replace_for_plugin(), so that only the accounts which really
+ * changed are added, removed or updated.
  */
 
 #include "config.h"
 
 #include "accounts-list.h"
+#include "account-plugin.h"
 
 typedef AccountsListIface AccountsListInterface;
 
@@ -120,3 +126,235 @@ accounts_list_get_all(AccountsList *accounts_list)
 
   return ACCOUNTS_LIST_GET_IFACE(accounts_list)->get_all(accounts_list);
 }
+
+static gchar *
+item_key(AccountItem *item)
+{
+  return g_strdup_printf("%s\n%s\n%s", G_OBJECT_TYPE_NAME(item),
+                         account_service_get_name(item->service),
+                         item->name ? item->name : "");
+}
+
+static gboolean
+same_image(AccountsImage *a, AccountsImage *b)
+{
+  const gchar *key;
+
+  if (a == b)
+    return TRUE;
+
+  if (!a || !b)
+    return FALSE;
+
+  key = accounts_image_get_key(a);
+
+  return key && !g_strcmp0(key, accounts_image_get_key(b));
+}
+
+/* copies the avatar without decoding those given as an AccountsImage */
+static void
+update_avatar(AccountItem *dest, AccountItem *src)
+{
+  AccountsImage *image = account_item_get_avatar_image(src);
+
+  if (image)
+  {
+    if (!same_image(image, account_item_get_avatar_image(dest)))
+      account_item_set_avatar_image(dest, image);
+  }
+  else if (account_item_get_avatar_image(dest) || dest->avatar != src->avatar)
+    account_item_set_avatar(dest, src->avatar);
+}
+
+/* copies the state of src into dest, notifying only what differs */
+static void
+update_item(AccountItem *dest, AccountItem *src)
+{
+  GParamSpec **pspecs;
+  guint n_pspecs;
+  guint i;
+
+  g_object_freeze_notify(G_OBJECT(dest));
+
+  pspecs = g_object_class_list_properties(G_OBJECT_GET_CLASS(src), &n_pspecs);
+
+  for (i = 0; i < n_pspecs; i++)
+  {
+    GParamSpec *pspec = pspecs[i];
+    GValue dest_value = G_VALUE_INIT;
+    GValue src_value = G_VALUE_INIT;
+
+    if ((pspec->flags & (G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY)) !=
+        G_PARAM_READWRITE ||
+        !g_strcmp0(pspec->name, "avatar") ||
+        !g_strcmp0(pspec->name, "avatar-image"))
+    {
+      continue;
+    }
+
+    g_value_init(&dest_value, pspec->value_type);
+    g_value_init(&src_value, pspec->value_type);
+    g_object_get_property(G_OBJECT(dest), pspec->name, &dest_value);
+    g_object_get_property(G_OBJECT(src), pspec->name, &src_value);
+
+    if (g_param_values_cmp(pspec, &dest_value, &src_value))
+      g_object_set_property(G_OBJECT(dest), pspec->name, &src_value);
+
+    g_value_unset(&dest_value);
+    g_value_unset(&src_value);
+  }
+
+  g_free(pspecs);
+  update_avatar(dest, src);
+
+  /* read-only state, maintained by the plugin */
+  if (dest->enabled != src->enabled)
+  {
+    dest->enabled = src->enabled;
+    g_object_notify(G_OBJECT(dest), "enabled");
+  }
+
+  if (dest->draft != src->draft)
+  {
+    dest->draft = src->draft;
+    g_object_notify(G_OBJECT(dest), "draft");
+  }
+
+  if (dest->connected != src->connected)
+  {
+    dest->connected = src->connected;
+    g_object_notify(G_OBJECT(dest), "connected");
+  }
+
+  g_object_thaw_notify(G_OBJECT(dest));
+}
+
+/**
+ * accounts_list_replace_for_plugin:
+ * @accounts_list: the #AccountsList.
+ * @plugin: the #AccountPlugin reporting its accounts.
+ * @items:(element-type AccountItem)(transfer none): the complete, new set of
+ * accounts of @plugin.
+ *
+ * Replaces the accounts of @plugin registered in @accounts_list with @items,
+ * doing as little as possible. Accounts are matched by type, service and name,
+ * in the order they were registered if several have the same ones:
+ * for each account of @items which is already registered, the registered
+ * #AccountItem is kept and only the properties which differ are copied to it
+ * and notified. Only the accounts of @items without a match are added, and
+ * only the registered accounts of @plugin without a match are removed.
+ *
+ * The accounts removed this way are gone from the plugin already, so
+ * #AccountPluginClass.deleted() is not called for them; to achieve that, the
+ * handlers @plugin connected to @accounts_list are blocked while removing.
+ *
+ * Returns:(transfer container)(element-type AccountItem): the accounts of
+ * @plugin now registered in @accounts_list, in the order of @items; free the
+ * list with g_list_free().
+ */
+GList *
+accounts_list_replace_for_plugin(AccountsList *accounts_list,
+                                 AccountPlugin *plugin, GList *items)
+{
+  GHashTable *registered;
+  GList *current;
+  GList *result = NULL;
+  GList *l;
+
+  g_return_val_if_fail(ACCOUNTS_IS_LIST(accounts_list), NULL);
+  g_return_val_if_fail(ACCOUNT_IS_PLUGIN(plugin), NULL);
+
+  for (l = items; l; l = l->next)
+  {
+    g_return_val_if_fail(ACCOUNT_IS_ITEM(l->data), NULL);
+    g_return_val_if_fail(account_item_get_plugin(l->data) == plugin, NULL);
+  }
+
+  /* key -> GQueue of the AccountItem registered with it, which may be
+   * several */
+  registered = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                     (GDestroyNotify)g_queue_free);
+  current = accounts_list_get_all(accounts_list);
+
+  for (l = current; l; l = l->next)
+  {
+    AccountItem *item = l->data;
+    gchar *key;
+    GQueue *queue;
+
+    if (account_item_get_plugin(item) != plugin)
+      continue;
+
+    key = item_key(item);
+    queue = g_hash_table_lookup(registered, key);
+
+    if (!queue)
+    {
+      queue = g_queue_new();
+      g_hash_table_insert(registered, key, queue);
+    }
+    else
+      g_free(key);
+
+    g_queue_push_tail(queue, item);
+  }
+
+  for (l = items; l; l = l->next)
+  {
+    AccountItem *item = l->data;
+    AccountItem *match = NULL;
+    GQueue *queue;
+    gchar *key;
+
+    key = item_key(item);
+    queue = g_hash_table_lookup(registered, key);
+
+    /* an account registered already matches itself */
+    if (queue && g_queue_remove(queue, item))
+      match = item;
+    else if (queue)
+      match = g_queue_pop_head(queue);
+
+    if (match)
+    {
+      if (match != item)
+        update_item(match, item);
+
+      result = g_list_prepend(result, match);
+    }
+    else
+    {
+      accounts_list_add(accounts_list, item);
+      result = g_list_prepend(result, item);
+    }
+
+    g_free(key);
+  }
+
+  if (g_hash_table_size(registered))
+  {
+    GHashTableIter iter;
+    gpointer queue;
+
+    g_signal_handlers_block_matched(accounts_list, G_SIGNAL_MATCH_DATA, 0, 0,
+                                    NULL, NULL, plugin);
+    g_hash_table_iter_init(&iter, registered);
+
+    /* every registered account left without a match */
+    while (g_hash_table_iter_next(&iter, NULL, &queue))
+    {
+      AccountItem *item;
+
+      while ((item = g_queue_pop_head(queue)))
+        accounts_list_remove(accounts_list, item);
+    }
+
+    g_signal_handlers_unblock_matched(accounts_list, G_SIGNAL_MATCH_DATA, 0,
+                                      0, NULL, NULL, plugin);
+  }
+
+  g_hash_table_destroy(registered);
+  g_list_free_full(current, g_object_unref);
+
+  return g_list_reverse(result);
+}
@@ -52,6 +52,10 @@ void   accounts_list_remove (AccountsList *accounts_list, AccountItem *account_i
 
 GList *accounts_list_get_all (AccountsList *accounts_list);
 
+GList *accounts_list_replace_for_plugin (AccountsList *accounts_list,
+                                         AccountPlugin *plugin,
+                                         GList *items);
+
 G_END_DECLS
 
 #endif /* _ACCOUNTS_LIST_H_ */
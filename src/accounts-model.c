@@ -0,0 +1,1213 @@
+/*
+ * accounts-model.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-model
+ * @short_description: a tracked copy of an #AccountsList.
+ *
+ * The #AccountsModel follows an #AccountsList: it takes the accounts already
+ * registered in it when created, and then listens to the
+ * #AccountsList::add-item and #AccountsList::remove-item signals and to the
+ * #AccountItem::properties-changed signal of every #AccountItem. Changes are
+ * reported through the #AccountsModel::item-added,
+ * #AccountsModel::item-removed and #AccountsModel::item-changed signals; the
+ * properties changed together, for example with account_item_update(), are
+ * reported by a single #AccountsModel::item-changed emission.
+ *
+ * Every account is given a numeric identifier, unique for the lifetime of the
+ * model, which can be used to refer to it from places where holding a
+ * reference to the #AccountItem is not possible, such as other threads.
+ *
+ * The #AccountsModel and the #AccountItem objects must only be used from the
+ * main thread; worker threads can instead read the accounts through the
+ * #AccountsSnapshot returned by accounts_model_get_snapshot(), which is
+ * lock-free.
+ *
+ * The model also keeps a bounded log of the latest changes, each one tagged
+ * with a sequence number: consumers which only look at the accounts from time
+ * to time can remember the value of accounts_model_get_sequence() and later
+ * call accounts_model_changes_since() to learn what happened in the meantime,
+ * instead of comparing the whole list of accounts against their own copy.
+ *
+ * Views which don't need to react to every single property change can set the
+ * #AccountsModel:coalesce-interval property and connect to the
+ * #AccountsModel::items-updated signal instead of
+ * #AccountsModel::item-changed: property changes are then gathered per account
+ * and delivered at most once per interval, in a single batch.
+ *
+ * Accounts are indexed by service, plugin and state, so that
+ * accounts_model_query() only looks at the accounts which can possibly match;
+ * see #AccountsFilter for a query which is kept up to date as accounts change.
+ */
+
+#include "config.h"
+
+#include "accounts-model.h"
+#include "accounts-private.h"
+
+#include "account-marshal.h"
+
+typedef struct _AccountsModelEntry
+{
+  AccountItem *item;
+  guint id;
+  AccountsRecord *record;
+  /* index keys, interned */
+  const gchar *service;
+  const gchar *plugin;
+  AccountsStateFlags state;
+} AccountsModelEntry;
+
+#define N_STATES 3
+
+struct _AccountsModelPrivate
+{
+  AccountsList *accounts_list;
+  /* AccountsModelEntry, sorted by id */
+  GPtrArray *entries;
+  GHashTable *by_item;
+  guint last_id;
+
+  /* indexes, interned name or state bit -> set of AccountsModelEntry */
+  GHashTable *by_service;
+  GHashTable *by_plugin;
+  GHashTable *by_state[N_STATES];
+
+  /* change log, a ring buffer of change_log_size entries */
+  AccountsChange *change_log;
+  guint change_log_size;
+  guint64 sequence;
+
+  /* coalesced updates, AccountItem -> AccountsItemUpdate */
+  guint coalesce_interval;
+  guint coalesce_id;
+  GHashTable *pending;
+  /* AccountsItemUpdate, in the order the accounts first changed */
+  GPtrArray *pending_order;
+
+  /* current snapshot, read by other threads */
+  AccountsSnapshot *snapshot;
+  /* number of threads between loading and referencing the snapshot */
+  gint readers;
+  /* replaced snapshots which might still be being referenced */
+  GSList *retired;
+  guint reclaim_id;
+};
+
+typedef struct _AccountsModelPrivate AccountsModelPrivate;
+
+#define PRIVATE(model) \
+  ((AccountsModelPrivate *) \
+   accounts_model_get_instance_private((AccountsModel *)(model)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsModel,
+  accounts_model,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_ACCOUNTS_LIST = 1,
+  PROP_CHANGE_LOG_SIZE,
+  PROP_COALESCE_INTERVAL
+};
+
+#define DEFAULT_CHANGE_LOG_SIZE 256
+/* readers only hold a snapshot for a few instructions, retry reclaiming
+ * replaced ones after that rather than spinning the main loop */
+#define RECLAIM_DELAY 5 /* ms */
+
+enum
+{
+  ITEM_ADDED,
+  ITEM_REMOVED,
+  ITEM_CHANGED,
+  ITEMS_UPDATED,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+static void
+reclaim_snapshots(AccountsModel *model);
+
+static gboolean
+reclaim_snapshots_timeout(gpointer user_data)
+{
+  AccountsModel *model = user_data;
+
+  PRIVATE(model)->reclaim_id = 0;
+  reclaim_snapshots(model);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+reclaim_snapshots(AccountsModel *model)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+
+  if (!priv->retired)
+    return;
+
+  /* The retired snapshots are not reachable anymore, so a reader arriving
+   * after this check can only pick the current one. */
+  if (g_atomic_int_get(&priv->readers) == 0)
+  {
+    g_slist_free_full(priv->retired, (GDestroyNotify)accounts_snapshot_unref);
+    priv->retired = NULL;
+  }
+  else if (!priv->reclaim_id)
+    priv->reclaim_id = g_timeout_add(RECLAIM_DELAY, reclaim_snapshots_timeout,
+                                     model);
+}
+
+static void
+log_change(AccountsModel *model, AccountsChangeType type, guint id,
+           const gchar *property)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  AccountsChange *change;
+
+  priv->sequence++;
+  change = &priv->change_log[(priv->sequence - 1) % priv->change_log_size];
+  change->sequence = priv->sequence;
+  change->type = type;
+  change->id = id;
+  change->property = property;
+}
+
+static void
+publish_snapshot(AccountsModel *model)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  GPtrArray *records = g_ptr_array_sized_new(priv->entries->len);
+  AccountsSnapshot *old;
+  guint i;
+
+  for (i = 0; i < priv->entries->len; i++)
+  {
+    AccountsModelEntry *entry = g_ptr_array_index(priv->entries, i);
+
+    g_ptr_array_add(records, accounts_record_ref(entry->record));
+  }
+
+  old = g_atomic_pointer_get(&priv->snapshot);
+  g_atomic_pointer_set(&priv->snapshot,
+                       _accounts_snapshot_new(records, priv->sequence));
+
+  if (old)
+    priv->retired = g_slist_prepend(priv->retired, old);
+
+  reclaim_snapshots(model);
+}
+
+static void
+item_update_free(AccountsItemUpdate *update)
+{
+  g_object_unref(update->item);
+  g_ptr_array_free(update->pspecs, TRUE);
+  g_slice_free(AccountsItemUpdate, update);
+}
+
+static gboolean
+flush_updates_timeout(gpointer user_data)
+{
+  AccountsModel *model = user_data;
+
+  PRIVATE(model)->coalesce_id = 0;
+  accounts_model_flush_updates(model);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+queue_update(AccountsModel *model, AccountItem *item, guint n_pspecs,
+             GParamSpec **pspecs)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  AccountsItemUpdate *update = g_hash_table_lookup(priv->pending, item);
+  guint i;
+
+  if (!update)
+  {
+    update = g_slice_new(AccountsItemUpdate);
+    update->item = g_object_ref(item);
+    update->pspecs = g_ptr_array_new();
+    g_hash_table_insert(priv->pending, item, update);
+    g_ptr_array_add(priv->pending_order, update);
+  }
+
+  for (i = 0; i < n_pspecs; i++)
+  {
+    guint j;
+
+    for (j = 0; j < update->pspecs->len; j++)
+    {
+      if (g_ptr_array_index(update->pspecs, j) == pspecs[i])
+        break;
+    }
+
+    if (j == update->pspecs->len)
+      g_ptr_array_add(update->pspecs, pspecs[i]);
+  }
+
+  if (!priv->coalesce_id)
+  {
+    priv->coalesce_id = g_timeout_add(priv->coalesce_interval,
+                                      flush_updates_timeout, model);
+  }
+}
+
+static void
+drop_update(AccountsModel *model, AccountItem *item)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  AccountsItemUpdate *update = g_hash_table_lookup(priv->pending, item);
+
+  if (update)
+  {
+    g_hash_table_remove(priv->pending, item);
+    /* frees the update */
+    g_ptr_array_remove(priv->pending_order, update);
+  }
+}
+
+static AccountsStateFlags
+item_get_state(AccountItem *item)
+{
+  AccountsStateFlags state = 0;
+
+  if (item->enabled)
+    state |= ACCOUNTS_STATE_ENABLED;
+
+  if (item->connected)
+    state |= ACCOUNTS_STATE_CONNECTED;
+
+  if (item->draft)
+    state |= ACCOUNTS_STATE_DRAFT;
+
+  return state;
+}
+
+static void
+index_insert(GHashTable *index, gconstpointer key, AccountsModelEntry *entry)
+{
+  GHashTable *set;
+
+  if (!key)
+    return;
+
+  set = g_hash_table_lookup(index, key);
+
+  if (!set)
+  {
+    set = g_hash_table_new(NULL, NULL);
+    g_hash_table_insert(index, (gpointer)key, set);
+  }
+
+  g_hash_table_add(set, entry);
+}
+
+static void
+index_remove(GHashTable *index, gconstpointer key, AccountsModelEntry *entry)
+{
+  GHashTable *set;
+
+  if (!key)
+    return;
+
+  set = g_hash_table_lookup(index, key);
+
+  if (set && g_hash_table_remove(set, entry) && !g_hash_table_size(set))
+    g_hash_table_remove(index, key);
+}
+
+static void
+index_state(AccountsModelPrivate *priv, AccountsModelEntry *entry,
+            AccountsStateFlags state)
+{
+  guint i;
+
+  for (i = 0; i < N_STATES; i++)
+  {
+    AccountsStateFlags flag = 1 << i;
+
+    if ((entry->state & flag) && !(state & flag))
+      g_hash_table_remove(priv->by_state[i], entry);
+    else if (!(entry->state & flag) && (state & flag))
+      g_hash_table_add(priv->by_state[i], entry);
+  }
+
+  entry->state = state;
+}
+
+static gboolean
+entry_matches(AccountsModelEntry *entry, const gchar *service,
+              const gchar *plugin, AccountsStateFlags required,
+              AccountsStateFlags rejected)
+{
+  if (service && entry->service != service)
+    return FALSE;
+
+  if (plugin && entry->plugin != plugin)
+    return FALSE;
+
+  return (entry->state & required) == required && !(entry->state & rejected);
+}
+
+static void
+on_item_properties_changed(AccountItem *item, guint n_pspecs,
+                           GParamSpec **pspecs, AccountsModel *model)
+{
+  AccountsModelEntry *entry = g_hash_table_lookup(PRIVATE(model)->by_item,
+                                                  item);
+  guint i;
+
+  if (!entry)
+    return;
+
+  index_state(PRIVATE(model), entry, item_get_state(item));
+
+  accounts_record_unref(entry->record);
+  entry->record = _accounts_record_new(item, entry->id);
+
+  /* property names are interned by GParamSpec */
+  for (i = 0; i < n_pspecs; i++)
+    log_change(model, ACCOUNTS_CHANGE_PROPERTY, entry->id, pspecs[i]->name);
+
+  publish_snapshot(model);
+
+  g_signal_emit(model, signals[ITEM_CHANGED], 0, item, n_pspecs, pspecs);
+
+  if (PRIVATE(model)->coalesce_interval)
+    queue_update(model, item, n_pspecs, pspecs);
+}
+
+static void
+entry_free(AccountsModelEntry *entry)
+{
+  accounts_record_unref(entry->record);
+  g_object_unref(entry->item);
+  g_slice_free(AccountsModelEntry, entry);
+}
+
+static void
+model_add(AccountsModel *model, AccountItem *item)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  AccountsModelEntry *entry;
+  AccountPlugin *plugin;
+
+  g_return_if_fail(ACCOUNT_IS_ITEM(item));
+
+  if (g_hash_table_contains(priv->by_item, item))
+    return;
+
+  entry = g_slice_new(AccountsModelEntry);
+  entry->item = g_object_ref(item);
+  entry->id = ++priv->last_id;
+  entry->record = _accounts_record_new(item, entry->id);
+
+  /* service and plugin are construct-only, only the state can change */
+  entry->service = item->service ?
+    g_intern_string(account_service_get_name(item->service)) : NULL;
+  plugin = account_item_get_plugin(item);
+  entry->plugin = plugin ? g_intern_string(account_plugin_get_name(plugin)) :
+                           NULL;
+  entry->state = 0;
+
+  g_ptr_array_add(priv->entries, entry);
+  g_hash_table_insert(priv->by_item, item, entry);
+  index_insert(priv->by_service, entry->service, entry);
+  index_insert(priv->by_plugin, entry->plugin, entry);
+  index_state(priv, entry, item_get_state(item));
+
+  g_signal_connect(item, "properties-changed",
+                   G_CALLBACK(on_item_properties_changed), model);
+
+  log_change(model, ACCOUNTS_CHANGE_ADDED, entry->id, NULL);
+  publish_snapshot(model);
+
+  g_signal_emit(model, signals[ITEM_ADDED], 0, item);
+}
+
+static void
+model_remove(AccountsModel *model, AccountItem *item)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  AccountsModelEntry *entry = g_hash_table_lookup(priv->by_item, item);
+
+  if (!entry)
+    return;
+
+  g_object_ref(item);
+
+  g_signal_handlers_disconnect_matched(
+    item, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
+    on_item_properties_changed, model);
+  drop_update(model, item);
+  index_remove(priv->by_service, entry->service, entry);
+  index_remove(priv->by_plugin, entry->plugin, entry);
+  index_state(priv, entry, 0);
+  g_hash_table_remove(priv->by_item, item);
+  g_ptr_array_remove(priv->entries, entry);
+  log_change(model, ACCOUNTS_CHANGE_REMOVED, entry->id, NULL);
+  entry_free(entry);
+
+  publish_snapshot(model);
+
+  g_signal_emit(model, signals[ITEM_REMOVED], 0, item);
+  g_object_unref(item);
+}
+
+static void
+on_item_added(AccountsList *accounts_list, AccountItem *item,
+              AccountsModel *model)
+{
+  model_add(model, item);
+}
+
+static void
+on_item_removed(AccountsList *accounts_list, AccountItem *item,
+                AccountsModel *model)
+{
+  model_remove(model, item);
+}
+
+static void
+accounts_model_constructed(GObject *object)
+{
+  AccountsModelPrivate *priv = PRIVATE(object);
+  GList *items;
+  GList *l;
+
+  G_OBJECT_CLASS(accounts_model_parent_class)->constructed(object);
+
+  priv->change_log = g_new0(AccountsChange, priv->change_log_size);
+
+  if (!priv->accounts_list)
+    return;
+
+  g_signal_connect(priv->accounts_list, "add-item",
+                   G_CALLBACK(on_item_added), object);
+  g_signal_connect(priv->accounts_list, "remove-item",
+                   G_CALLBACK(on_item_removed), object);
+
+  items = accounts_list_get_all(priv->accounts_list);
+
+  for (l = items; l; l = l->next)
+    model_add(ACCOUNTS_MODEL(object), l->data);
+
+  g_list_free_full(items, g_object_unref);
+}
+
+static void
+accounts_model_dispose(GObject *object)
+{
+  AccountsModelPrivate *priv = PRIVATE(object);
+  guint i;
+
+  if (priv->accounts_list)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->accounts_list, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->accounts_list);
+    priv->accounts_list = NULL;
+  }
+
+  for (i = 0; i < priv->entries->len; i++)
+  {
+    AccountsModelEntry *entry = g_ptr_array_index(priv->entries, i);
+
+    g_signal_handlers_disconnect_matched(
+      entry->item, G_SIGNAL_MATCH_DATA | G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
+      on_item_properties_changed, object);
+    entry_free(entry);
+  }
+
+  g_ptr_array_set_size(priv->entries, 0);
+  g_hash_table_remove_all(priv->by_item);
+  g_hash_table_remove_all(priv->by_service);
+  g_hash_table_remove_all(priv->by_plugin);
+
+  for (i = 0; i < N_STATES; i++)
+    g_hash_table_remove_all(priv->by_state[i]);
+
+  if (priv->reclaim_id)
+  {
+    g_source_remove(priv->reclaim_id);
+    priv->reclaim_id = 0;
+  }
+
+  if (priv->coalesce_id)
+  {
+    g_source_remove(priv->coalesce_id);
+    priv->coalesce_id = 0;
+  }
+
+  g_hash_table_remove_all(priv->pending);
+  g_ptr_array_set_size(priv->pending_order, 0);
+
+  G_OBJECT_CLASS(accounts_model_parent_class)->dispose(object);
+}
+
+static void
+accounts_model_finalize(GObject *object)
+{
+  AccountsModelPrivate *priv = PRIVATE(object);
+  guint i;
+
+  g_slist_free_full(priv->retired, (GDestroyNotify)accounts_snapshot_unref);
+  accounts_snapshot_unref(priv->snapshot);
+  g_ptr_array_free(priv->entries, TRUE);
+  g_hash_table_destroy(priv->by_item);
+  g_hash_table_destroy(priv->by_service);
+  g_hash_table_destroy(priv->by_plugin);
+
+  for (i = 0; i < N_STATES; i++)
+    g_hash_table_destroy(priv->by_state[i]);
+
+  g_free(priv->change_log);
+  g_hash_table_destroy(priv->pending);
+  g_ptr_array_free(priv->pending_order, TRUE);
+
+  G_OBJECT_CLASS(accounts_model_parent_class)->finalize(object);
+}
+
+static void
+accounts_model_set_property(GObject *object, guint property_id,
+                            const GValue *value, GParamSpec *pspec)
+{
+  AccountsModelPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_MODEL(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_ACCOUNTS_LIST:
+    {
+      priv->accounts_list = g_value_dup_object(value);
+      break;
+    }
+    case PROP_CHANGE_LOG_SIZE:
+    {
+      priv->change_log_size = g_value_get_uint(value);
+      break;
+    }
+    case PROP_COALESCE_INTERVAL:
+    {
+      accounts_model_set_coalesce_interval(ACCOUNTS_MODEL(object),
+                                           g_value_get_uint(value));
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_model_get_property(GObject *object, guint property_id,
+                            GValue *value, GParamSpec *pspec)
+{
+  AccountsModelPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_MODEL(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_ACCOUNTS_LIST:
+    {
+      g_value_set_object(value, priv->accounts_list);
+      break;
+    }
+    case PROP_CHANGE_LOG_SIZE:
+    {
+      g_value_set_uint(value, priv->change_log_size);
+      break;
+    }
+    case PROP_COALESCE_INTERVAL:
+    {
+      g_value_set_uint(value, priv->coalesce_interval);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_model_class_init(AccountsModelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_model_constructed;
+  object_class->dispose = accounts_model_dispose;
+  object_class->finalize = accounts_model_finalize;
+  object_class->set_property = accounts_model_set_property;
+  object_class->get_property = accounts_model_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_ACCOUNTS_LIST,
+    g_param_spec_object(
+      "accounts-list",
+      "AccountsList",
+      "AccountsList being tracked",
+      ACCOUNTS_TYPE_LIST,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_CHANGE_LOG_SIZE,
+    g_param_spec_uint(
+      "change-log-size",
+      "Change log size",
+      "Number of changes remembered for accounts_model_changes_since()",
+      1, G_MAXUINT, DEFAULT_CHANGE_LOG_SIZE,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_COALESCE_INTERVAL,
+    g_param_spec_uint(
+      "coalesce-interval",
+      "Coalesce interval",
+      "Interval in milliseconds between items-updated emissions, 0 disables",
+      0, G_MAXUINT, 0,
+      G_PARAM_READWRITE));
+
+  signals[ITEM_ADDED] = g_signal_new(
+      "item-added", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsModelClass, item_added), NULL, NULL,
+      g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1, ACCOUNT_TYPE_ITEM);
+  signals[ITEM_REMOVED] = g_signal_new(
+      "item-removed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsModelClass, item_removed), NULL, NULL,
+      g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1, ACCOUNT_TYPE_ITEM);
+  signals[ITEM_CHANGED] = g_signal_new(
+      "item-changed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsModelClass, item_changed), NULL, NULL,
+      account_marshal_VOID__OBJECT_UINT_POINTER, G_TYPE_NONE, 3,
+      ACCOUNT_TYPE_ITEM, G_TYPE_UINT, G_TYPE_POINTER);
+
+  /**
+   * AccountsModel::items-updated:
+   * @model: the #AccountsModel.
+   * @updates:(element-type AccountsItemUpdate): the accounts which changed,
+   * in the order of their first change.
+   *
+   * Emitted at most once every #AccountsModel:coalesce-interval milliseconds
+   * with all the property changes which happened in the meantime.
+   */
+  signals[ITEMS_UPDATED] = g_signal_new(
+      "items-updated", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsModelClass, items_updated), NULL, NULL,
+      g_cclosure_marshal_VOID__BOXED, G_TYPE_NONE, 1,
+      G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE);
+}
+
+static void
+accounts_model_init(AccountsModel *model)
+{
+  AccountsModelPrivate *priv = PRIVATE(model);
+  guint i;
+
+  priv->entries = g_ptr_array_new();
+  priv->by_item = g_hash_table_new(NULL, NULL);
+  priv->by_service = g_hash_table_new_full(
+      NULL, NULL, NULL, (GDestroyNotify)g_hash_table_destroy);
+  priv->by_plugin = g_hash_table_new_full(
+      NULL, NULL, NULL, (GDestroyNotify)g_hash_table_destroy);
+
+  for (i = 0; i < N_STATES; i++)
+    priv->by_state[i] = g_hash_table_new(NULL, NULL);
+
+  priv->pending = g_hash_table_new(NULL, NULL);
+  priv->pending_order = g_ptr_array_new_with_free_func(
+      (GDestroyNotify)item_update_free);
+  priv->snapshot = _accounts_snapshot_new(g_ptr_array_new(), 0);
+}
+
+static AccountsModelEntry *
+lookup_entry(AccountsModelPrivate *priv, guint id)
+{
+  guint low = 0;
+  guint high = priv->entries->len;
+
+  while (low < high)
+  {
+    guint mid = low + (high - low) / 2;
+    AccountsModelEntry *entry = g_ptr_array_index(priv->entries, mid);
+
+    if (entry->id == id)
+      return entry;
+
+    if (entry->id < id)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return NULL;
+}
+
+/**
+ * accounts_model_new:
+ * @accounts_list: the #AccountsList to track.
+ *
+ * Creates an #AccountsModel following the contents of @accounts_list.
+ *
+ * Returns:(transfer full): a new #AccountsModel.
+ */
+AccountsModel *
+accounts_model_new(AccountsList *accounts_list)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_LIST(accounts_list), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_MODEL,
+                      "accounts-list", accounts_list,
+                      NULL);
+}
+
+/**
+ * accounts_model_get_accounts_list:
+ * @model: the #AccountsModel.
+ *
+ * Gets the #AccountsList tracked by @model.
+ *
+ * Returns:(transfer none): the #AccountsList.
+ */
+AccountsList *
+accounts_model_get_accounts_list(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  return PRIVATE(model)->accounts_list;
+}
+
+/**
+ * accounts_model_list:
+ * @model: the #AccountsModel.
+ *
+ * Lists the accounts known to @model, in the order they were added.
+ *
+ * Returns:(transfer container): a #GList of #AccountItem objects.
+ */
+GList *
+accounts_model_list(AccountsModel *model)
+{
+  AccountsModelPrivate *priv;
+  GList *items = NULL;
+  guint i;
+
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  priv = PRIVATE(model);
+
+  for (i = priv->entries->len; i > 0; i--)
+  {
+    AccountsModelEntry *entry = g_ptr_array_index(priv->entries, i - 1);
+
+    items = g_list_prepend(items, entry->item);
+  }
+
+  return items;
+}
+
+/**
+ * accounts_model_get_n_items:
+ * @model: the #AccountsModel.
+ *
+ * Returns: the number of accounts known to @model.
+ */
+guint
+accounts_model_get_n_items(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), 0);
+
+  return PRIVATE(model)->entries->len;
+}
+
+/**
+ * accounts_model_get_item_id:
+ * @model: the #AccountsModel.
+ * @item: an #AccountItem.
+ *
+ * Gets the identifier @model assigned to @item. Identifiers are never reused
+ * by the same model, and are increasing in the order accounts are added.
+ *
+ * Returns: the identifier of @item, or 0 if @item is not part of @model.
+ */
+guint
+accounts_model_get_item_id(AccountsModel *model, AccountItem *item)
+{
+  AccountsModelEntry *entry;
+
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), 0);
+
+  entry = g_hash_table_lookup(PRIVATE(model)->by_item, item);
+
+  return entry ? entry->id : 0;
+}
+
+/**
+ * accounts_model_lookup:
+ * @model: the #AccountsModel.
+ * @id: an account identifier.
+ *
+ * Finds the account identified by @id.
+ *
+ * Returns:(transfer none)(nullable): the #AccountItem, or %NULL if no such
+ * account is part of @model.
+ */
+AccountItem *
+accounts_model_lookup(AccountsModel *model, guint id)
+{
+  AccountsModelEntry *entry;
+
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  entry = lookup_entry(PRIVATE(model), id);
+
+  return entry ? entry->item : NULL;
+}
+
+static gint
+compare_entry_id(gconstpointer a, gconstpointer b)
+{
+  const AccountsModelEntry *entry_a = a;
+  const AccountsModelEntry *entry_b = b;
+
+  if (entry_a->id == entry_b->id)
+    return 0;
+
+  return entry_a->id < entry_b->id ? -1 : 1;
+}
+
+/**
+ * accounts_model_query:
+ * @model: the #AccountsModel.
+ * @service:(nullable): the name of an #AccountService, or %NULL for any.
+ * @plugin:(nullable): the name of an #AccountPlugin, or %NULL for any.
+ * @required: the state flags the accounts must have.
+ * @rejected: the state flags the accounts must not have.
+ *
+ * Finds the accounts matching all the given conditions, for example all the
+ * enabled accounts of a service which are not connected. The search starts
+ * from the smallest of the indexes involved, so its cost depends on the
+ * number of candidate accounts rather than on the total number of accounts.
+ *
+ * Returns:(transfer container)(element-type AccountItem): the matching
+ * accounts, in the order they were added; free the list with g_list_free().
+ */
+GList *
+accounts_model_query(AccountsModel *model, const gchar *service,
+                     const gchar *plugin, AccountsStateFlags required,
+                     AccountsStateFlags rejected)
+{
+  AccountsModelPrivate *priv;
+  GHashTable *candidates = NULL;
+  GHashTableIter iter;
+  gpointer entry;
+  GList *matches = NULL;
+  GList *l;
+  guint i;
+
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  priv = PRIVATE(model);
+
+  if (required & rejected)
+    return NULL;
+
+  if (service)
+  {
+    /* a service nobody interned has no accounts */
+    if (!(service = _accounts_lookup_interned(service)))
+      return NULL;
+
+    candidates = g_hash_table_lookup(priv->by_service, service);
+
+    if (!candidates)
+      return NULL;
+  }
+
+  if (plugin)
+  {
+    GHashTable *set;
+
+    if (!(plugin = _accounts_lookup_interned(plugin)))
+      return NULL;
+
+    set = g_hash_table_lookup(priv->by_plugin, plugin);
+
+    if (!set)
+      return NULL;
+
+    if (!candidates || g_hash_table_size(set) < g_hash_table_size(candidates))
+      candidates = set;
+  }
+
+  for (i = 0; i < N_STATES; i++)
+  {
+    GHashTable *set = priv->by_state[i];
+
+    if (!(required & (1 << i)))
+      continue;
+
+    if (!candidates || g_hash_table_size(set) < g_hash_table_size(candidates))
+      candidates = set;
+  }
+
+  if (!candidates)
+  {
+    for (i = priv->entries->len; i > 0; i--)
+    {
+      entry = g_ptr_array_index(priv->entries, i - 1);
+
+      if (entry_matches(entry, service, plugin, required, rejected))
+        matches = g_list_prepend(matches, ((AccountsModelEntry *)entry)->item);
+    }
+
+    return matches;
+  }
+
+  g_hash_table_iter_init(&iter, candidates);
+
+  while (g_hash_table_iter_next(&iter, &entry, NULL))
+  {
+    if (entry_matches(entry, service, plugin, required, rejected))
+      matches = g_list_prepend(matches, entry);
+  }
+
+  matches = g_list_sort(matches, compare_entry_id);
+
+  for (l = matches; l; l = l->next)
+    l->data = ((AccountsModelEntry *)l->data)->item;
+
+  return matches;
+}
+
+/* checks a single account against the accounts_model_query() conditions,
+ * service and plugin must be interned */
+gboolean
+_accounts_model_item_matches(AccountsModel *model, AccountItem *item,
+                             const gchar *service, const gchar *plugin,
+                             AccountsStateFlags required,
+                             AccountsStateFlags rejected)
+{
+  AccountsModelEntry *entry = g_hash_table_lookup(PRIVATE(model)->by_item,
+                                                  item);
+
+  if (!entry)
+    return FALSE;
+
+  return entry_matches(entry, service, plugin, required, rejected);
+}
+
+/**
+ * accounts_model_get_snapshot:
+ * @model: the #AccountsModel.
+ *
+ * Gets an immutable copy of the current state of the accounts. This is the
+ * only #AccountsModel method which can be called from any thread; it never
+ * blocks, and the returned snapshot is not affected by later changes. The
+ * caller must keep a reference to @model for the duration of the call.
+ *
+ * Returns:(transfer full): an #AccountsSnapshot; release it with
+ * accounts_snapshot_unref().
+ */
+AccountsSnapshot *
+accounts_model_get_snapshot(AccountsModel *model)
+{
+  AccountsModelPrivate *priv;
+  AccountsSnapshot *snapshot;
+
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  priv = PRIVATE(model);
+
+  g_atomic_int_inc(&priv->readers);
+  snapshot = accounts_snapshot_ref(g_atomic_pointer_get(&priv->snapshot));
+  g_atomic_int_add(&priv->readers, -1);
+
+  return snapshot;
+}
+
+/**
+ * accounts_model_get_sequence:
+ * @model: the #AccountsModel.
+ *
+ * Gets the sequence number of the latest change. Sequence numbers start from
+ * 1 and are increased by one for every change; 0 means that no change has
+ * happened yet.
+ *
+ * Returns: the current change sequence number.
+ */
+guint64
+accounts_model_get_sequence(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), 0);
+
+  return PRIVATE(model)->sequence;
+}
+
+/**
+ * accounts_model_changes_since:
+ * @model: the #AccountsModel.
+ * @sequence: the last sequence number known to the caller.
+ * @changes:(out)(transfer full)(element-type AccountsChange): return location
+ * for a #GArray of #AccountsChange, in the order they happened.
+ *
+ * Gets the changes which happened after @sequence, as previously returned by
+ * accounts_model_get_sequence() or accounts_snapshot_get_sequence(). Only the
+ * last #AccountsModel:change-log-size changes are remembered: if some of the
+ * requested ones have already been discarded, the caller has to resynchronize
+ * by listing all the accounts again, and then use the current sequence number
+ * as its new starting point.
+ *
+ * Returns: %TRUE on success, %FALSE if a full resynchronization is required;
+ * in this case @changes is set to %NULL.
+ */
+gboolean
+accounts_model_changes_since(AccountsModel *model, guint64 sequence,
+                             GArray **changes)
+{
+  AccountsModelPrivate *priv;
+  guint64 oldest;
+  guint64 seq;
+
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), FALSE);
+  g_return_val_if_fail(changes != NULL, FALSE);
+
+  priv = PRIVATE(model);
+  *changes = NULL;
+
+  if (priv->sequence > priv->change_log_size)
+    oldest = priv->sequence - priv->change_log_size + 1;
+  else
+    oldest = 1;
+
+  if (sequence > priv->sequence || sequence + 1 < oldest)
+    return FALSE;
+
+  *changes = g_array_sized_new(FALSE, FALSE, sizeof(AccountsChange),
+                               priv->sequence - sequence);
+
+  for (seq = sequence + 1; seq <= priv->sequence; seq++)
+  {
+    g_array_append_val(
+      *changes, priv->change_log[(seq - 1) % priv->change_log_size]);
+  }
+
+  return TRUE;
+}
+
+/**
+ * accounts_model_set_coalesce_interval:
+ * @model: the #AccountsModel.
+ * @interval: the interval in milliseconds, or 0 to disable coalescing.
+ *
+ * Sets the minimum interval between two #AccountsModel::items-updated
+ * emissions; an interval of 16 milliseconds delivers at most one batch per
+ * frame on a 60Hz display. Disabling the coalescing delivers the pending
+ * changes immediately; otherwise they are delivered @interval milliseconds
+ * after this call.
+ */
+void
+accounts_model_set_coalesce_interval(AccountsModel *model, guint interval)
+{
+  AccountsModelPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_MODEL(model));
+
+  priv = PRIVATE(model);
+
+  if (priv->coalesce_interval == interval)
+    return;
+
+  priv->coalesce_interval = interval;
+
+  if (!interval)
+    accounts_model_flush_updates(model);
+  else if (priv->coalesce_id)
+  {
+    /* the pending changes are delivered after the new interval */
+    g_source_remove(priv->coalesce_id);
+    priv->coalesce_id = g_timeout_add(interval, flush_updates_timeout, model);
+  }
+
+  g_object_notify(G_OBJECT(model), "coalesce-interval");
+}
+
+/**
+ * accounts_model_get_coalesce_interval:
+ * @model: the #AccountsModel.
+ *
+ * Returns: the value of the #AccountsModel:coalesce-interval property.
+ */
+guint
+accounts_model_get_coalesce_interval(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), 0);
+
+  return PRIVATE(model)->coalesce_interval;
+}
+
+/**
+ * accounts_model_flush_updates:
+ * @model: the #AccountsModel.
+ *
+ * Emits #AccountsModel::items-updated right away if there are pending
+ * changes, without waiting for the coalescing interval to expire.
+ */
+void
+accounts_model_flush_updates(AccountsModel *model)
+{
+  AccountsModelPrivate *priv;
+  GPtrArray *updates;
+
+  g_return_if_fail(ACCOUNTS_IS_MODEL(model));
+
+  priv = PRIVATE(model);
+
+  if (priv->coalesce_id)
+  {
+    g_source_remove(priv->coalesce_id);
+    priv->coalesce_id = 0;
+  }
+
+  if (!priv->pending_order->len)
+    return;
+
+  updates = priv->pending_order;
+  priv->pending_order = g_ptr_array_new_with_free_func(
+      (GDestroyNotify)item_update_free);
+  g_hash_table_remove_all(priv->pending);
+
+  g_signal_emit(model, signals[ITEMS_UPDATED], 0, updates);
+  g_ptr_array_free(updates, TRUE);
+}
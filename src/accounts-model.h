@@ -0,0 +1,153 @@
+/*
+ * accounts-model.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_MODEL_H_
+#define _ACCOUNTS_MODEL_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_MODEL             (accounts_model_get_type ())
+#define ACCOUNTS_MODEL(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_MODEL, AccountsModel))
+#define ACCOUNTS_MODEL_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_MODEL, AccountsModelClass))
+#define ACCOUNTS_IS_MODEL(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_MODEL))
+#define ACCOUNTS_IS_MODEL_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_MODEL))
+#define ACCOUNTS_MODEL_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_MODEL, AccountsModelClass))
+
+typedef struct _AccountsModelClass AccountsModelClass;
+typedef struct _AccountsModel AccountsModel;
+
+#include "accounts-list.h"
+#include "accounts-snapshot.h"
+
+/**
+ * AccountsChangeType:
+ * @ACCOUNTS_CHANGE_ADDED: an account has been added.
+ * @ACCOUNTS_CHANGE_REMOVED: an account has been removed.
+ * @ACCOUNTS_CHANGE_PROPERTY: a property of an account has changed.
+ *
+ * The kind of an #AccountsChange.
+ */
+typedef enum
+{
+    ACCOUNTS_CHANGE_ADDED,
+    ACCOUNTS_CHANGE_REMOVED,
+    ACCOUNTS_CHANGE_PROPERTY
+} AccountsChangeType;
+
+/**
+ * AccountsStateFlags:
+ * @ACCOUNTS_STATE_ENABLED: the #AccountItem:enabled property is set.
+ * @ACCOUNTS_STATE_CONNECTED: the #AccountItem:connected property is set.
+ * @ACCOUNTS_STATE_DRAFT: the #AccountItem:draft property is set.
+ *
+ * The state of an account, as used by accounts_model_query().
+ */
+typedef enum
+{
+    ACCOUNTS_STATE_ENABLED = 1 << 0,
+    ACCOUNTS_STATE_CONNECTED = 1 << 1,
+    ACCOUNTS_STATE_DRAFT = 1 << 2
+} AccountsStateFlags;
+
+typedef struct _AccountsChange AccountsChange;
+
+/**
+ * AccountsChange:
+ * @sequence: the sequence number of the change.
+ * @type: the kind of change.
+ * @id: the identifier of the account, see accounts_model_get_item_id().
+ * @property: for %ACCOUNTS_CHANGE_PROPERTY, the interned name of the property
+ * which changed; %NULL otherwise.
+ *
+ * An entry of the #AccountsModel change log.
+ */
+struct _AccountsChange
+{
+    guint64 sequence;
+    AccountsChangeType type;
+    guint id;
+    const gchar *property;
+};
+
+typedef struct _AccountsItemUpdate AccountsItemUpdate;
+
+/**
+ * AccountsItemUpdate:
+ * @item: the #AccountItem which changed.
+ * @pspecs:(element-type GParamSpec): the #GParamSpec of each property which
+ * changed, listed once.
+ *
+ * The changes gathered for an account by the #AccountsModel coalescing, see
+ * #AccountsModel::items-updated.
+ */
+struct _AccountsItemUpdate
+{
+    AccountItem *item;
+    GPtrArray *pspecs;
+};
+
+struct _AccountsModelClass
+{
+    GObjectClass parent_class;
+
+    /* signals */
+    void (*item_added) (AccountsModel *model, AccountItem *item);
+    void (*item_removed) (AccountsModel *model, AccountItem *item);
+    void (*item_changed) (AccountsModel *model, AccountItem *item,
+                          guint n_pspecs, GParamSpec **pspecs);
+    void (*items_updated) (AccountsModel *model, GPtrArray *updates);
+};
+
+struct _AccountsModel
+{
+    GObject parent_instance;
+};
+
+GType accounts_model_get_type (void) G_GNUC_CONST;
+
+AccountsModel *accounts_model_new (AccountsList *accounts_list);
+
+AccountsList *accounts_model_get_accounts_list (AccountsModel *model);
+
+GList *accounts_model_list (AccountsModel *model);
+guint accounts_model_get_n_items (AccountsModel *model);
+
+guint accounts_model_get_item_id (AccountsModel *model, AccountItem *item);
+AccountItem *accounts_model_lookup (AccountsModel *model, guint id);
+
+GList *accounts_model_query (AccountsModel *model, const gchar *service,
+                            const gchar *plugin, AccountsStateFlags required,
+                            AccountsStateFlags rejected);
+
+AccountsSnapshot *accounts_model_get_snapshot (AccountsModel *model);
+
+guint64 accounts_model_get_sequence (AccountsModel *model);
+gboolean accounts_model_changes_since (AccountsModel *model, guint64 sequence,
+                                       GArray **changes);
+
+void accounts_model_set_coalesce_interval (AccountsModel *model,
+                                           guint interval);
+guint accounts_model_get_coalesce_interval (AccountsModel *model);
+void accounts_model_flush_updates (AccountsModel *model);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_MODEL_H_ */
@@ -0,0 +1,90 @@
+/*
+ * accounts-private.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Internal helpers shared between the library modules; not installed. */
+
+#ifndef _ACCOUNTS_PRIVATE_H_
+#define _ACCOUNTS_PRIVATE_H_
+
+#include "account-item.h"
+#include "accounts-model.h"
+#include "accounts-snapshot.h"
+
+G_BEGIN_DECLS
+
+/* NULL-safe wrappers for the GRefString API, used for the strings which are
+ * repeated across many objects, such as service names */
+static inline gchar *
+_accounts_ref_string_intern(const gchar *str)
+{
+  return str ? g_ref_string_new_intern(str) : NULL;
+}
+
+static inline gchar *
+_accounts_ref_string_acquire(gchar *str)
+{
+  return str ? g_ref_string_acquire(str) : NULL;
+}
+
+static inline void
+_accounts_ref_string_release(gchar *str)
+{
+  if (str)
+    g_ref_string_release(str);
+}
+
+/* the interned copy of @str, or NULL if it was never interned, for looking
+ * up interned keys with strings which must not grow the intern table */
+static inline const gchar *
+_accounts_lookup_interned(const gchar *str)
+{
+  GQuark quark = g_quark_try_string(str);
+
+  return quark ? g_quark_to_string(quark) : NULL;
+}
+
+G_GNUC_INTERNAL
+gchar *_account_service_dup_name_ref (AccountService *service);
+
+G_GNUC_INTERNAL
+gchar *_account_service_dup_display_name_ref (AccountService *service);
+
+G_GNUC_INTERNAL
+AccountsRecord *_accounts_record_new (AccountItem *item, guint id);
+
+G_GNUC_INTERNAL
+AccountsSnapshot *_accounts_snapshot_new (GPtrArray *records,
+                                          guint64 sequence);
+
+G_GNUC_INTERNAL
+gboolean _accounts_model_item_matches (AccountsModel *model,
+                                       AccountItem *item,
+                                       const gchar *service,
+                                       const gchar *plugin,
+                                       AccountsStateFlags required,
+                                       AccountsStateFlags rejected);
+
+/* drops the outcomes cached for the account of an AccountEditContext in the
+ * default AccountsVerificationCache, if there is one */
+G_GNUC_INTERNAL
+void _accounts_verification_cache_invalidate_edited (gpointer context);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_PRIVATE_H_ */
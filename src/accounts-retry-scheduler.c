@@ -0,0 +1,795 @@
+/*
+ * accounts-retry-scheduler.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-retry-scheduler
+ * @short_description: shared scheduler for retrying account operations.
+ *
+ * Plugins which need to retry an operation that failed, such as connecting
+ * an account, submit it to an #AccountsRetryScheduler instead of retrying on
+ * their own, usually to the one returned by
+ * accounts_retry_scheduler_get_default(). Sharing the scheduler avoids the
+ * spike of activity caused by all the plugins retrying at the same time, for
+ * example when the network comes back:
+ *
+ * - after each failed attempt, the operation waits for a random delay
+ *   between 0 and #AccountsRetryScheduler:base-delay doubled at each failure,
+ *   up to #AccountsRetryScheduler:max-delay ("full jitter" exponential
+ *   backoff). Failures are counted per account until an attempt succeeds, so
+ *   that a new operation for an account which keeps failing doesn't start
+ *   over from the base delay;
+ * - at most #AccountsRetryScheduler:max-parallel attempts run at the same
+ *   time, across all accounts;
+ * - no attempt is started while #AccountsRetryScheduler:network-available is
+ *   %FALSE. When the network becomes available again, the backoff of the
+ *   waiting operations is reset, and they are spread over a random delay of
+ *   up to #AccountsRetryScheduler:base-delay.
+ *
+ * #AccountsRetryScheduler:network-available follows the #GNetworkMonitor
+ * given at construction, if any, but it can also be set by hand.
+ *
+ * Only failures which may go away by themselves are retried: the
+ * %ACCOUNT_ERROR_CONNECTION_FAILED and %ACCOUNT_ERROR_AUTHENTICATION_FAILED
+ * errors and network related #GIOErrorEnum errors. The operation completes
+ * with any other error, or with the last one after
+ * #AccountsRetryScheduler:max-attempts attempts.
+ *
+ * An #AccountsRetryScheduler must only be used, and its operations
+ * cancelled, from the main thread.
+ */
+
+#include "config.h"
+
+#include "account-error.h"
+#include "accounts-retry-scheduler.h"
+
+typedef struct _RetryOperation
+{
+  AccountsRetryScheduler *scheduler;
+  AccountItem *item;
+  AccountsRetryFunc func;
+  gpointer func_data;
+  GDestroyNotify func_data_destroy;
+  GTask *task;
+  gulong cancelled_id;
+
+  guint n_attempts;
+  /* while waiting for the next attempt */
+  guint timeout_id;
+  /* while an attempt runs */
+  GCancellable *cancellable;
+} RetryOperation;
+
+struct _AccountsRetrySchedulerPrivate
+{
+  GNetworkMonitor *monitor;
+  gboolean network_available;
+
+  guint max_parallel;
+  guint max_attempts;
+  guint base_delay;
+  guint max_delay;
+
+  /* RetryOperation, due for an attempt */
+  GQueue ready;
+  /* RetryOperation, waiting for their delay to elapse */
+  GHashTable *waiting;
+  /* AccountItem -> doublings of the delay, until an attempt succeeds or the
+   * network comes back */
+  GHashTable *backoff;
+  guint running;
+
+  guint dispatch_id;
+};
+
+typedef struct _AccountsRetrySchedulerPrivate AccountsRetrySchedulerPrivate;
+
+#define PRIVATE(scheduler) \
+  ((AccountsRetrySchedulerPrivate *) \
+   accounts_retry_scheduler_get_instance_private( \
+     (AccountsRetryScheduler *)(scheduler)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsRetryScheduler,
+  accounts_retry_scheduler,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_NETWORK_MONITOR = 1,
+  PROP_NETWORK_AVAILABLE,
+  PROP_MAX_PARALLEL,
+  PROP_MAX_ATTEMPTS,
+  PROP_BASE_DELAY,
+  PROP_MAX_DELAY
+};
+
+static gboolean
+error_is_retryable(const GError *error)
+{
+  if (error->domain == ACCOUNT_ERROR)
+  {
+    return error->code == ACCOUNT_ERROR_CONNECTION_FAILED ||
+           error->code == ACCOUNT_ERROR_AUTHENTICATION_FAILED;
+  }
+
+  if (error->domain == G_IO_ERROR)
+  {
+    return error->code == G_IO_ERROR_TIMED_OUT ||
+           error->code == G_IO_ERROR_NETWORK_UNREACHABLE ||
+           error->code == G_IO_ERROR_HOST_UNREACHABLE ||
+           error->code == G_IO_ERROR_CONNECTION_REFUSED;
+  }
+
+  return FALSE;
+}
+
+static gboolean
+operation_cancelled(RetryOperation *op)
+{
+  return g_cancellable_is_cancelled(g_task_get_cancellable(op->task));
+}
+
+static GError *
+cancelled_error(void)
+{
+  return g_error_new(G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                     "Operation was cancelled");
+}
+
+static void dispatch(AccountsRetryScheduler *scheduler);
+
+static gboolean
+dispatch_cb(gpointer user_data)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(user_data);
+
+  priv->dispatch_id = 0;
+  dispatch(user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_dispatch(AccountsRetryScheduler *scheduler)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(scheduler);
+
+  if (!priv->dispatch_id)
+    priv->dispatch_id = g_idle_add(dispatch_cb, scheduler);
+}
+
+static void
+operation_free(RetryOperation *op)
+{
+  g_object_unref(op->item);
+
+  if (op->func_data_destroy)
+    op->func_data_destroy(op->func_data);
+
+  g_slice_free(RetryOperation, op);
+}
+
+/* takes @error, drops the scheduler reference to the task */
+static void
+operation_complete(RetryOperation *op, GError *error)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(op->scheduler);
+
+  if (op->timeout_id)
+  {
+    g_source_remove(op->timeout_id);
+    op->timeout_id = 0;
+    g_hash_table_remove(priv->waiting, op);
+  }
+
+  if (op->cancelled_id)
+  {
+    g_cancellable_disconnect(g_task_get_cancellable(op->task),
+                             op->cancelled_id);
+    op->cancelled_id = 0;
+  }
+
+  if (error)
+    g_task_return_error(op->task, error);
+  else
+    g_task_return_boolean(op->task, TRUE);
+
+  g_object_unref(op->task);
+}
+
+static gboolean
+operation_timeout(gpointer user_data)
+{
+  RetryOperation *op = user_data;
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(op->scheduler);
+
+  op->timeout_id = 0;
+  g_hash_table_remove(priv->waiting, op);
+  g_queue_push_tail(&priv->ready, op);
+  schedule_dispatch(op->scheduler);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* full jitter: a random delay up to the backoff ceiling */
+static void
+operation_wait(RetryOperation *op)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(op->scheduler);
+  guint backoff = GPOINTER_TO_UINT(g_hash_table_lookup(priv->backoff,
+                                                       op->item));
+  guint64 ceiling = (guint64)priv->base_delay << backoff;
+
+  if (priv->max_delay && ceiling > priv->max_delay)
+    ceiling = priv->max_delay;
+
+  ceiling = MIN(ceiling, G_MAXINT32 - 1);
+
+  op->timeout_id = g_timeout_add(g_random_int_range(0, (gint32)ceiling + 1),
+                                 operation_timeout, op);
+  g_hash_table_add(priv->waiting, op);
+}
+
+static void
+increase_backoff(AccountsRetrySchedulerPrivate *priv, AccountItem *item)
+{
+  guint backoff = GPOINTER_TO_UINT(g_hash_table_lookup(priv->backoff, item));
+
+  g_hash_table_insert(priv->backoff, g_object_ref(item),
+                      GUINT_TO_POINTER(MIN(backoff + 1, 31)));
+}
+
+static void
+attempt_done(GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+  RetryOperation *op = user_data;
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(op->scheduler);
+  GError *error = NULL;
+
+  priv->running--;
+  g_clear_object(&op->cancellable);
+  schedule_dispatch(op->scheduler);
+
+  if (g_task_propagate_boolean(G_TASK(result), &error))
+  {
+    g_hash_table_remove(priv->backoff, op->item);
+    operation_complete(op, NULL);
+  }
+  else if (operation_cancelled(op))
+  {
+    g_error_free(error);
+    operation_complete(op, cancelled_error());
+  }
+  else if (error_is_retryable(error) &&
+           (!priv->max_attempts || op->n_attempts < priv->max_attempts))
+  {
+    g_debug("Attempt %u for account `%s' failed, retrying: %s",
+            op->n_attempts, op->item->name, error->message);
+    g_error_free(error);
+
+    operation_wait(op);
+    increase_backoff(priv, op->item);
+  }
+  else
+    operation_complete(op, error);
+}
+
+static void
+operation_attempt(RetryOperation *op)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(op->scheduler);
+  GTask *attempt;
+
+  priv->running++;
+  op->n_attempts++;
+  op->cancellable = g_cancellable_new();
+
+  attempt = g_task_new(op->item, op->cancellable, attempt_done, op);
+  op->func(op->item, attempt, op->func_data);
+}
+
+static void
+on_cancelled(GCancellable *cancellable, RetryOperation *op)
+{
+  /* the other operations are completed from the dispatcher, as disconnecting
+   * is not possible from here */
+  if (op->cancellable)
+    g_cancellable_cancel(op->cancellable);
+  else
+    schedule_dispatch(op->scheduler);
+}
+
+static void
+dispatch(AccountsRetryScheduler *scheduler)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(scheduler);
+  GList *cancelled = NULL;
+  GHashTableIter iter;
+  gpointer op;
+  GList *l;
+
+  /* fail the cancelled operations */
+  for (l = priv->ready.head; l; )
+  {
+    GList *next = l->next;
+
+    if (operation_cancelled(l->data))
+    {
+      cancelled = g_list_prepend(cancelled, l->data);
+      g_queue_delete_link(&priv->ready, l);
+    }
+
+    l = next;
+  }
+
+  g_hash_table_iter_init(&iter, priv->waiting);
+
+  while (g_hash_table_iter_next(&iter, &op, NULL))
+  {
+    if (operation_cancelled(op))
+      cancelled = g_list_prepend(cancelled, op);
+  }
+
+  while (!g_queue_is_empty(&priv->ready) && priv->network_available &&
+         (!priv->max_parallel || priv->running < priv->max_parallel))
+  {
+    operation_attempt(g_queue_pop_head(&priv->ready));
+  }
+
+  /* after the queue is handled, as the callbacks may submit new operations */
+  for (l = cancelled; l; l = l->next)
+    operation_complete(l->data, cancelled_error());
+
+  g_list_free(cancelled);
+}
+
+static void
+network_restored(AccountsRetryScheduler *scheduler)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(scheduler);
+  GList *waiting = g_hash_table_get_keys(priv->waiting);
+  GList *l;
+
+  /* the failures were likely caused by the network being down, start over,
+   * spread over a base delay */
+  g_hash_table_remove_all(priv->backoff);
+
+  for (l = waiting; l; l = l->next)
+  {
+    RetryOperation *op = l->data;
+
+    g_source_remove(op->timeout_id);
+    g_hash_table_remove(priv->waiting, op);
+    operation_wait(op);
+  }
+
+  g_list_free(waiting);
+  schedule_dispatch(scheduler);
+}
+
+static void
+on_network_changed(GNetworkMonitor *monitor, gboolean available,
+                   AccountsRetryScheduler *scheduler)
+{
+  accounts_retry_scheduler_set_network_available(scheduler, available);
+}
+
+static void
+accounts_retry_scheduler_constructed(GObject *object)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(object);
+
+  G_OBJECT_CLASS(accounts_retry_scheduler_parent_class)->constructed(object);
+
+  if (priv->monitor)
+  {
+    priv->network_available =
+      g_network_monitor_get_network_available(priv->monitor);
+    g_signal_connect(priv->monitor, "network-changed",
+                     G_CALLBACK(on_network_changed), object);
+  }
+}
+
+static void
+accounts_retry_scheduler_dispose(GObject *object)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(object);
+
+  if (priv->monitor)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->monitor, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->monitor);
+    priv->monitor = NULL;
+  }
+
+  if (priv->dispatch_id)
+  {
+    g_source_remove(priv->dispatch_id);
+    priv->dispatch_id = 0;
+  }
+
+  G_OBJECT_CLASS(accounts_retry_scheduler_parent_class)->dispose(object);
+}
+
+static void
+accounts_retry_scheduler_finalize(GObject *object)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(object);
+
+  g_hash_table_destroy(priv->waiting);
+  g_hash_table_destroy(priv->backoff);
+
+  G_OBJECT_CLASS(accounts_retry_scheduler_parent_class)->finalize(object);
+}
+
+static void
+accounts_retry_scheduler_set_property(GObject *object, guint property_id,
+                                      const GValue *value, GParamSpec *pspec)
+{
+  AccountsRetrySchedulerPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_RETRY_SCHEDULER(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_NETWORK_MONITOR:
+    {
+      priv->monitor = g_value_dup_object(value);
+      break;
+    }
+    case PROP_NETWORK_AVAILABLE:
+    {
+      accounts_retry_scheduler_set_network_available(
+        ACCOUNTS_RETRY_SCHEDULER(object), g_value_get_boolean(value));
+      break;
+    }
+    case PROP_MAX_PARALLEL:
+    {
+      priv->max_parallel = g_value_get_uint(value);
+
+      if (!g_queue_is_empty(&priv->ready))
+        schedule_dispatch(ACCOUNTS_RETRY_SCHEDULER(object));
+
+      break;
+    }
+    case PROP_MAX_ATTEMPTS:
+    {
+      priv->max_attempts = g_value_get_uint(value);
+      break;
+    }
+    case PROP_BASE_DELAY:
+    {
+      priv->base_delay = g_value_get_uint(value);
+      break;
+    }
+    case PROP_MAX_DELAY:
+    {
+      priv->max_delay = g_value_get_uint(value);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_retry_scheduler_get_property(GObject *object, guint property_id,
+                                      GValue *value, GParamSpec *pspec)
+{
+  AccountsRetrySchedulerPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_RETRY_SCHEDULER(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_NETWORK_MONITOR:
+    {
+      g_value_set_object(value, priv->monitor);
+      break;
+    }
+    case PROP_NETWORK_AVAILABLE:
+    {
+      g_value_set_boolean(value, priv->network_available);
+      break;
+    }
+    case PROP_MAX_PARALLEL:
+    {
+      g_value_set_uint(value, priv->max_parallel);
+      break;
+    }
+    case PROP_MAX_ATTEMPTS:
+    {
+      g_value_set_uint(value, priv->max_attempts);
+      break;
+    }
+    case PROP_BASE_DELAY:
+    {
+      g_value_set_uint(value, priv->base_delay);
+      break;
+    }
+    case PROP_MAX_DELAY:
+    {
+      g_value_set_uint(value, priv->max_delay);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_retry_scheduler_class_init(AccountsRetrySchedulerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_retry_scheduler_constructed;
+  object_class->dispose = accounts_retry_scheduler_dispose;
+  object_class->finalize = accounts_retry_scheduler_finalize;
+  object_class->set_property = accounts_retry_scheduler_set_property;
+  object_class->get_property = accounts_retry_scheduler_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_NETWORK_MONITOR,
+    g_param_spec_object(
+      "network-monitor",
+      "Network monitor",
+      "GNetworkMonitor followed by network-available",
+      G_TYPE_NETWORK_MONITOR,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_NETWORK_AVAILABLE,
+    g_param_spec_boolean(
+      "network-available",
+      "Network available",
+      "Whether attempts can be started",
+      TRUE,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY));
+  g_object_class_install_property(
+    object_class, PROP_MAX_PARALLEL,
+    g_param_spec_uint(
+      "max-parallel",
+      "Maximum parallel",
+      "Maximum number of attempts running at the same time, 0 for no limit",
+      0, G_MAXUINT, 2,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_MAX_ATTEMPTS,
+    g_param_spec_uint(
+      "max-attempts",
+      "Maximum attempts",
+      "Maximum number of attempts of an operation, 0 for no limit",
+      0, G_MAXUINT, 0,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_BASE_DELAY,
+    g_param_spec_uint(
+      "base-delay",
+      "Base delay",
+      "Delay ceiling after the first failure, in milliseconds",
+      0, G_MAXUINT, 1000,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_MAX_DELAY,
+    g_param_spec_uint(
+      "max-delay",
+      "Maximum delay",
+      "Maximum delay between attempts, in milliseconds, 0 for no limit",
+      0, G_MAXUINT, 300000,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+}
+
+static void
+accounts_retry_scheduler_init(AccountsRetryScheduler *scheduler)
+{
+  AccountsRetrySchedulerPrivate *priv = PRIVATE(scheduler);
+
+  priv->network_available = TRUE;
+  g_queue_init(&priv->ready);
+  priv->waiting = g_hash_table_new(NULL, NULL);
+  priv->backoff = g_hash_table_new_full(NULL, NULL, g_object_unref, NULL);
+}
+
+/**
+ * accounts_retry_scheduler_new:
+ * @monitor:(nullable): the #GNetworkMonitor to follow, or %NULL.
+ *
+ * Creates an #AccountsRetryScheduler.
+ *
+ * Returns:(transfer full): a new #AccountsRetryScheduler.
+ */
+AccountsRetryScheduler *
+accounts_retry_scheduler_new(GNetworkMonitor *monitor)
+{
+  g_return_val_if_fail(!monitor || G_IS_NETWORK_MONITOR(monitor), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_RETRY_SCHEDULER,
+                      "network-monitor", monitor,
+                      NULL);
+}
+
+/**
+ * accounts_retry_scheduler_get_default:
+ *
+ * Gets the scheduler shared by the plugins of the process, which follows the
+ * default #GNetworkMonitor.
+ *
+ * Returns:(transfer none): the default #AccountsRetryScheduler.
+ */
+AccountsRetryScheduler *
+accounts_retry_scheduler_get_default(void)
+{
+  static AccountsRetryScheduler *scheduler = NULL;
+
+  if (!scheduler)
+  {
+    scheduler = accounts_retry_scheduler_new(
+        g_network_monitor_get_default());
+  }
+
+  return scheduler;
+}
+
+/**
+ * accounts_retry_scheduler_submit_async:
+ * @scheduler: the #AccountsRetryScheduler.
+ * @item: the #AccountItem the operation is for.
+ * @func:(scope notified): the #AccountsRetryFunc making an attempt.
+ * @func_data: the data to pass to @func.
+ * @func_data_destroy:(nullable): the function to free @func_data with, or
+ * %NULL.
+ * @cancellable:(nullable): a #GCancellable, or %NULL.
+ * @callback: a #GAsyncReadyCallback to call when the operation completed.
+ * @user_data: the data to pass to @callback.
+ *
+ * Submits an operation which @func attempts, until it succeeds, it fails with
+ * an error which is not worth retrying, or @scheduler gives up. The first
+ * attempt is made as soon as the network and the concurrency limit allow it.
+ * Call accounts_retry_scheduler_submit_finish() from @callback to get the
+ * result.
+ */
+void
+accounts_retry_scheduler_submit_async(AccountsRetryScheduler *scheduler,
+                                      AccountItem *item,
+                                      AccountsRetryFunc func,
+                                      gpointer func_data,
+                                      GDestroyNotify func_data_destroy,
+                                      GCancellable *cancellable,
+                                      GAsyncReadyCallback callback,
+                                      gpointer user_data)
+{
+  AccountsRetrySchedulerPrivate *priv;
+  RetryOperation *op;
+  GTask *task;
+
+  g_return_if_fail(ACCOUNTS_IS_RETRY_SCHEDULER(scheduler));
+  g_return_if_fail(ACCOUNT_IS_ITEM(item));
+  g_return_if_fail(func != NULL);
+  g_return_if_fail(!cancellable || G_IS_CANCELLABLE(cancellable));
+
+  priv = PRIVATE(scheduler);
+
+  op = g_slice_new0(RetryOperation);
+  op->scheduler = scheduler;
+  op->item = g_object_ref(item);
+  op->func = func;
+  op->func_data = func_data;
+  op->func_data_destroy = func_data_destroy;
+
+  task = g_task_new(scheduler, cancellable, callback, user_data);
+  g_task_set_source_tag(task, accounts_retry_scheduler_submit_async);
+  g_task_set_task_data(task, op, (GDestroyNotify)operation_free);
+
+  if (g_task_return_error_if_cancelled(task))
+  {
+    g_object_unref(task);
+    return;
+  }
+
+  /* the scheduler reference, dropped when the operation completes */
+  op->task = task;
+
+  if (cancellable)
+  {
+    op->cancelled_id = g_cancellable_connect(cancellable,
+                                             G_CALLBACK(on_cancelled), op,
+                                             NULL);
+  }
+
+  g_queue_push_tail(&priv->ready, op);
+  schedule_dispatch(scheduler);
+}
+
+/**
+ * accounts_retry_scheduler_submit_finish:
+ * @scheduler: the #AccountsRetryScheduler.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with accounts_retry_scheduler_submit_async().
+ *
+ * Returns: %TRUE if an attempt succeeded, %FALSE with the error of the last
+ * attempt otherwise.
+ */
+gboolean
+accounts_retry_scheduler_submit_finish(AccountsRetryScheduler *scheduler,
+                                       GAsyncResult *result, GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, scheduler), FALSE);
+
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+/**
+ * accounts_retry_scheduler_get_network_available:
+ * @scheduler: the #AccountsRetryScheduler.
+ *
+ * Returns: whether @scheduler starts attempts.
+ */
+gboolean
+accounts_retry_scheduler_get_network_available(
+  AccountsRetryScheduler *scheduler)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_RETRY_SCHEDULER(scheduler), FALSE);
+
+  return PRIVATE(scheduler)->network_available;
+}
+
+/**
+ * accounts_retry_scheduler_set_network_available:
+ * @scheduler: the #AccountsRetryScheduler.
+ * @available: whether the network is available.
+ *
+ * Tells @scheduler whether the network is available, overriding its
+ * #GNetworkMonitor until the next change it reports. While it is not, no
+ * attempts are started.
+ */
+void
+accounts_retry_scheduler_set_network_available(
+  AccountsRetryScheduler *scheduler, gboolean available)
+{
+  AccountsRetrySchedulerPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_RETRY_SCHEDULER(scheduler));
+
+  priv = PRIVATE(scheduler);
+  available = !!available;
+
+  if (priv->network_available == available)
+    return;
+
+  priv->network_available = available;
+
+  if (available)
+    network_restored(scheduler);
+
+  g_object_notify(G_OBJECT(scheduler), "network-available");
+}
@@ -0,0 +1,87 @@
+/*
+ * accounts-retry-scheduler.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_RETRY_SCHEDULER_H_
+#define _ACCOUNTS_RETRY_SCHEDULER_H_
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_RETRY_SCHEDULER             (accounts_retry_scheduler_get_type ())
+#define ACCOUNTS_RETRY_SCHEDULER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_RETRY_SCHEDULER, AccountsRetryScheduler))
+#define ACCOUNTS_RETRY_SCHEDULER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_RETRY_SCHEDULER, AccountsRetrySchedulerClass))
+#define ACCOUNTS_IS_RETRY_SCHEDULER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_RETRY_SCHEDULER))
+#define ACCOUNTS_IS_RETRY_SCHEDULER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_RETRY_SCHEDULER))
+#define ACCOUNTS_RETRY_SCHEDULER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_RETRY_SCHEDULER, AccountsRetrySchedulerClass))
+
+typedef struct _AccountsRetrySchedulerClass AccountsRetrySchedulerClass;
+typedef struct _AccountsRetryScheduler AccountsRetryScheduler;
+
+#include "account-item.h"
+
+/**
+ * AccountsRetryFunc:
+ * @item: the #AccountItem the operation is for.
+ * @attempt:(transfer full): the #GTask of this attempt.
+ * @user_data: the data passed to accounts_retry_scheduler_submit_async().
+ *
+ * Makes one attempt of a retryable operation. The function must eventually
+ * complete @attempt, with g_task_return_boolean() on success or
+ * g_task_return_error() on failure, and should honour its cancellable, see
+ * g_task_get_cancellable().
+ */
+typedef void (*AccountsRetryFunc) (AccountItem *item, GTask *attempt,
+                                   gpointer user_data);
+
+struct _AccountsRetrySchedulerClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsRetryScheduler
+{
+    GObject parent_instance;
+};
+
+GType accounts_retry_scheduler_get_type (void) G_GNUC_CONST;
+
+AccountsRetryScheduler *accounts_retry_scheduler_new (GNetworkMonitor *monitor);
+AccountsRetryScheduler *accounts_retry_scheduler_get_default (void);
+
+void accounts_retry_scheduler_submit_async (AccountsRetryScheduler *scheduler,
+                                            AccountItem *item,
+                                            AccountsRetryFunc func,
+                                            gpointer func_data,
+                                            GDestroyNotify func_data_destroy,
+                                            GCancellable *cancellable,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data);
+gboolean accounts_retry_scheduler_submit_finish (AccountsRetryScheduler *scheduler,
+                                                 GAsyncResult *result,
+                                                 GError **error);
+
+gboolean accounts_retry_scheduler_get_network_available (AccountsRetryScheduler *scheduler);
+void accounts_retry_scheduler_set_network_available (AccountsRetryScheduler *scheduler,
+                                                     gboolean available);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_RETRY_SCHEDULER_H_ */
@@ -0,0 +1,862 @@
+/*
+ * accounts-search-index.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-search-index
+ * @short_description: type-to-filter search over the accounts.
+ *
+ * An #AccountsSearchIndex indexes the display name, name and service name of
+ * every account of an #AccountsModel, together with the display name of its
+ * #AccountService, so that accounts_search_index_search() does not have to
+ * look at every account on each keystroke.
+ *
+ * Both the indexed text and the queries are folded first: they are
+ * decomposed, stripped of accents and other combining marks, and case folded,
+ * so that "jose" finds "José". Queries of at least three characters are
+ * looked up by trigram, and accounts sharing most of the trigrams of the query
+ * are returned even if they don't contain it verbatim, which makes the search
+ * tolerant to small typos; shorter queries are looked up by word prefix.
+ *
+ * The index is updated one account at a time, as accounts are added, removed
+ * or renamed.
+ *
+ * When given an #AccountPluginManager, see
+ * #AccountsSearchIndex:plugin-manager, the index also covers the display
+ * names of all the services, including those without accounts, so that
+ * accounts_search_index_search_services() can offer to create an account
+ * for them. Services are few, so they are all indexed again whenever
+ * #AccountPluginManager::services-changed is emitted.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "accounts-search-index.h"
+
+enum
+{
+  FIELD_DISPLAY_NAME,
+  FIELD_NAME,
+  FIELD_SERVICE_NAME,
+  FIELD_SERVICE,
+  N_FIELDS
+};
+
+/* how much a match in each field counts */
+static const gdouble field_weight[N_FIELDS] = { 1.0, 0.9, 0.6, 0.5 };
+
+/* marks word prefix keys, so they can't be mistaken for trigrams */
+#define PREFIX_MARK "\001"
+
+/* either for an account or, with only the display name, for a service */
+typedef struct _SearchEntry
+{
+  AccountItem *item;
+  AccountService *service;
+  guint id;
+  gchar *folded[N_FIELDS];
+} SearchEntry;
+
+typedef struct _SearchMatch
+{
+  SearchEntry *entry;
+  gdouble score;
+} SearchMatch;
+
+struct _AccountsSearchIndexPrivate
+{
+  AccountsModel *model;
+  /* AccountItem -> SearchEntry */
+  GHashTable *entries;
+  /* trigram or word prefix -> set of SearchEntry */
+  GHashTable *grams;
+
+  AccountPluginManager *plugin_manager;
+  /* SearchEntry of the services, in priority order */
+  GPtrArray *services;
+  /* trigram or word prefix -> set of SearchEntry, for the services */
+  GHashTable *service_grams;
+};
+
+typedef struct _AccountsSearchIndexPrivate AccountsSearchIndexPrivate;
+
+#define PRIVATE(index) \
+  ((AccountsSearchIndexPrivate *) \
+   accounts_search_index_get_instance_private((AccountsSearchIndex *)(index)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsSearchIndex,
+  accounts_search_index,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_MODEL = 1,
+  PROP_PLUGIN_MANAGER
+};
+
+typedef void (*GramFunc) (const gchar *gram, gpointer user_data);
+
+static gchar *
+fold_text(const gchar *text)
+{
+  gchar *normalized;
+  GString *stripped;
+  gchar *folded;
+  const gchar *p;
+
+  if (!text || !*text)
+    return NULL;
+
+  normalized = g_utf8_normalize(text, -1, G_NORMALIZE_NFKD);
+
+  if (!normalized)
+    return NULL;
+
+  stripped = g_string_sized_new(strlen(normalized));
+
+  for (p = normalized; *p; p = g_utf8_next_char(p))
+  {
+    gunichar c = g_utf8_get_char(p);
+
+    if (!g_unichar_ismark(c))
+      g_string_append_unichar(stripped, c);
+  }
+
+  folded = g_utf8_casefold(stripped->str, stripped->len);
+  g_string_free(stripped, TRUE);
+  g_free(normalized);
+
+  return folded;
+}
+
+static gboolean
+is_word_start(const gchar *text, const gchar *p)
+{
+  const gchar *prev;
+
+  if (p == text)
+    return TRUE;
+
+  prev = g_utf8_find_prev_char(text, p);
+
+  return !prev || !g_unichar_isalnum(g_utf8_get_char(prev));
+}
+
+/* calls func for every trigram of text and for the one and two characters
+ * prefixes of its words */
+static void
+foreach_gram(const gchar *text, GramFunc func, gpointer user_data)
+{
+  const gchar *p;
+
+  for (p = text; *p; p = g_utf8_next_char(p))
+  {
+    const gchar *second = g_utf8_next_char(p);
+    const gchar *third = *second ? g_utf8_next_char(second) : second;
+    gchar *gram;
+
+    if (g_unichar_isalnum(g_utf8_get_char(p)) && is_word_start(text, p))
+    {
+      gram = g_strconcat(PREFIX_MARK, p, NULL);
+      gram[strlen(PREFIX_MARK) + (second - p)] = 0;
+      func(gram, user_data);
+      g_free(gram);
+
+      if (*second && g_unichar_isalnum(g_utf8_get_char(second)))
+      {
+        gram = g_strconcat(PREFIX_MARK, p, NULL);
+        gram[strlen(PREFIX_MARK) + (third - p)] = 0;
+        func(gram, user_data);
+        g_free(gram);
+      }
+    }
+
+    if (*third)
+    {
+      gram = g_strndup(p, g_utf8_next_char(third) - p);
+      func(gram, user_data);
+      g_free(gram);
+    }
+  }
+}
+
+typedef struct _GramUpdate
+{
+  GHashTable *grams;
+  SearchEntry *entry;
+} GramUpdate;
+
+static void
+add_gram(const gchar *gram, gpointer user_data)
+{
+  GramUpdate *update = user_data;
+  GHashTable *set = g_hash_table_lookup(update->grams, gram);
+
+  if (!set)
+  {
+    set = g_hash_table_new(NULL, NULL);
+    g_hash_table_insert(update->grams, g_strdup(gram), set);
+  }
+
+  g_hash_table_add(set, update->entry);
+}
+
+static void
+remove_gram(const gchar *gram, gpointer user_data)
+{
+  GramUpdate *update = user_data;
+  GHashTable *set = g_hash_table_lookup(update->grams, gram);
+
+  if (set && g_hash_table_remove(set, update->entry) &&
+      !g_hash_table_size(set))
+  {
+    g_hash_table_remove(update->grams, gram);
+  }
+}
+
+static void
+index_entry(GHashTable *grams, SearchEntry *entry, GramFunc func)
+{
+  GramUpdate update = { grams, entry };
+  guint i;
+
+  for (i = 0; i < N_FIELDS; i++)
+  {
+    if (entry->folded[i])
+      foreach_gram(entry->folded[i], func, &update);
+  }
+}
+
+static void
+fold_entry(SearchEntry *entry)
+{
+  AccountItem *item = entry->item;
+  guint i;
+
+  for (i = 0; i < N_FIELDS; i++)
+    g_free(entry->folded[i]);
+
+  entry->folded[FIELD_DISPLAY_NAME] = fold_text(item->display_name);
+  entry->folded[FIELD_NAME] = fold_text(item->name);
+  entry->folded[FIELD_SERVICE_NAME] = fold_text(item->service_name);
+  entry->folded[FIELD_SERVICE] = item->service ?
+    fold_text(account_service_get_display_name(item->service)) : NULL;
+}
+
+static void
+entry_free(SearchEntry *entry)
+{
+  guint i;
+
+  for (i = 0; i < N_FIELDS; i++)
+    g_free(entry->folded[i]);
+
+  if (entry->item)
+    g_object_unref(entry->item);
+
+  if (entry->service)
+    g_object_unref(entry->service);
+
+  g_slice_free(SearchEntry, entry);
+}
+
+static void
+index_services(AccountsSearchIndexPrivate *priv)
+{
+  GPtrArray *services;
+  guint i;
+
+  g_hash_table_remove_all(priv->service_grams);
+  g_ptr_array_set_size(priv->services, 0);
+
+  if (!priv->plugin_manager)
+    return;
+
+  services = account_plugin_manager_get_services(priv->plugin_manager);
+
+  for (i = 0; i < services->len; i++)
+  {
+    AccountService *service = g_ptr_array_index(services, i);
+    SearchEntry *entry = g_slice_new0(SearchEntry);
+
+    entry->service = g_object_ref(service);
+    entry->id = i;
+    entry->folded[FIELD_DISPLAY_NAME] =
+      fold_text(account_service_get_display_name(service));
+    g_ptr_array_add(priv->services, entry);
+    index_entry(priv->service_grams, entry, add_gram);
+  }
+}
+
+static void
+on_services_changed(AccountPluginManager *plugin_manager,
+                    AccountsSearchIndex *index)
+{
+  index_services(PRIVATE(index));
+}
+
+static void
+on_item_added(AccountsModel *model, AccountItem *item,
+              AccountsSearchIndex *index)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(index);
+  SearchEntry *entry;
+
+  if (g_hash_table_contains(priv->entries, item))
+    return;
+
+  entry = g_slice_new0(SearchEntry);
+  entry->item = g_object_ref(item);
+  entry->id = accounts_model_get_item_id(model, item);
+  fold_entry(entry);
+
+  g_hash_table_insert(priv->entries, item, entry);
+  index_entry(priv->grams, entry, add_gram);
+}
+
+static void
+on_item_removed(AccountsModel *model, AccountItem *item,
+                AccountsSearchIndex *index)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(index);
+  SearchEntry *entry = g_hash_table_lookup(priv->entries, item);
+
+  if (!entry)
+    return;
+
+  index_entry(priv->grams, entry, remove_gram);
+  g_hash_table_remove(priv->entries, item);
+}
+
+static void
+on_item_changed(AccountsModel *model, AccountItem *item, guint n_pspecs,
+                GParamSpec **pspecs, AccountsSearchIndex *index)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(index);
+  SearchEntry *entry = g_hash_table_lookup(priv->entries, item);
+  guint i;
+
+  if (!entry)
+    return;
+
+  for (i = 0; i < n_pspecs; i++)
+  {
+    if (!strcmp(pspecs[i]->name, "display-name") ||
+        !strcmp(pspecs[i]->name, "name") ||
+        !strcmp(pspecs[i]->name, "service-name"))
+    {
+      index_entry(priv->grams, entry, remove_gram);
+      fold_entry(entry);
+      index_entry(priv->grams, entry, add_gram);
+      break;
+    }
+  }
+}
+
+static gdouble
+score_entry(SearchEntry *entry, const gchar *query, gdouble similarity)
+{
+  gdouble best = 0.0;
+  guint i;
+
+  for (i = 0; i < N_FIELDS; i++)
+  {
+    const gchar *folded = entry->folded[i];
+    const gchar *found;
+    gdouble score;
+
+    if (!folded)
+      continue;
+
+    found = strstr(folded, query);
+
+    if (found == folded)
+      score = 3.0;
+    else if (found && is_word_start(folded, found))
+      score = 2.5;
+    else if (found)
+      score = 2.0;
+    else
+      score = similarity;
+
+    score *= field_weight[i];
+
+    if (score > best)
+      best = score;
+  }
+
+  return best;
+}
+
+static gint
+compare_matches(gconstpointer a, gconstpointer b)
+{
+  const SearchMatch *match_a = a;
+  const SearchMatch *match_b = b;
+
+  if (match_a->score != match_b->score)
+    return match_a->score > match_b->score ? -1 : 1;
+
+  if (match_a->entry->id != match_b->entry->id)
+    return match_a->entry->id < match_b->entry->id ? -1 : 1;
+
+  return 0;
+}
+
+static void
+count_gram(const gchar *gram, gpointer user_data)
+{
+  /* only the trigrams of the query are used */
+  if (strncmp(gram, PREFIX_MARK, strlen(PREFIX_MARK)))
+    g_hash_table_add(user_data, g_strdup(gram));
+}
+
+/* the entries of grams matching folded, best match first */
+static GArray *
+find_matches(GHashTable *grams, const gchar *folded, guint max_results)
+{
+  GArray *matches;
+  GHashTable *counts;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  guint n_grams;
+
+  matches = g_array_new(FALSE, FALSE, sizeof(SearchMatch));
+  /* SearchEntry -> number of query trigrams it has */
+  counts = g_hash_table_new(NULL, NULL);
+
+  if (g_utf8_strlen(folded, -1) < 3)
+  {
+    gchar *prefix = g_strconcat(PREFIX_MARK, folded, NULL);
+    GHashTable *set = g_hash_table_lookup(grams, prefix);
+
+    if (set)
+    {
+      g_hash_table_iter_init(&iter, set);
+
+      while (g_hash_table_iter_next(&iter, &key, NULL))
+        g_hash_table_insert(counts, key, GUINT_TO_POINTER(1));
+    }
+
+    g_free(prefix);
+    n_grams = 1;
+  }
+  else
+  {
+    GHashTable *query_grams = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                    g_free, NULL);
+
+    foreach_gram(folded, count_gram, query_grams);
+    n_grams = g_hash_table_size(query_grams);
+    g_hash_table_iter_init(&iter, query_grams);
+
+    while (g_hash_table_iter_next(&iter, &key, NULL))
+    {
+      GHashTable *set = g_hash_table_lookup(grams, key);
+      GHashTableIter set_iter;
+      gpointer entry;
+
+      if (!set)
+        continue;
+
+      g_hash_table_iter_init(&set_iter, set);
+
+      while (g_hash_table_iter_next(&set_iter, &entry, NULL))
+      {
+        guint count = GPOINTER_TO_UINT(g_hash_table_lookup(counts, entry));
+
+        g_hash_table_insert(counts, entry, GUINT_TO_POINTER(count + 1));
+      }
+    }
+
+    g_hash_table_destroy(query_grams);
+  }
+
+  g_hash_table_iter_init(&iter, counts);
+
+  while (g_hash_table_iter_next(&iter, &key, &value))
+  {
+    guint count = GPOINTER_TO_UINT(value);
+    SearchMatch match;
+
+    /* tolerate typos, but not unrelated accounts */
+    if (2 * count < n_grams)
+      continue;
+
+    match.entry = key;
+    match.score = score_entry(key, folded, (gdouble)count / n_grams);
+    g_array_append_val(matches, match);
+  }
+
+  g_array_sort(matches, compare_matches);
+
+  if (max_results && matches->len > max_results)
+    g_array_set_size(matches, max_results);
+
+  g_hash_table_destroy(counts);
+
+  return matches;
+}
+
+static void
+accounts_search_index_constructed(GObject *object)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(object);
+  GList *items;
+  GList *l;
+
+  G_OBJECT_CLASS(accounts_search_index_parent_class)->constructed(object);
+
+  if (!priv->model)
+    return;
+
+  g_signal_connect(priv->model, "item-added",
+                   G_CALLBACK(on_item_added), object);
+  g_signal_connect(priv->model, "item-removed",
+                   G_CALLBACK(on_item_removed), object);
+  g_signal_connect(priv->model, "item-changed",
+                   G_CALLBACK(on_item_changed), object);
+
+  items = accounts_model_list(priv->model);
+
+  for (l = items; l; l = l->next)
+    on_item_added(priv->model, l->data, ACCOUNTS_SEARCH_INDEX(object));
+
+  g_list_free(items);
+}
+
+static void
+accounts_search_index_dispose(GObject *object)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(object);
+
+  if (priv->model)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->model, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->model);
+    priv->model = NULL;
+  }
+
+  if (priv->plugin_manager)
+  {
+    g_signal_handlers_disconnect_by_func(priv->plugin_manager,
+                                         on_services_changed, object);
+    g_object_unref(priv->plugin_manager);
+    priv->plugin_manager = NULL;
+  }
+
+  g_hash_table_remove_all(priv->service_grams);
+  g_ptr_array_set_size(priv->services, 0);
+  g_hash_table_remove_all(priv->grams);
+  g_hash_table_remove_all(priv->entries);
+
+  G_OBJECT_CLASS(accounts_search_index_parent_class)->dispose(object);
+}
+
+static void
+accounts_search_index_finalize(GObject *object)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(object);
+
+  g_hash_table_destroy(priv->grams);
+  g_hash_table_destroy(priv->entries);
+  g_hash_table_destroy(priv->service_grams);
+  g_ptr_array_free(priv->services, TRUE);
+
+  G_OBJECT_CLASS(accounts_search_index_parent_class)->finalize(object);
+}
+
+static void
+accounts_search_index_set_property(GObject *object, guint property_id,
+                                   const GValue *value, GParamSpec *pspec)
+{
+  AccountsSearchIndexPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SEARCH_INDEX(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      priv->model = g_value_dup_object(value);
+      break;
+    }
+    case PROP_PLUGIN_MANAGER:
+    {
+      accounts_search_index_set_plugin_manager(ACCOUNTS_SEARCH_INDEX(object),
+                                               g_value_get_object(value));
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_search_index_get_property(GObject *object, guint property_id,
+                                   GValue *value, GParamSpec *pspec)
+{
+  AccountsSearchIndexPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SEARCH_INDEX(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      g_value_set_object(value, priv->model);
+      break;
+    }
+    case PROP_PLUGIN_MANAGER:
+    {
+      g_value_set_object(value, priv->plugin_manager);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_search_index_class_init(AccountsSearchIndexClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_search_index_constructed;
+  object_class->dispose = accounts_search_index_dispose;
+  object_class->finalize = accounts_search_index_finalize;
+  object_class->set_property = accounts_search_index_set_property;
+  object_class->get_property = accounts_search_index_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_MODEL,
+    g_param_spec_object(
+      "model",
+      "Model",
+      "AccountsModel being indexed",
+      ACCOUNTS_TYPE_MODEL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+
+  /**
+   * AccountsSearchIndex:plugin-manager:
+   *
+   * The #AccountPluginManager whose services are indexed, or %NULL.
+   */
+  g_object_class_install_property(
+    object_class, PROP_PLUGIN_MANAGER,
+    g_param_spec_object(
+      "plugin-manager",
+      "Plugin manager",
+      "AccountPluginManager whose services are indexed",
+      ACCOUNT_TYPE_PLUGIN_MANAGER,
+      G_PARAM_READWRITE));
+}
+
+static void
+accounts_search_index_init(AccountsSearchIndex *index)
+{
+  AccountsSearchIndexPrivate *priv = PRIVATE(index);
+
+  priv->entries = g_hash_table_new_full(NULL, NULL, NULL,
+                                        (GDestroyNotify)entry_free);
+  priv->grams = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                      (GDestroyNotify)g_hash_table_destroy);
+  priv->services = g_ptr_array_new_with_free_func(
+      (GDestroyNotify)entry_free);
+  priv->service_grams = g_hash_table_new_full(
+      g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_hash_table_destroy);
+}
+
+/**
+ * accounts_search_index_new:
+ * @model: the #AccountsModel to index.
+ *
+ * Creates an #AccountsSearchIndex over the accounts of @model.
+ *
+ * Returns:(transfer full): a new #AccountsSearchIndex.
+ */
+AccountsSearchIndex *
+accounts_search_index_new(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_SEARCH_INDEX, "model", model, NULL);
+}
+
+/**
+ * accounts_search_index_search:
+ * @index: the #AccountsSearchIndex.
+ * @query: the text typed by the user.
+ * @max_results: the maximum number of accounts to return, 0 for no limit.
+ *
+ * Finds the accounts matching @query. Accounts whose names start with
+ * @query come first, followed by the ones having a word starting with it,
+ * the ones containing it and finally the ones only sharing most of its
+ * trigrams. Matches in the display name rank higher than matches in the name,
+ * which in turn rank higher than matches in the service names.
+ *
+ * Returns:(transfer container)(element-type AccountItem): the matching
+ * accounts, best match first; free the list with g_list_free().
+ */
+GList *
+accounts_search_index_search(AccountsSearchIndex *index, const gchar *query,
+                             guint max_results)
+{
+  GArray *matches;
+  GList *items = NULL;
+  gchar *folded;
+  guint i;
+
+  g_return_val_if_fail(ACCOUNTS_IS_SEARCH_INDEX(index), NULL);
+
+  folded = fold_text(query);
+
+  if (!folded)
+    return NULL;
+
+  matches = find_matches(PRIVATE(index)->grams, folded, max_results);
+
+  for (i = matches->len; i > 0; i--)
+  {
+    items = g_list_prepend(
+        items, g_array_index(matches, SearchMatch, i - 1).entry->item);
+  }
+
+  g_array_free(matches, TRUE);
+  g_free(folded);
+
+  return items;
+}
+
+/**
+ * accounts_search_index_get_plugin_manager:
+ * @index: the #AccountsSearchIndex.
+ *
+ * Returns:(transfer none)(nullable): the value of the
+ * #AccountsSearchIndex:plugin-manager property.
+ */
+AccountPluginManager *
+accounts_search_index_get_plugin_manager(AccountsSearchIndex *index)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_SEARCH_INDEX(index), NULL);
+
+  return PRIVATE(index)->plugin_manager;
+}
+
+/**
+ * accounts_search_index_set_plugin_manager:
+ * @index: the #AccountsSearchIndex.
+ * @plugin_manager:(nullable): the #AccountPluginManager whose services to
+ * index, or %NULL.
+ *
+ * Sets the #AccountsSearchIndex:plugin-manager property, indexing the
+ * services of @plugin_manager.
+ */
+void
+accounts_search_index_set_plugin_manager(AccountsSearchIndex *index,
+                                         AccountPluginManager *plugin_manager)
+{
+  AccountsSearchIndexPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SEARCH_INDEX(index));
+  g_return_if_fail(!plugin_manager ||
+                   ACCOUNT_IS_PLUGIN_MANAGER(plugin_manager));
+
+  priv = PRIVATE(index);
+
+  if (priv->plugin_manager == plugin_manager)
+    return;
+
+  if (priv->plugin_manager)
+  {
+    g_signal_handlers_disconnect_by_func(priv->plugin_manager,
+                                         on_services_changed, index);
+    g_object_unref(priv->plugin_manager);
+  }
+
+  priv->plugin_manager = plugin_manager;
+
+  if (plugin_manager)
+  {
+    g_object_ref(plugin_manager);
+    g_signal_connect(plugin_manager, "services-changed",
+                     G_CALLBACK(on_services_changed), index);
+  }
+
+  index_services(priv);
+  g_object_notify(G_OBJECT(index), "plugin-manager");
+}
+
+/**
+ * accounts_search_index_search_services:
+ * @index: the #AccountsSearchIndex.
+ * @query: the text typed by the user.
+ * @max_results: the maximum number of services to return, 0 for no limit.
+ *
+ * Finds the services of #AccountsSearchIndex:plugin-manager whose display
+ * name matches @query, whether they have accounts or not. Matches are ranked
+ * as by accounts_search_index_search(), then by priority.
+ *
+ * Returns:(transfer container)(element-type AccountService): the matching
+ * services, best match first; free the list with g_list_free().
+ */
+GList *
+accounts_search_index_search_services(AccountsSearchIndex *index,
+                                      const gchar *query, guint max_results)
+{
+  GArray *matches;
+  GList *services = NULL;
+  gchar *folded;
+  guint i;
+
+  g_return_val_if_fail(ACCOUNTS_IS_SEARCH_INDEX(index), NULL);
+
+  folded = fold_text(query);
+
+  if (!folded)
+    return NULL;
+
+  matches = find_matches(PRIVATE(index)->service_grams, folded, max_results);
+
+  for (i = matches->len; i > 0; i--)
+  {
+    services = g_list_prepend(
+        services, g_array_index(matches, SearchMatch, i - 1).entry->service);
+  }
+
+  g_array_free(matches, TRUE);
+  g_free(folded);
+
+  return services;
+}
@@ -0,0 +1,68 @@
+/*
+ * accounts-search-index.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_SEARCH_INDEX_H_
+#define _ACCOUNTS_SEARCH_INDEX_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_SEARCH_INDEX             (accounts_search_index_get_type ())
+#define ACCOUNTS_SEARCH_INDEX(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_SEARCH_INDEX, AccountsSearchIndex))
+#define ACCOUNTS_SEARCH_INDEX_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_SEARCH_INDEX, AccountsSearchIndexClass))
+#define ACCOUNTS_IS_SEARCH_INDEX(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_SEARCH_INDEX))
+#define ACCOUNTS_IS_SEARCH_INDEX_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_SEARCH_INDEX))
+#define ACCOUNTS_SEARCH_INDEX_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_SEARCH_INDEX, AccountsSearchIndexClass))
+
+typedef struct _AccountsSearchIndexClass AccountsSearchIndexClass;
+typedef struct _AccountsSearchIndex AccountsSearchIndex;
+
+#include "accounts-model.h"
+#include "account-plugin-manager.h"
+
+struct _AccountsSearchIndexClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsSearchIndex
+{
+    GObject parent_instance;
+};
+
+GType accounts_search_index_get_type (void) G_GNUC_CONST;
+
+AccountsSearchIndex *accounts_search_index_new (AccountsModel *model);
+
+GList *accounts_search_index_search (AccountsSearchIndex *index,
+                                     const gchar *query,
+                                     guint max_results);
+
+AccountPluginManager *
+accounts_search_index_get_plugin_manager (AccountsSearchIndex *index);
+void accounts_search_index_set_plugin_manager (
+    AccountsSearchIndex *index, AccountPluginManager *plugin_manager);
+GList *accounts_search_index_search_services (AccountsSearchIndex *index,
+                                              const gchar *query,
+                                              guint max_results);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_SEARCH_INDEX_H_ */
@@ -0,0 +1,436 @@
+/*
+ * accounts-snapshot.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-snapshot
+ * @short_description: immutable, thread-safe view of the accounts.
+ *
+ * An #AccountsSnapshot is a read-only copy of the state of all the accounts
+ * known to an #AccountsModel at a given point in time, obtained with
+ * accounts_model_get_snapshot(). Each account is represented by an
+ * #AccountsRecord, which is never modified after being created: when an
+ * #AccountItem changes, the #AccountsModel creates a new record for it and
+ * publishes a new snapshot, sharing the records of the unchanged accounts.
+ *
+ * Unlike all the other libaccounts objects, snapshots and records can be used
+ * from any thread, without any locking; the only requirement is to hold a
+ * reference to them while reading.
+ */
+
+#include "config.h"
+
+#include "accounts-private.h"
+
+struct _AccountsRecord
+{
+  gint ref_count;
+  guint id;
+  gchar *name;
+  gchar *display_name;
+  gchar *service_name;
+  gchar *service;
+  gchar *plugin;
+  guint enabled : 1;
+  guint draft : 1;
+  guint connected : 1;
+  guint supports_avatar : 1;
+};
+
+struct _AccountsSnapshot
+{
+  gint ref_count;
+  guint64 sequence;
+  GPtrArray *records;
+};
+
+G_DEFINE_BOXED_TYPE(
+  AccountsSnapshot,
+  accounts_snapshot,
+  accounts_snapshot_ref,
+  accounts_snapshot_unref
+)
+
+G_DEFINE_BOXED_TYPE(
+  AccountsRecord,
+  accounts_record,
+  accounts_record_ref,
+  accounts_record_unref
+)
+
+AccountsRecord *
+_accounts_record_new(AccountItem *item, guint id)
+{
+  AccountsRecord *record = g_slice_new0(AccountsRecord);
+  AccountPlugin *plugin = account_item_get_plugin(item);
+
+  record->ref_count = 1;
+  record->id = id;
+  record->name = g_strdup(item->name);
+  record->display_name = g_strdup(item->display_name);
+  /* shared by all the records of the service */
+  if (item->service &&
+      !g_strcmp0(item->service_name, item->service->display_name))
+  {
+    record->service_name =
+      _account_service_dup_display_name_ref(item->service);
+  }
+  else
+    record->service_name = _accounts_ref_string_intern(item->service_name);
+
+  if (item->service)
+    record->service = _account_service_dup_name_ref(item->service);
+
+  if (plugin)
+  {
+    record->plugin =
+      _accounts_ref_string_intern(account_plugin_get_name(plugin));
+  }
+
+  record->enabled = item->enabled;
+  record->draft = item->draft;
+  record->connected = item->connected;
+  record->supports_avatar = item->supports_avatar;
+
+  return record;
+}
+
+AccountsSnapshot *
+_accounts_snapshot_new(GPtrArray *records, guint64 sequence)
+{
+  AccountsSnapshot *snapshot = g_slice_new(AccountsSnapshot);
+
+  snapshot->ref_count = 1;
+  snapshot->sequence = sequence;
+  snapshot->records = records;
+  g_ptr_array_set_free_func(records, (GDestroyNotify)accounts_record_unref);
+
+  return snapshot;
+}
+
+/**
+ * accounts_snapshot_ref:
+ * @snapshot: the #AccountsSnapshot.
+ *
+ * Increases the reference count of @snapshot. This function is thread-safe.
+ *
+ * Returns:(transfer full): @snapshot.
+ */
+AccountsSnapshot *
+accounts_snapshot_ref(AccountsSnapshot *snapshot)
+{
+  g_return_val_if_fail(snapshot != NULL, NULL);
+
+  g_atomic_int_inc(&snapshot->ref_count);
+
+  return snapshot;
+}
+
+/**
+ * accounts_snapshot_unref:
+ * @snapshot: the #AccountsSnapshot.
+ *
+ * Decreases the reference count of @snapshot, freeing it when it drops to
+ * zero. This function is thread-safe.
+ */
+void
+accounts_snapshot_unref(AccountsSnapshot *snapshot)
+{
+  g_return_if_fail(snapshot != NULL);
+
+  if (g_atomic_int_dec_and_test(&snapshot->ref_count))
+  {
+    g_ptr_array_unref(snapshot->records);
+    g_slice_free(AccountsSnapshot, snapshot);
+  }
+}
+
+/**
+ * accounts_snapshot_get_sequence:
+ * @snapshot: the #AccountsSnapshot.
+ *
+ * Gets the sequence number of the last change included in @snapshot; it can
+ * be passed to accounts_model_changes_since() to learn what changed after the
+ * snapshot was taken.
+ *
+ * Returns: a change sequence number.
+ */
+guint64
+accounts_snapshot_get_sequence(AccountsSnapshot *snapshot)
+{
+  g_return_val_if_fail(snapshot != NULL, 0);
+
+  return snapshot->sequence;
+}
+
+/**
+ * accounts_snapshot_get_n_records:
+ * @snapshot: the #AccountsSnapshot.
+ *
+ * Returns: the number of accounts in @snapshot.
+ */
+guint
+accounts_snapshot_get_n_records(AccountsSnapshot *snapshot)
+{
+  g_return_val_if_fail(snapshot != NULL, 0);
+
+  return snapshot->records->len;
+}
+
+/**
+ * accounts_snapshot_get_record:
+ * @snapshot: the #AccountsSnapshot.
+ * @index: the index of the record, lower than
+ * accounts_snapshot_get_n_records().
+ *
+ * Gets the @index-th record of @snapshot. Records are sorted by their
+ * identifier, which is the order in which the accounts were added.
+ *
+ * Returns:(transfer none): an #AccountsRecord, valid as long as @snapshot is.
+ */
+const AccountsRecord *
+accounts_snapshot_get_record(AccountsSnapshot *snapshot, guint index)
+{
+  g_return_val_if_fail(snapshot != NULL, NULL);
+  g_return_val_if_fail(index < snapshot->records->len, NULL);
+
+  return g_ptr_array_index(snapshot->records, index);
+}
+
+/**
+ * accounts_snapshot_lookup:
+ * @snapshot: the #AccountsSnapshot.
+ * @id: an account identifier, as returned by accounts_model_get_item_id().
+ *
+ * Finds the record of the account identified by @id.
+ *
+ * Returns:(transfer none)(nullable): an #AccountsRecord, or %NULL if the
+ * account is not part of @snapshot.
+ */
+const AccountsRecord *
+accounts_snapshot_lookup(AccountsSnapshot *snapshot, guint id)
+{
+  guint low = 0;
+  guint high;
+
+  g_return_val_if_fail(snapshot != NULL, NULL);
+
+  high = snapshot->records->len;
+
+  while (low < high)
+  {
+    guint mid = low + (high - low) / 2;
+    AccountsRecord *record = g_ptr_array_index(snapshot->records, mid);
+
+    if (record->id == id)
+      return record;
+
+    if (record->id < id)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return NULL;
+}
+
+/**
+ * accounts_record_ref:
+ * @record: the #AccountsRecord.
+ *
+ * Increases the reference count of @record, so that it can be used after the
+ * #AccountsSnapshot it was taken from is released. This function is
+ * thread-safe.
+ *
+ * Returns:(transfer full): @record.
+ */
+AccountsRecord *
+accounts_record_ref(AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, NULL);
+
+  g_atomic_int_inc(&record->ref_count);
+
+  return record;
+}
+
+/**
+ * accounts_record_unref:
+ * @record: the #AccountsRecord.
+ *
+ * Decreases the reference count of @record. This function is thread-safe.
+ */
+void
+accounts_record_unref(AccountsRecord *record)
+{
+  g_return_if_fail(record != NULL);
+
+  if (g_atomic_int_dec_and_test(&record->ref_count))
+  {
+    g_free(record->name);
+    g_free(record->display_name);
+    _accounts_ref_string_release(record->service_name);
+    _accounts_ref_string_release(record->service);
+    _accounts_ref_string_release(record->plugin);
+    g_slice_free(AccountsRecord, record);
+  }
+}
+
+/**
+ * accounts_record_get_id:
+ * @record: the #AccountsRecord.
+ *
+ * Returns: the identifier assigned to the account by the #AccountsModel.
+ */
+guint
+accounts_record_get_id(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, 0);
+
+  return record->id;
+}
+
+/**
+ * accounts_record_get_name:
+ * @record: the #AccountsRecord.
+ *
+ * Returns:(transfer none): the value of the #AccountItem:name property.
+ */
+const gchar *
+accounts_record_get_name(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, NULL);
+
+  return record->name;
+}
+
+/**
+ * accounts_record_get_display_name:
+ * @record: the #AccountsRecord.
+ *
+ * Returns:(transfer none): the value of the #AccountItem:display-name
+ * property.
+ */
+const gchar *
+accounts_record_get_display_name(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, NULL);
+
+  return record->display_name;
+}
+
+/**
+ * accounts_record_get_service_name:
+ * @record: the #AccountsRecord.
+ *
+ * Returns:(transfer none): the value of the #AccountItem:service-name
+ * property.
+ */
+const gchar *
+accounts_record_get_service_name(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, NULL);
+
+  return record->service_name;
+}
+
+/**
+ * accounts_record_get_service:
+ * @record: the #AccountsRecord.
+ *
+ * Returns:(transfer none): the name of the #AccountService of the account, as
+ * returned by account_service_get_name().
+ */
+const gchar *
+accounts_record_get_service(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, NULL);
+
+  return record->service;
+}
+
+/**
+ * accounts_record_get_plugin:
+ * @record: the #AccountsRecord.
+ *
+ * Returns:(transfer none): the name of the #AccountPlugin of the account, as
+ * returned by account_plugin_get_name().
+ */
+const gchar *
+accounts_record_get_plugin(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, NULL);
+
+  return record->plugin;
+}
+
+/**
+ * accounts_record_get_enabled:
+ * @record: the #AccountsRecord.
+ *
+ * Returns: the value of the #AccountItem:enabled property.
+ */
+gboolean
+accounts_record_get_enabled(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, FALSE);
+
+  return record->enabled;
+}
+
+/**
+ * accounts_record_get_draft:
+ * @record: the #AccountsRecord.
+ *
+ * Returns: the value of the #AccountItem:draft property.
+ */
+gboolean
+accounts_record_get_draft(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, FALSE);
+
+  return record->draft;
+}
+
+/**
+ * accounts_record_get_connected:
+ * @record: the #AccountsRecord.
+ *
+ * Returns: the value of the #AccountItem:connected property.
+ */
+gboolean
+accounts_record_get_connected(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, FALSE);
+
+  return record->connected;
+}
+
+/**
+ * accounts_record_get_supports_avatar:
+ * @record: the #AccountsRecord.
+ *
+ * Returns: the value of the #AccountItem:supports-avatar property.
+ */
+gboolean
+accounts_record_get_supports_avatar(const AccountsRecord *record)
+{
+  g_return_val_if_fail(record != NULL, FALSE);
+
+  return record->supports_avatar;
+}
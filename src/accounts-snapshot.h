@@ -0,0 +1,62 @@
+/*
+ * accounts-snapshot.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_SNAPSHOT_H_
+#define _ACCOUNTS_SNAPSHOT_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_SNAPSHOT          (accounts_snapshot_get_type ())
+#define ACCOUNTS_TYPE_RECORD            (accounts_record_get_type ())
+
+typedef struct _AccountsSnapshot AccountsSnapshot;
+typedef struct _AccountsRecord AccountsRecord;
+
+GType accounts_snapshot_get_type (void) G_GNUC_CONST;
+GType accounts_record_get_type (void) G_GNUC_CONST;
+
+AccountsSnapshot *accounts_snapshot_ref (AccountsSnapshot *snapshot);
+void accounts_snapshot_unref (AccountsSnapshot *snapshot);
+
+guint64 accounts_snapshot_get_sequence (AccountsSnapshot *snapshot);
+guint accounts_snapshot_get_n_records (AccountsSnapshot *snapshot);
+const AccountsRecord *accounts_snapshot_get_record (AccountsSnapshot *snapshot,
+                                                    guint index);
+const AccountsRecord *accounts_snapshot_lookup (AccountsSnapshot *snapshot,
+                                                guint id);
+
+AccountsRecord *accounts_record_ref (AccountsRecord *record);
+void accounts_record_unref (AccountsRecord *record);
+
+guint accounts_record_get_id (const AccountsRecord *record);
+const gchar *accounts_record_get_name (const AccountsRecord *record);
+const gchar *accounts_record_get_display_name (const AccountsRecord *record);
+const gchar *accounts_record_get_service_name (const AccountsRecord *record);
+const gchar *accounts_record_get_service (const AccountsRecord *record);
+const gchar *accounts_record_get_plugin (const AccountsRecord *record);
+gboolean accounts_record_get_enabled (const AccountsRecord *record);
+gboolean accounts_record_get_draft (const AccountsRecord *record);
+gboolean accounts_record_get_connected (const AccountsRecord *record);
+gboolean accounts_record_get_supports_avatar (const AccountsRecord *record);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_SNAPSHOT_H_ */
@@ -0,0 +1,613 @@
+/*
+ * accounts-sorted-view.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-sorted-view
+ * @short_description: accounts sorted for display.
+ *
+ * An #AccountsSortedView keeps the accounts of an #AccountsModel in the order
+ * they should be presented to the user: by ascending priority of their
+ * #AccountService, and then by display name (or name, for accounts which have
+ * no display name) according to the current locale.
+ *
+ * The order is maintained incrementally: the collation key of every account
+ * is computed once and cached, accounts are inserted and removed by binary
+ * search, and an account is repositioned only when its name, or the priority
+ * of its service, changes. Every
+ * change is reported through the #AccountsSortedView::item-inserted and
+ * #AccountsSortedView::item-removed signals; a move is reported as a removal
+ * followed by an insertion.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "accounts-sorted-view.h"
+
+#include "account-marshal.h"
+
+typedef struct _SortEntry
+{
+  AccountItem *item;
+  guint id;
+  gint priority;
+  gchar *key;
+} SortEntry;
+
+struct _AccountsSortedViewPrivate
+{
+  AccountsModel *model;
+  /* SortEntry, sorted */
+  GPtrArray *entries;
+  GHashTable *by_item;
+  /* AccountService whose priority is watched, to its number of entries */
+  GHashTable *services;
+};
+
+typedef struct _AccountsSortedViewPrivate AccountsSortedViewPrivate;
+
+#define PRIVATE(view) \
+  ((AccountsSortedViewPrivate *) \
+   accounts_sorted_view_get_instance_private((AccountsSortedView *)(view)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsSortedView,
+  accounts_sorted_view,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_MODEL = 1
+};
+
+enum
+{
+  ITEM_INSERTED,
+  ITEM_REMOVED,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+static gchar *
+collate_key(AccountItem *item)
+{
+  const gchar *text = item->display_name;
+
+  if (!text || !*text)
+    text = item->name;
+
+  return g_utf8_collate_key(text ? text : "", -1);
+}
+
+static gint
+compare_entries(const SortEntry *a, const SortEntry *b)
+{
+  gint res;
+
+  if (a->priority != b->priority)
+    return a->priority < b->priority ? -1 : 1;
+
+  res = strcmp(a->key, b->key);
+
+  if (res)
+    return res;
+
+  if (a->id != b->id)
+    return a->id < b->id ? -1 : 1;
+
+  return 0;
+}
+
+static gint
+compare_entries_indirect(gconstpointer a, gconstpointer b)
+{
+  return compare_entries(*(const SortEntry **)a, *(const SortEntry **)b);
+}
+
+/* index of the first entry not lower than entry */
+static guint
+lower_bound(AccountsSortedViewPrivate *priv, const SortEntry *entry)
+{
+  guint low = 0;
+  guint high = priv->entries->len;
+
+  while (low < high)
+  {
+    guint mid = low + (high - low) / 2;
+
+    if (compare_entries(g_ptr_array_index(priv->entries, mid), entry) < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low;
+}
+
+static SortEntry *
+entry_new(AccountsSortedViewPrivate *priv, AccountItem *item)
+{
+  SortEntry *entry = g_slice_new(SortEntry);
+
+  entry->item = g_object_ref(item);
+  entry->id = accounts_model_get_item_id(priv->model, item);
+  entry->priority = item->service ?
+    account_service_get_priority(item->service) : 0;
+  entry->key = collate_key(item);
+
+  return entry;
+}
+
+static void
+entry_free(SortEntry *entry)
+{
+  g_object_unref(entry->item);
+  g_free(entry->key);
+  g_slice_free(SortEntry, entry);
+}
+
+static void
+insert_entry(AccountsSortedView *view, SortEntry *entry)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  guint position = lower_bound(priv, entry);
+
+  g_ptr_array_insert(priv->entries, position, entry);
+  g_signal_emit(view, signals[ITEM_INSERTED], 0, entry->item, position);
+}
+
+static void
+remove_entry(AccountsSortedView *view, SortEntry *entry)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  guint position = lower_bound(priv, entry);
+
+  g_return_if_fail(g_ptr_array_index(priv->entries, position) == entry);
+
+  g_ptr_array_remove_index(priv->entries, position);
+  g_signal_emit(view, signals[ITEM_REMOVED], 0, entry->item, position);
+}
+
+/* entry, whose sort key just changed, was found at position with the old
+ * one */
+static void
+reposition_entry(AccountsSortedView *view, SortEntry *entry, guint position)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+
+  /* still between its neighbours, nothing to report */
+  if ((position == 0 ||
+       compare_entries(g_ptr_array_index(priv->entries, position - 1),
+                       entry) < 0) &&
+      (position + 1 == priv->entries->len ||
+       compare_entries(entry,
+                       g_ptr_array_index(priv->entries, position + 1)) < 0))
+  {
+    return;
+  }
+
+  g_ptr_array_remove_index(priv->entries, position);
+  g_signal_emit(view, signals[ITEM_REMOVED], 0, entry->item, position);
+  insert_entry(view, entry);
+}
+
+static void
+on_priority_notify(AccountService *service, GParamSpec *pspec,
+                   AccountsSortedView *view)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  gint priority = account_service_get_priority(service);
+  GSList *moved = NULL;
+  GSList *l;
+  guint i;
+
+  for (i = 0; i < priv->entries->len; i++)
+  {
+    SortEntry *entry = g_ptr_array_index(priv->entries, i);
+
+    if (entry->item->service == service && entry->priority != priority)
+      moved = g_slist_prepend(moved, entry);
+  }
+
+  /* one at a time, so that the others are still found with their old
+   * priority */
+  for (l = moved; l; l = l->next)
+  {
+    SortEntry *entry = l->data;
+    guint position = lower_bound(priv, entry);
+
+    entry->priority = priority;
+    reposition_entry(view, entry, position);
+  }
+
+  g_slist_free(moved);
+}
+
+static void
+watch_service(AccountsSortedView *view, AccountService *service)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  guint count;
+
+  if (!service)
+    return;
+
+  count = GPOINTER_TO_UINT(g_hash_table_lookup(priv->services, service));
+
+  if (!count)
+  {
+    g_object_ref(service);
+    g_signal_connect(service, "notify::priority",
+                     G_CALLBACK(on_priority_notify), view);
+  }
+
+  g_hash_table_insert(priv->services, service, GUINT_TO_POINTER(count + 1));
+}
+
+static void
+unwatch_service(AccountsSortedView *view, AccountService *service)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  guint count;
+
+  if (!service)
+    return;
+
+  count = GPOINTER_TO_UINT(g_hash_table_lookup(priv->services, service));
+
+  g_return_if_fail(count > 0);
+
+  if (count > 1)
+  {
+    g_hash_table_insert(priv->services, service, GUINT_TO_POINTER(count - 1));
+    return;
+  }
+
+  g_hash_table_remove(priv->services, service);
+  g_signal_handlers_disconnect_by_func(service, on_priority_notify, view);
+  g_object_unref(service);
+}
+
+static void
+on_item_added(AccountsModel *model, AccountItem *item,
+              AccountsSortedView *view)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  SortEntry *entry;
+
+  if (g_hash_table_contains(priv->by_item, item))
+    return;
+
+  entry = entry_new(priv, item);
+  g_hash_table_insert(priv->by_item, item, entry);
+  watch_service(view, item->service);
+  insert_entry(view, entry);
+}
+
+static void
+on_item_removed(AccountsModel *model, AccountItem *item,
+                AccountsSortedView *view)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  SortEntry *entry = g_hash_table_lookup(priv->by_item, item);
+
+  if (!entry)
+    return;
+
+  g_hash_table_steal(priv->by_item, item);
+  remove_entry(view, entry);
+  unwatch_service(view, item->service);
+  entry_free(entry);
+}
+
+static void
+on_item_changed(AccountsModel *model, AccountItem *item, guint n_pspecs,
+                GParamSpec **pspecs, AccountsSortedView *view)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+  SortEntry *entry = g_hash_table_lookup(priv->by_item, item);
+  gboolean name_changed = FALSE;
+  guint position;
+  gchar *key;
+  guint i;
+
+  if (!entry)
+    return;
+
+  for (i = 0; i < n_pspecs; i++)
+  {
+    if (!strcmp(pspecs[i]->name, "display-name") ||
+        !strcmp(pspecs[i]->name, "name"))
+    {
+      name_changed = TRUE;
+      break;
+    }
+  }
+
+  if (!name_changed)
+    return;
+
+  key = collate_key(item);
+
+  if (!strcmp(key, entry->key))
+  {
+    g_free(key);
+    return;
+  }
+
+  /* find it while the old key is still in place */
+  position = lower_bound(priv, entry);
+  g_free(entry->key);
+  entry->key = key;
+  reposition_entry(view, entry, position);
+}
+
+static void
+accounts_sorted_view_constructed(GObject *object)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(object);
+  GList *items;
+  GList *l;
+
+  G_OBJECT_CLASS(accounts_sorted_view_parent_class)->constructed(object);
+
+  if (!priv->model)
+    return;
+
+  g_signal_connect(priv->model, "item-added",
+                   G_CALLBACK(on_item_added), object);
+  g_signal_connect(priv->model, "item-removed",
+                   G_CALLBACK(on_item_removed), object);
+  g_signal_connect(priv->model, "item-changed",
+                   G_CALLBACK(on_item_changed), object);
+
+  items = accounts_model_list(priv->model);
+
+  for (l = items; l; l = l->next)
+  {
+    SortEntry *entry = entry_new(priv, l->data);
+
+    g_hash_table_insert(priv->by_item, l->data, entry);
+    g_ptr_array_add(priv->entries, entry);
+    watch_service(ACCOUNTS_SORTED_VIEW(object), entry->item->service);
+  }
+
+  g_list_free(items);
+  g_ptr_array_sort(priv->entries, compare_entries_indirect);
+}
+
+static void
+accounts_sorted_view_dispose(GObject *object)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(object);
+  GHashTableIter iter;
+  gpointer service;
+
+  if (priv->model)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->model, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->model);
+    priv->model = NULL;
+  }
+
+  g_hash_table_iter_init(&iter, priv->services);
+
+  while (g_hash_table_iter_next(&iter, &service, NULL))
+  {
+    g_signal_handlers_disconnect_by_func(service, on_priority_notify, object);
+    g_object_unref(service);
+    g_hash_table_iter_remove(&iter);
+  }
+
+  g_hash_table_remove_all(priv->by_item);
+  g_ptr_array_set_size(priv->entries, 0);
+
+  G_OBJECT_CLASS(accounts_sorted_view_parent_class)->dispose(object);
+}
+
+static void
+accounts_sorted_view_finalize(GObject *object)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(object);
+
+  g_hash_table_destroy(priv->by_item);
+  g_hash_table_destroy(priv->services);
+  g_ptr_array_free(priv->entries, TRUE);
+
+  G_OBJECT_CLASS(accounts_sorted_view_parent_class)->finalize(object);
+}
+
+static void
+accounts_sorted_view_set_property(GObject *object, guint property_id,
+                                  const GValue *value, GParamSpec *pspec)
+{
+  AccountsSortedViewPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SORTED_VIEW(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      priv->model = g_value_dup_object(value);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_sorted_view_get_property(GObject *object, guint property_id,
+                                  GValue *value, GParamSpec *pspec)
+{
+  AccountsSortedViewPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SORTED_VIEW(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      g_value_set_object(value, priv->model);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_sorted_view_class_init(AccountsSortedViewClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_sorted_view_constructed;
+  object_class->dispose = accounts_sorted_view_dispose;
+  object_class->finalize = accounts_sorted_view_finalize;
+  object_class->set_property = accounts_sorted_view_set_property;
+  object_class->get_property = accounts_sorted_view_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_MODEL,
+    g_param_spec_object(
+      "model",
+      "Model",
+      "AccountsModel being sorted",
+      ACCOUNTS_TYPE_MODEL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+
+  signals[ITEM_INSERTED] = g_signal_new(
+      "item-inserted", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsSortedViewClass, item_inserted), NULL, NULL,
+      account_marshal_VOID__OBJECT_UINT, G_TYPE_NONE, 2,
+      ACCOUNT_TYPE_ITEM, G_TYPE_UINT);
+  signals[ITEM_REMOVED] = g_signal_new(
+      "item-removed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsSortedViewClass, item_removed), NULL, NULL,
+      account_marshal_VOID__OBJECT_UINT, G_TYPE_NONE, 2,
+      ACCOUNT_TYPE_ITEM, G_TYPE_UINT);
+}
+
+static void
+accounts_sorted_view_init(AccountsSortedView *view)
+{
+  AccountsSortedViewPrivate *priv = PRIVATE(view);
+
+  priv->entries = g_ptr_array_new();
+  priv->by_item = g_hash_table_new_full(NULL, NULL, NULL,
+                                        (GDestroyNotify)entry_free);
+  priv->services = g_hash_table_new(NULL, NULL);
+}
+
+/**
+ * accounts_sorted_view_new:
+ * @model: the #AccountsModel to sort.
+ *
+ * Creates an #AccountsSortedView presenting the accounts of @model.
+ *
+ * Returns:(transfer full): a new #AccountsSortedView.
+ */
+AccountsSortedView *
+accounts_sorted_view_new(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_SORTED_VIEW, "model", model, NULL);
+}
+
+/**
+ * accounts_sorted_view_get_n_items:
+ * @view: the #AccountsSortedView.
+ *
+ * Returns: the number of accounts in @view.
+ */
+guint
+accounts_sorted_view_get_n_items(AccountsSortedView *view)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_SORTED_VIEW(view), 0);
+
+  return PRIVATE(view)->entries->len;
+}
+
+/**
+ * accounts_sorted_view_get_item:
+ * @view: the #AccountsSortedView.
+ * @position: a position, lower than accounts_sorted_view_get_n_items().
+ *
+ * Gets the account at @position.
+ *
+ * Returns:(transfer none): an #AccountItem.
+ */
+AccountItem *
+accounts_sorted_view_get_item(AccountsSortedView *view, guint position)
+{
+  AccountsSortedViewPrivate *priv;
+  SortEntry *entry;
+
+  g_return_val_if_fail(ACCOUNTS_IS_SORTED_VIEW(view), NULL);
+
+  priv = PRIVATE(view);
+
+  g_return_val_if_fail(position < priv->entries->len, NULL);
+
+  entry = g_ptr_array_index(priv->entries, position);
+
+  return entry->item;
+}
+
+/**
+ * accounts_sorted_view_get_position:
+ * @view: the #AccountsSortedView.
+ * @item: an #AccountItem.
+ *
+ * Gets the position of @item in @view, in logarithmic time.
+ *
+ * Returns: the position of @item, or -1 if @item is not part of @view.
+ */
+gint
+accounts_sorted_view_get_position(AccountsSortedView *view, AccountItem *item)
+{
+  AccountsSortedViewPrivate *priv;
+  SortEntry *entry;
+
+  g_return_val_if_fail(ACCOUNTS_IS_SORTED_VIEW(view), -1);
+
+  priv = PRIVATE(view);
+  entry = g_hash_table_lookup(priv->by_item, item);
+
+  if (!entry)
+    return -1;
+
+  return lower_bound(priv, entry);
+}
@@ -0,0 +1,67 @@
+/*
+ * accounts-sorted-view.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_SORTED_VIEW_H_
+#define _ACCOUNTS_SORTED_VIEW_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_SORTED_VIEW             (accounts_sorted_view_get_type ())
+#define ACCOUNTS_SORTED_VIEW(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_SORTED_VIEW, AccountsSortedView))
+#define ACCOUNTS_SORTED_VIEW_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_SORTED_VIEW, AccountsSortedViewClass))
+#define ACCOUNTS_IS_SORTED_VIEW(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_SORTED_VIEW))
+#define ACCOUNTS_IS_SORTED_VIEW_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_SORTED_VIEW))
+#define ACCOUNTS_SORTED_VIEW_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_SORTED_VIEW, AccountsSortedViewClass))
+
+typedef struct _AccountsSortedViewClass AccountsSortedViewClass;
+typedef struct _AccountsSortedView AccountsSortedView;
+
+#include "accounts-model.h"
+
+struct _AccountsSortedViewClass
+{
+    GObjectClass parent_class;
+
+    /* signals */
+    void (*item_inserted) (AccountsSortedView *view, AccountItem *item,
+                           guint position);
+    void (*item_removed) (AccountsSortedView *view, AccountItem *item,
+                          guint position);
+};
+
+struct _AccountsSortedView
+{
+    GObject parent_instance;
+};
+
+GType accounts_sorted_view_get_type (void) G_GNUC_CONST;
+
+AccountsSortedView *accounts_sorted_view_new (AccountsModel *model);
+
+guint accounts_sorted_view_get_n_items (AccountsSortedView *view);
+AccountItem *accounts_sorted_view_get_item (AccountsSortedView *view,
+                                            guint position);
+gint accounts_sorted_view_get_position (AccountsSortedView *view,
+                                        AccountItem *item);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_SORTED_VIEW_H_ */
@@ -0,0 +1,563 @@
+/*
+ * accounts-summary.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-summary
+ * @short_description: aggregate state of the accounts.
+ *
+ * An #AccountsSummary counts the accounts of an #AccountsModel by state: how
+ * many are connected, enabled but offline, disabled, or drafts. The counters
+ * are kept for all the accounts, as the #AccountsSummary:n-accounts,
+ * #AccountsSummary:n-online, #AccountsSummary:n-offline,
+ * #AccountsSummary:n-disabled and #AccountsSummary:n-draft properties, and for
+ * the accounts of every single service, see
+ * accounts_summary_get_service_counts().
+ *
+ * The summary remembers the state it last counted for each account, so a
+ * property change costs a constant amount of work. Properties are only
+ * notified, and #AccountsSummary::service-changed only emitted, when a
+ * counter actually changes.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "accounts-summary.h"
+#include "accounts-private.h"
+
+/* what an account contributes to the counters, one bit per counter */
+#define STATE_PRESENT  (1 << 0)
+#define STATE_ONLINE   (1 << 1)
+#define STATE_OFFLINE  (1 << 2)
+#define STATE_DISABLED (1 << 3)
+#define STATE_DRAFT    (1 << 4)
+#define N_STATES       5
+
+typedef struct _SummaryItem
+{
+  /* interned */
+  const gchar *service;
+  guint state;
+} SummaryItem;
+
+struct _AccountsSummaryPrivate
+{
+  AccountsModel *model;
+  AccountsSummaryCounts counts;
+  /* interned service name -> AccountsSummaryCounts */
+  GHashTable *services;
+  /* AccountItem -> SummaryItem */
+  GHashTable *items;
+};
+
+typedef struct _AccountsSummaryPrivate AccountsSummaryPrivate;
+
+#define PRIVATE(summary) \
+  ((AccountsSummaryPrivate *) \
+   accounts_summary_get_instance_private((AccountsSummary *)(summary)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsSummary,
+  accounts_summary,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_MODEL = 1,
+  PROP_N_ACCOUNTS,
+  PROP_N_ONLINE,
+  PROP_N_OFFLINE,
+  PROP_N_DISABLED,
+  PROP_N_DRAFT
+};
+
+/* indexed by state bit */
+static const gchar *state_properties[N_STATES] =
+{
+  "n-accounts",
+  "n-online",
+  "n-offline",
+  "n-disabled",
+  "n-draft"
+};
+
+enum
+{
+  SERVICE_CHANGED,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+static guint
+item_get_state(AccountItem *item)
+{
+  guint state = STATE_PRESENT;
+
+  if (item->connected)
+    state |= STATE_ONLINE;
+  else if (item->enabled)
+    state |= STATE_OFFLINE;
+
+  if (!item->enabled)
+    state |= STATE_DISABLED;
+
+  if (item->draft)
+    state |= STATE_DRAFT;
+
+  return state;
+}
+
+static guint *
+counts_field(AccountsSummaryCounts *counts, guint bit)
+{
+  switch (bit)
+  {
+    case 0:
+      return &counts->total;
+    case 1:
+      return &counts->online;
+    case 2:
+      return &counts->offline;
+    case 3:
+      return &counts->disabled;
+    default:
+      return &counts->draft;
+  }
+}
+
+static void
+update_counts(AccountsSummaryCounts *counts, guint old_state, guint new_state)
+{
+  guint changed = old_state ^ new_state;
+  guint i;
+
+  for (i = 0; i < N_STATES; i++)
+  {
+    if (!(changed & (1 << i)))
+      continue;
+
+    if (new_state & (1 << i))
+      (*counts_field(counts, i))++;
+    else
+      (*counts_field(counts, i))--;
+  }
+}
+
+static void
+set_item_state(AccountsSummary *summary, SummaryItem *summary_item,
+               guint state)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(summary);
+  guint changed = summary_item->state ^ state;
+  guint i;
+
+  if (!changed)
+    return;
+
+  update_counts(&priv->counts, summary_item->state, state);
+
+  if (summary_item->service)
+  {
+    AccountsSummaryCounts *counts = g_hash_table_lookup(
+        priv->services, summary_item->service);
+
+    if (!counts)
+    {
+      counts = g_slice_new0(AccountsSummaryCounts);
+      g_hash_table_insert(priv->services, (gpointer)summary_item->service,
+                          counts);
+    }
+
+    update_counts(counts, summary_item->state, state);
+
+    if (!counts->total)
+      g_hash_table_remove(priv->services, summary_item->service);
+  }
+
+  summary_item->state = state;
+
+  /* a single account moved, so every changed bit is a changed counter */
+  g_object_freeze_notify(G_OBJECT(summary));
+
+  for (i = 0; i < N_STATES; i++)
+  {
+    if (changed & (1 << i))
+      g_object_notify(G_OBJECT(summary), state_properties[i]);
+  }
+
+  g_object_thaw_notify(G_OBJECT(summary));
+
+  if (summary_item->service)
+  {
+    g_signal_emit(summary, signals[SERVICE_CHANGED], 0,
+                  summary_item->service);
+  }
+}
+
+static void
+counts_free(AccountsSummaryCounts *counts)
+{
+  g_slice_free(AccountsSummaryCounts, counts);
+}
+
+static void
+summary_item_free(SummaryItem *summary_item)
+{
+  g_slice_free(SummaryItem, summary_item);
+}
+
+static void
+on_item_added(AccountsModel *model, AccountItem *item,
+              AccountsSummary *summary)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(summary);
+  SummaryItem *summary_item;
+
+  if (g_hash_table_contains(priv->items, item))
+    return;
+
+  summary_item = g_slice_new0(SummaryItem);
+
+  if (item->service)
+  {
+    summary_item->service =
+      g_intern_string(account_service_get_name(item->service));
+  }
+
+  g_hash_table_insert(priv->items, item, summary_item);
+  set_item_state(summary, summary_item, item_get_state(item));
+}
+
+static void
+on_item_removed(AccountsModel *model, AccountItem *item,
+                AccountsSummary *summary)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(summary);
+  SummaryItem *summary_item = g_hash_table_lookup(priv->items, item);
+
+  if (!summary_item)
+    return;
+
+  g_hash_table_steal(priv->items, item);
+  set_item_state(summary, summary_item, 0);
+  summary_item_free(summary_item);
+}
+
+static void
+on_item_changed(AccountsModel *model, AccountItem *item, guint n_pspecs,
+                GParamSpec **pspecs, AccountsSummary *summary)
+{
+  SummaryItem *summary_item = g_hash_table_lookup(PRIVATE(summary)->items,
+                                                  item);
+  guint i;
+
+  if (!summary_item)
+    return;
+
+  for (i = 0; i < n_pspecs; i++)
+  {
+    if (!strcmp(pspecs[i]->name, "enabled") ||
+        !strcmp(pspecs[i]->name, "connected") ||
+        !strcmp(pspecs[i]->name, "draft"))
+    {
+      set_item_state(summary, summary_item, item_get_state(item));
+      break;
+    }
+  }
+}
+
+static void
+accounts_summary_constructed(GObject *object)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(object);
+  GList *items;
+  GList *l;
+
+  G_OBJECT_CLASS(accounts_summary_parent_class)->constructed(object);
+
+  if (!priv->model)
+    return;
+
+  g_signal_connect(priv->model, "item-added",
+                   G_CALLBACK(on_item_added), object);
+  g_signal_connect(priv->model, "item-removed",
+                   G_CALLBACK(on_item_removed), object);
+  g_signal_connect(priv->model, "item-changed",
+                   G_CALLBACK(on_item_changed), object);
+
+  items = accounts_model_list(priv->model);
+
+  for (l = items; l; l = l->next)
+    on_item_added(priv->model, l->data, ACCOUNTS_SUMMARY(object));
+
+  g_list_free(items);
+}
+
+static void
+accounts_summary_dispose(GObject *object)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(object);
+
+  if (priv->model)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->model, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->model);
+    priv->model = NULL;
+  }
+
+  G_OBJECT_CLASS(accounts_summary_parent_class)->dispose(object);
+}
+
+static void
+accounts_summary_finalize(GObject *object)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(object);
+
+  g_hash_table_destroy(priv->items);
+  g_hash_table_destroy(priv->services);
+
+  G_OBJECT_CLASS(accounts_summary_parent_class)->finalize(object);
+}
+
+static void
+accounts_summary_set_property(GObject *object, guint property_id,
+                              const GValue *value, GParamSpec *pspec)
+{
+  AccountsSummaryPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SUMMARY(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      priv->model = g_value_dup_object(value);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_summary_get_property(GObject *object, guint property_id,
+                              GValue *value, GParamSpec *pspec)
+{
+  AccountsSummaryPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_SUMMARY(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      g_value_set_object(value, priv->model);
+      break;
+    }
+    case PROP_N_ACCOUNTS:
+    {
+      g_value_set_uint(value, priv->counts.total);
+      break;
+    }
+    case PROP_N_ONLINE:
+    {
+      g_value_set_uint(value, priv->counts.online);
+      break;
+    }
+    case PROP_N_OFFLINE:
+    {
+      g_value_set_uint(value, priv->counts.offline);
+      break;
+    }
+    case PROP_N_DISABLED:
+    {
+      g_value_set_uint(value, priv->counts.disabled);
+      break;
+    }
+    case PROP_N_DRAFT:
+    {
+      g_value_set_uint(value, priv->counts.draft);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_summary_class_init(AccountsSummaryClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_summary_constructed;
+  object_class->dispose = accounts_summary_dispose;
+  object_class->finalize = accounts_summary_finalize;
+  object_class->set_property = accounts_summary_set_property;
+  object_class->get_property = accounts_summary_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_MODEL,
+    g_param_spec_object(
+      "model",
+      "Model",
+      "AccountsModel being summarized",
+      ACCOUNTS_TYPE_MODEL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_N_ACCOUNTS,
+    g_param_spec_uint(
+      "n-accounts",
+      "Accounts",
+      "Number of accounts",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE));
+  g_object_class_install_property(
+    object_class, PROP_N_ONLINE,
+    g_param_spec_uint(
+      "n-online",
+      "Online",
+      "Number of connected accounts",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE));
+  g_object_class_install_property(
+    object_class, PROP_N_OFFLINE,
+    g_param_spec_uint(
+      "n-offline",
+      "Offline",
+      "Number of enabled accounts which are not connected",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE));
+  g_object_class_install_property(
+    object_class, PROP_N_DISABLED,
+    g_param_spec_uint(
+      "n-disabled",
+      "Disabled",
+      "Number of disabled accounts",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE));
+  g_object_class_install_property(
+    object_class, PROP_N_DRAFT,
+    g_param_spec_uint(
+      "n-draft",
+      "Draft",
+      "Number of draft accounts",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE));
+
+  signals[SERVICE_CHANGED] = g_signal_new(
+      "service-changed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET(AccountsSummaryClass, service_changed), NULL, NULL,
+      g_cclosure_marshal_VOID__STRING, G_TYPE_NONE, 1,
+      G_TYPE_STRING | G_SIGNAL_TYPE_STATIC_SCOPE);
+}
+
+static void
+accounts_summary_init(AccountsSummary *summary)
+{
+  AccountsSummaryPrivate *priv = PRIVATE(summary);
+
+  priv->services = g_hash_table_new_full(NULL, NULL, NULL,
+                                         (GDestroyNotify)counts_free);
+  priv->items = g_hash_table_new_full(NULL, NULL, NULL,
+                                      (GDestroyNotify)summary_item_free);
+}
+
+/**
+ * accounts_summary_new:
+ * @model: the #AccountsModel to summarize.
+ *
+ * Creates an #AccountsSummary counting the accounts of @model.
+ *
+ * Returns:(transfer full): a new #AccountsSummary.
+ */
+AccountsSummary *
+accounts_summary_new(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_SUMMARY, "model", model, NULL);
+}
+
+/**
+ * accounts_summary_get_counts:
+ * @summary: the #AccountsSummary.
+ * @counts:(out caller-allocates): return location for the counters.
+ *
+ * Gets the counters for all the accounts.
+ */
+void
+accounts_summary_get_counts(AccountsSummary *summary,
+                            AccountsSummaryCounts *counts)
+{
+  g_return_if_fail(ACCOUNTS_IS_SUMMARY(summary));
+  g_return_if_fail(counts != NULL);
+
+  *counts = PRIVATE(summary)->counts;
+}
+
+/**
+ * accounts_summary_get_service_counts:
+ * @summary: the #AccountsSummary.
+ * @service: the name of an #AccountService.
+ * @counts:(out caller-allocates): return location for the counters.
+ *
+ * Gets the counters for the accounts of @service.
+ *
+ * Returns: %TRUE if @service has accounts, %FALSE otherwise, in which case
+ * @counts is set to zero.
+ */
+gboolean
+accounts_summary_get_service_counts(AccountsSummary *summary,
+                                    const gchar *service,
+                                    AccountsSummaryCounts *counts)
+{
+  AccountsSummaryCounts *service_counts;
+
+  g_return_val_if_fail(ACCOUNTS_IS_SUMMARY(summary), FALSE);
+  g_return_val_if_fail(service != NULL, FALSE);
+  g_return_val_if_fail(counts != NULL, FALSE);
+
+  service = _accounts_lookup_interned(service);
+  service_counts = service ?
+    g_hash_table_lookup(PRIVATE(summary)->services, service) : NULL;
+
+  if (!service_counts)
+  {
+    memset(counts, 0, sizeof(*counts));
+    return FALSE;
+  }
+
+  *counts = *service_counts;
+
+  return TRUE;
+}
@@ -0,0 +1,85 @@
+/*
+ * accounts-summary.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_SUMMARY_H_
+#define _ACCOUNTS_SUMMARY_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_SUMMARY             (accounts_summary_get_type ())
+#define ACCOUNTS_SUMMARY(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_SUMMARY, AccountsSummary))
+#define ACCOUNTS_SUMMARY_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_SUMMARY, AccountsSummaryClass))
+#define ACCOUNTS_IS_SUMMARY(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_SUMMARY))
+#define ACCOUNTS_IS_SUMMARY_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_SUMMARY))
+#define ACCOUNTS_SUMMARY_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_SUMMARY, AccountsSummaryClass))
+
+typedef struct _AccountsSummaryClass AccountsSummaryClass;
+typedef struct _AccountsSummary AccountsSummary;
+
+#include "accounts-model.h"
+
+typedef struct _AccountsSummaryCounts AccountsSummaryCounts;
+
+/**
+ * AccountsSummaryCounts:
+ * @total: the number of accounts.
+ * @online: the number of connected accounts.
+ * @offline: the number of enabled accounts which are not connected.
+ * @disabled: the number of disabled accounts.
+ * @draft: the number of draft accounts.
+ *
+ * Account counters, for all the accounts or for those of a single service.
+ */
+struct _AccountsSummaryCounts
+{
+    guint total;
+    guint online;
+    guint offline;
+    guint disabled;
+    guint draft;
+};
+
+struct _AccountsSummaryClass
+{
+    GObjectClass parent_class;
+
+    /* signals */
+    void (*service_changed) (AccountsSummary *summary, const gchar *service);
+};
+
+struct _AccountsSummary
+{
+    GObject parent_instance;
+};
+
+GType accounts_summary_get_type (void) G_GNUC_CONST;
+
+AccountsSummary *accounts_summary_new (AccountsModel *model);
+
+void accounts_summary_get_counts (AccountsSummary *summary,
+                                  AccountsSummaryCounts *counts);
+gboolean accounts_summary_get_service_counts (AccountsSummary *summary,
+                                              const gchar *service,
+                                              AccountsSummaryCounts *counts);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_SUMMARY_H_ */
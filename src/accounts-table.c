@@ -0,0 +1,518 @@
+/*
+ * accounts-table.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-table
+ * @short_description: compact, column-wise copy of the accounts.
+ *
+ * An #AccountsTable keeps the fields of the accounts of an #AccountsModel most
+ * often needed to render or export them in plain contiguous arrays, one per
+ * field: identifiers, names, display names, service names and state bits. A
+ * row is the same index in every array. Strings are shared between the rows,
+ * and with the #AccountsSnapshot records, which have the same value.
+ *
+ * Walking the arrays doesn't involve the #GObject machinery at all. They are
+ * updated as the accounts change; rows are not kept in any particular order,
+ * and removing a row moves the last one in its place. Every change increases
+ * the value returned by accounts_table_get_stamp() and may reallocate the
+ * arrays, so pointers obtained from the table must not be kept across main
+ * loop iterations.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "accounts-table.h"
+#include "accounts-private.h"
+
+struct _AccountsTablePrivate
+{
+  AccountsModel *model;
+  guint stamp;
+  /* columns, all of the same length */
+  GArray *ids;
+  GArray *names;
+  GArray *display_names;
+  GArray *service_names;
+  GArray *flags;
+  GArray *items;
+  /* AccountItem -> row + 1 */
+  GHashTable *rows;
+};
+
+typedef struct _AccountsTablePrivate AccountsTablePrivate;
+
+#define PRIVATE(table) \
+  ((AccountsTablePrivate *) \
+   accounts_table_get_instance_private((AccountsTable *)(table)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsTable,
+  accounts_table,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_MODEL = 1
+};
+
+static guint8
+item_get_flags(AccountItem *item)
+{
+  guint8 flags = 0;
+
+  if (item->enabled)
+    flags |= ACCOUNTS_TABLE_ENABLED;
+
+  if (item->draft)
+    flags |= ACCOUNTS_TABLE_DRAFT;
+
+  if (item->connected)
+    flags |= ACCOUNTS_TABLE_CONNECTED;
+
+  if (item->supports_avatar)
+    flags |= ACCOUNTS_TABLE_SUPPORTS_AVATAR;
+
+  return flags;
+}
+
+static void
+set_string(GArray *column, guint row, const gchar *value)
+{
+  gchar **cell = &g_array_index(column, gchar *, row);
+  gchar *old = *cell;
+
+  *cell = _accounts_ref_string_intern(value);
+  _accounts_ref_string_release(old);
+}
+
+static void
+clear_string(gpointer cell)
+{
+  _accounts_ref_string_release(*(gchar **)cell);
+}
+
+static void
+fill_row(AccountsTablePrivate *priv, guint row, AccountItem *item)
+{
+  set_string(priv->names, row, item->name);
+  set_string(priv->display_names, row, item->display_name);
+  set_string(priv->service_names, row, item->service_name);
+  g_array_index(priv->flags, guint8, row) = item_get_flags(item);
+}
+
+static void
+on_item_added(AccountsModel *model, AccountItem *item, AccountsTable *table)
+{
+  AccountsTablePrivate *priv = PRIVATE(table);
+  guint row = priv->ids->len;
+  guint id;
+
+  if (g_hash_table_contains(priv->rows, item))
+    return;
+
+  id = accounts_model_get_item_id(model, item);
+  g_array_append_val(priv->ids, id);
+  g_array_set_size(priv->names, row + 1);
+  g_array_set_size(priv->display_names, row + 1);
+  g_array_set_size(priv->service_names, row + 1);
+  g_array_set_size(priv->flags, row + 1);
+  g_array_append_val(priv->items, item);
+  fill_row(priv, row, item);
+
+  g_hash_table_insert(priv->rows, g_object_ref(item),
+                      GUINT_TO_POINTER(row + 1));
+  priv->stamp++;
+}
+
+static void
+on_item_removed(AccountsModel *model, AccountItem *item,
+                AccountsTable *table)
+{
+  AccountsTablePrivate *priv = PRIVATE(table);
+  guint row = GPOINTER_TO_UINT(g_hash_table_lookup(priv->rows, item));
+  guint last = priv->ids->len;
+
+  if (!row)
+    return;
+
+  row--;
+  last--;
+
+  if (row != last)
+  {
+    g_hash_table_insert(priv->rows,
+                        g_object_ref(g_array_index(priv->items, AccountItem *,
+                                                   last)),
+                        GUINT_TO_POINTER(row + 1));
+  }
+
+  g_array_remove_index_fast(priv->ids, row);
+  g_array_remove_index_fast(priv->names, row);
+  g_array_remove_index_fast(priv->display_names, row);
+  g_array_remove_index_fast(priv->service_names, row);
+  g_array_remove_index_fast(priv->flags, row);
+  g_array_remove_index_fast(priv->items, row);
+
+  g_hash_table_remove(priv->rows, item);
+  priv->stamp++;
+}
+
+static void
+on_item_changed(AccountsModel *model, AccountItem *item, guint n_pspecs,
+                GParamSpec **pspecs, AccountsTable *table)
+{
+  AccountsTablePrivate *priv = PRIVATE(table);
+  guint row = GPOINTER_TO_UINT(g_hash_table_lookup(priv->rows, item));
+  guint i;
+
+  if (!row)
+    return;
+
+  for (i = 0; i < n_pspecs; i++)
+  {
+    const gchar *name = pspecs[i]->name;
+
+    if (!strcmp(name, "name") || !strcmp(name, "display-name") ||
+        !strcmp(name, "service-name") || !strcmp(name, "enabled") ||
+        !strcmp(name, "draft") || !strcmp(name, "connected") ||
+        !strcmp(name, "supports-avatar"))
+    {
+      fill_row(priv, row - 1, item);
+      priv->stamp++;
+      break;
+    }
+  }
+}
+
+static void
+accounts_table_constructed(GObject *object)
+{
+  AccountsTablePrivate *priv = PRIVATE(object);
+  GList *items;
+  GList *l;
+
+  G_OBJECT_CLASS(accounts_table_parent_class)->constructed(object);
+
+  if (!priv->model)
+    return;
+
+  g_signal_connect(priv->model, "item-added",
+                   G_CALLBACK(on_item_added), object);
+  g_signal_connect(priv->model, "item-removed",
+                   G_CALLBACK(on_item_removed), object);
+  g_signal_connect(priv->model, "item-changed",
+                   G_CALLBACK(on_item_changed), object);
+
+  items = accounts_model_list(priv->model);
+
+  for (l = items; l; l = l->next)
+    on_item_added(priv->model, l->data, ACCOUNTS_TABLE(object));
+
+  g_list_free(items);
+}
+
+static void
+accounts_table_dispose(GObject *object)
+{
+  AccountsTablePrivate *priv = PRIVATE(object);
+
+  if (priv->model)
+  {
+    g_signal_handlers_disconnect_matched(
+      priv->model, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, object);
+    g_object_unref(priv->model);
+    priv->model = NULL;
+  }
+
+  g_array_set_size(priv->ids, 0);
+  g_array_set_size(priv->names, 0);
+  g_array_set_size(priv->display_names, 0);
+  g_array_set_size(priv->service_names, 0);
+  g_array_set_size(priv->flags, 0);
+  g_array_set_size(priv->items, 0);
+  g_hash_table_remove_all(priv->rows);
+
+  G_OBJECT_CLASS(accounts_table_parent_class)->dispose(object);
+}
+
+static void
+accounts_table_finalize(GObject *object)
+{
+  AccountsTablePrivate *priv = PRIVATE(object);
+
+  g_array_free(priv->ids, TRUE);
+  g_array_free(priv->names, TRUE);
+  g_array_free(priv->display_names, TRUE);
+  g_array_free(priv->service_names, TRUE);
+  g_array_free(priv->flags, TRUE);
+  g_array_free(priv->items, TRUE);
+  g_hash_table_destroy(priv->rows);
+
+  G_OBJECT_CLASS(accounts_table_parent_class)->finalize(object);
+}
+
+static void
+accounts_table_set_property(GObject *object, guint property_id,
+                            const GValue *value, GParamSpec *pspec)
+{
+  AccountsTablePrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_TABLE(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      priv->model = g_value_dup_object(value);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_table_get_property(GObject *object, guint property_id,
+                            GValue *value, GParamSpec *pspec)
+{
+  AccountsTablePrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_TABLE(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MODEL:
+    {
+      g_value_set_object(value, priv->model);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_table_class_init(AccountsTableClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->constructed = accounts_table_constructed;
+  object_class->dispose = accounts_table_dispose;
+  object_class->finalize = accounts_table_finalize;
+  object_class->set_property = accounts_table_set_property;
+  object_class->get_property = accounts_table_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_MODEL,
+    g_param_spec_object(
+      "model",
+      "Model",
+      "AccountsModel being tabulated",
+      ACCOUNTS_TYPE_MODEL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+}
+
+static void
+accounts_table_init(AccountsTable *table)
+{
+  AccountsTablePrivate *priv = PRIVATE(table);
+
+  priv->ids = g_array_new(FALSE, FALSE, sizeof(guint));
+  /* cleared, as fill_row() releases the previous strings */
+  priv->names = g_array_new(FALSE, TRUE, sizeof(gchar *));
+  priv->display_names = g_array_new(FALSE, TRUE, sizeof(gchar *));
+  priv->service_names = g_array_new(FALSE, TRUE, sizeof(gchar *));
+  g_array_set_clear_func(priv->names, clear_string);
+  g_array_set_clear_func(priv->display_names, clear_string);
+  g_array_set_clear_func(priv->service_names, clear_string);
+  priv->flags = g_array_new(FALSE, FALSE, sizeof(guint8));
+  priv->items = g_array_new(FALSE, FALSE, sizeof(AccountItem *));
+  priv->rows = g_hash_table_new_full(NULL, NULL, g_object_unref, NULL);
+}
+
+/**
+ * accounts_table_new:
+ * @model: the #AccountsModel to follow.
+ *
+ * Creates an #AccountsTable holding the accounts of @model.
+ *
+ * Returns:(transfer full): a new #AccountsTable.
+ */
+AccountsTable *
+accounts_table_new(AccountsModel *model)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_MODEL(model), NULL);
+
+  return g_object_new(ACCOUNTS_TYPE_TABLE, "model", model, NULL);
+}
+
+/**
+ * accounts_table_get_n_rows:
+ * @table: the #AccountsTable.
+ *
+ * Returns: the number of rows, which is the length of every column.
+ */
+guint
+accounts_table_get_n_rows(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), 0);
+
+  return PRIVATE(table)->ids->len;
+}
+
+/**
+ * accounts_table_get_stamp:
+ * @table: the #AccountsTable.
+ *
+ * Gets a number which changes every time the content of @table does.
+ *
+ * Returns: the current stamp.
+ */
+guint
+accounts_table_get_stamp(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), 0);
+
+  return PRIVATE(table)->stamp;
+}
+
+/**
+ * accounts_table_get_ids:
+ * @table: the #AccountsTable.
+ *
+ * Returns:(transfer none)(array): the identifier of the account of each row,
+ * see accounts_model_get_item_id().
+ */
+const guint *
+accounts_table_get_ids(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), NULL);
+
+  return (const guint *)PRIVATE(table)->ids->data;
+}
+
+/**
+ * accounts_table_get_names:
+ * @table: the #AccountsTable.
+ *
+ * Returns:(transfer none)(array): the #AccountItem:name of the account of
+ * each row.
+ */
+const gchar * const *
+accounts_table_get_names(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), NULL);
+
+  return (const gchar * const *)PRIVATE(table)->names->data;
+}
+
+/**
+ * accounts_table_get_display_names:
+ * @table: the #AccountsTable.
+ *
+ * Returns:(transfer none)(array): the #AccountItem:display-name of the
+ * account of each row.
+ */
+const gchar * const *
+accounts_table_get_display_names(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), NULL);
+
+  return (const gchar * const *)PRIVATE(table)->display_names->data;
+}
+
+/**
+ * accounts_table_get_service_names:
+ * @table: the #AccountsTable.
+ *
+ * Returns:(transfer none)(array): the #AccountItem:service-name of the
+ * account of each row.
+ */
+const gchar * const *
+accounts_table_get_service_names(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), NULL);
+
+  return (const gchar * const *)PRIVATE(table)->service_names->data;
+}
+
+/**
+ * accounts_table_get_flags:
+ * @table: the #AccountsTable.
+ *
+ * Returns:(transfer none)(array): the #AccountsTableFlags of the account of
+ * each row.
+ */
+const guint8 *
+accounts_table_get_flags(AccountsTable *table)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), NULL);
+
+  return (const guint8 *)PRIVATE(table)->flags->data;
+}
+
+/**
+ * accounts_table_get_item:
+ * @table: the #AccountsTable.
+ * @row: a row, lower than accounts_table_get_n_rows().
+ *
+ * Returns:(transfer none): the #AccountItem of @row.
+ */
+AccountItem *
+accounts_table_get_item(AccountsTable *table, guint row)
+{
+  AccountsTablePrivate *priv;
+
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), NULL);
+
+  priv = PRIVATE(table);
+
+  g_return_val_if_fail(row < priv->items->len, NULL);
+
+  return g_array_index(priv->items, AccountItem *, row);
+}
+
+/**
+ * accounts_table_get_row:
+ * @table: the #AccountsTable.
+ * @item: an #AccountItem.
+ *
+ * Returns: the row of @item, or -1 if @item is not part of @table.
+ */
+gint
+accounts_table_get_row(AccountsTable *table, AccountItem *item)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_TABLE(table), -1);
+
+  return (gint)GPOINTER_TO_UINT(
+        g_hash_table_lookup(PRIVATE(table)->rows, item)) - 1;
+}
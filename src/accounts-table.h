@@ -0,0 +1,85 @@
+/*
+ * accounts-table.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_TABLE_H_
+#define _ACCOUNTS_TABLE_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_TABLE             (accounts_table_get_type ())
+#define ACCOUNTS_TABLE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_TABLE, AccountsTable))
+#define ACCOUNTS_TABLE_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_TABLE, AccountsTableClass))
+#define ACCOUNTS_IS_TABLE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_TABLE))
+#define ACCOUNTS_IS_TABLE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_TABLE))
+#define ACCOUNTS_TABLE_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_TABLE, AccountsTableClass))
+
+typedef struct _AccountsTableClass AccountsTableClass;
+typedef struct _AccountsTable AccountsTable;
+
+#include "accounts-model.h"
+
+/**
+ * AccountsTableFlags:
+ * @ACCOUNTS_TABLE_ENABLED: the #AccountItem:enabled property is set.
+ * @ACCOUNTS_TABLE_DRAFT: the #AccountItem:draft property is set.
+ * @ACCOUNTS_TABLE_CONNECTED: the #AccountItem:connected property is set.
+ * @ACCOUNTS_TABLE_SUPPORTS_AVATAR: the #AccountItem:supports-avatar property
+ * is set.
+ *
+ * The state bits of a row of an #AccountsTable.
+ */
+typedef enum
+{
+    ACCOUNTS_TABLE_ENABLED = 1 << 0,
+    ACCOUNTS_TABLE_DRAFT = 1 << 1,
+    ACCOUNTS_TABLE_CONNECTED = 1 << 2,
+    ACCOUNTS_TABLE_SUPPORTS_AVATAR = 1 << 3
+} AccountsTableFlags;
+
+struct _AccountsTableClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsTable
+{
+    GObject parent_instance;
+};
+
+GType accounts_table_get_type (void) G_GNUC_CONST;
+
+AccountsTable *accounts_table_new (AccountsModel *model);
+
+guint accounts_table_get_n_rows (AccountsTable *table);
+guint accounts_table_get_stamp (AccountsTable *table);
+
+const guint *accounts_table_get_ids (AccountsTable *table);
+const gchar * const *accounts_table_get_names (AccountsTable *table);
+const gchar * const *accounts_table_get_display_names (AccountsTable *table);
+const gchar * const *accounts_table_get_service_names (AccountsTable *table);
+const guint8 *accounts_table_get_flags (AccountsTable *table);
+
+AccountItem *accounts_table_get_item (AccountsTable *table, guint row);
+gint accounts_table_get_row (AccountsTable *table, AccountItem *item);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_TABLE_H_ */
@@ -0,0 +1,456 @@
+/*
+ * accounts-verification-cache.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-verification-cache
+ * @short_description: cache of account verification outcomes.
+ *
+ * An #AccountsVerificationCache remembers, for a limited time, the outcome of
+ * the verification of the credentials of an #AccountItem, so that plugins can
+ * answer again right away when the same credentials are verified shortly
+ * after, for example when the account editor is reopened, instead of
+ * contacting their service again.
+ *
+ * Outcomes are looked up by account and by credentials: plugins pass a string
+ * which changes whenever the credentials change, such as the user name and
+ * the password, and the cache only keeps a keyed hash of it. Successes are
+ * cached, and so are failures in the %ACCOUNT_ERROR domain, which tell about
+ * the credentials; other errors, such as network failures or timeouts, are
+ * not.
+ *
+ * Entries expire after #AccountsVerificationCache:ttl seconds, and are
+ * dropped when the account is finalized. The entries of an account in the
+ * default cache, see accounts_verification_cache_get_default(), are also
+ * dropped when its editing is finished through
+ * account_wizard_context_finish() or account_dialog_context_finish(), before
+ * the plugin is called, so that the plugin can cache the outcome of a
+ * verification it makes at that time.
+ *
+ * The cache can be used from any thread.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "account-edit-context.h"
+#include "account-error.h"
+#include "accounts-private.h"
+#include "accounts-verification-cache.h"
+
+#define KEY_LENGTH 32
+
+typedef struct _CacheEntry
+{
+  /* monotonic time */
+  gint64 expires;
+  GError *error;
+} CacheEntry;
+
+typedef struct _CacheItem
+{
+  AccountsVerificationCache *cache;
+  /* credentials hash -> CacheEntry */
+  GHashTable *entries;
+} CacheItem;
+
+struct _AccountsVerificationCachePrivate
+{
+  GMutex mutex;
+  guint ttl;
+  /* random, so that the hashes can't be matched across processes */
+  guchar key[KEY_LENGTH];
+  /* AccountItem -> CacheItem */
+  GHashTable *items;
+};
+
+typedef struct _AccountsVerificationCachePrivate
+  AccountsVerificationCachePrivate;
+
+#define PRIVATE(cache) \
+  ((AccountsVerificationCachePrivate *) \
+   accounts_verification_cache_get_instance_private( \
+     (AccountsVerificationCache *)(cache)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsVerificationCache,
+  accounts_verification_cache,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_TTL = 1
+};
+
+static AccountsVerificationCache *default_cache = NULL;
+
+static void
+cache_entry_free(CacheEntry *entry)
+{
+  if (entry->error)
+    g_error_free(entry->error);
+
+  g_slice_free(CacheEntry, entry);
+}
+
+static void
+cache_item_free(CacheItem *cache_item)
+{
+  g_hash_table_destroy(cache_item->entries);
+  g_slice_free(CacheItem, cache_item);
+}
+
+static void
+item_finalized(gpointer data, GObject *where_the_object_was)
+{
+  CacheItem *cache_item = data;
+  AccountsVerificationCachePrivate *priv = PRIVATE(cache_item->cache);
+
+  g_mutex_lock(&priv->mutex);
+  g_hash_table_remove(priv->items, where_the_object_was);
+  g_mutex_unlock(&priv->mutex);
+}
+
+static gchar *
+hash_credentials(AccountsVerificationCachePrivate *priv,
+                 const gchar *credentials)
+{
+  return g_compute_hmac_for_string(G_CHECKSUM_SHA256, priv->key, KEY_LENGTH,
+                                   credentials, -1);
+}
+
+static void
+accounts_verification_cache_finalize(GObject *object)
+{
+  AccountsVerificationCachePrivate *priv = PRIVATE(object);
+  GHashTableIter iter;
+  gpointer item, cache_item;
+
+  g_hash_table_iter_init(&iter, priv->items);
+
+  while (g_hash_table_iter_next(&iter, &item, &cache_item))
+    g_object_weak_unref(item, item_finalized, cache_item);
+
+  g_hash_table_destroy(priv->items);
+  g_mutex_clear(&priv->mutex);
+
+  G_OBJECT_CLASS(accounts_verification_cache_parent_class)->finalize(object);
+}
+
+static void
+accounts_verification_cache_set_property(GObject *object, guint property_id,
+                                         const GValue *value,
+                                         GParamSpec *pspec)
+{
+  AccountsVerificationCachePrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFICATION_CACHE(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_TTL:
+    {
+      g_mutex_lock(&priv->mutex);
+      priv->ttl = g_value_get_uint(value);
+      g_mutex_unlock(&priv->mutex);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_verification_cache_get_property(GObject *object, guint property_id,
+                                         GValue *value, GParamSpec *pspec)
+{
+  AccountsVerificationCachePrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFICATION_CACHE(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_TTL:
+    {
+      g_value_set_uint(value, priv->ttl);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_verification_cache_class_init(AccountsVerificationCacheClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->finalize = accounts_verification_cache_finalize;
+  object_class->set_property = accounts_verification_cache_set_property;
+  object_class->get_property = accounts_verification_cache_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_TTL,
+    g_param_spec_uint(
+      "ttl",
+      "Time to live",
+      "Time after which a verification outcome expires, in seconds",
+      0, G_MAXUINT, 300,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+}
+
+static void
+accounts_verification_cache_init(AccountsVerificationCache *cache)
+{
+  AccountsVerificationCachePrivate *priv = PRIVATE(cache);
+  guint i;
+
+  g_mutex_init(&priv->mutex);
+
+  for (i = 0; i < KEY_LENGTH; i++)
+    priv->key[i] = g_random_int_range(0, 256);
+
+  priv->items = g_hash_table_new_full(NULL, NULL, NULL,
+                                      (GDestroyNotify)cache_item_free);
+}
+
+/**
+ * accounts_verification_cache_new:
+ * @ttl: the time after which the outcomes expire, in seconds.
+ *
+ * Creates an #AccountsVerificationCache. Most users want the default cache,
+ * see accounts_verification_cache_get_default().
+ *
+ * Returns:(transfer full): a new #AccountsVerificationCache.
+ */
+AccountsVerificationCache *
+accounts_verification_cache_new(guint ttl)
+{
+  return g_object_new(ACCOUNTS_TYPE_VERIFICATION_CACHE, "ttl", ttl, NULL);
+}
+
+/**
+ * accounts_verification_cache_get_default:
+ *
+ * Gets the cache shared by the plugins of the process, whose entries are
+ * invalidated when the accounts are edited.
+ *
+ * Returns:(transfer none): the default #AccountsVerificationCache.
+ */
+AccountsVerificationCache *
+accounts_verification_cache_get_default(void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter(&initialized))
+  {
+    g_atomic_pointer_set(&default_cache, accounts_verification_cache_new(300));
+    g_once_init_leave(&initialized, 1);
+  }
+
+  return default_cache;
+}
+
+/**
+ * accounts_verification_cache_lookup:
+ * @cache: the #AccountsVerificationCache.
+ * @item: the #AccountItem.
+ * @credentials: a string identifying the credentials being verified.
+ * @error: return location for the error of a cached failure, or %NULL.
+ *
+ * Looks up the outcome of the last verification of @credentials for @item.
+ *
+ * Returns: %ACCOUNTS_VERIFICATION_UNKNOWN if there is no outcome which did
+ * not expire yet, otherwise the outcome, with @error set if it is
+ * %ACCOUNTS_VERIFICATION_FAILED.
+ */
+AccountsVerificationStatus
+accounts_verification_cache_lookup(AccountsVerificationCache *cache,
+                                   AccountItem *item,
+                                   const gchar *credentials, GError **error)
+{
+  AccountsVerificationCachePrivate *priv;
+  AccountsVerificationStatus status = ACCOUNTS_VERIFICATION_UNKNOWN;
+  CacheItem *cache_item;
+  gchar *hash;
+
+  g_return_val_if_fail(ACCOUNTS_IS_VERIFICATION_CACHE(cache),
+                       ACCOUNTS_VERIFICATION_UNKNOWN);
+  g_return_val_if_fail(ACCOUNT_IS_ITEM(item), ACCOUNTS_VERIFICATION_UNKNOWN);
+  g_return_val_if_fail(credentials != NULL, ACCOUNTS_VERIFICATION_UNKNOWN);
+
+  priv = PRIVATE(cache);
+  hash = hash_credentials(priv, credentials);
+
+  g_mutex_lock(&priv->mutex);
+
+  cache_item = g_hash_table_lookup(priv->items, item);
+
+  if (cache_item)
+  {
+    CacheEntry *entry = g_hash_table_lookup(cache_item->entries, hash);
+
+    if (entry && entry->expires <= g_get_monotonic_time())
+      g_hash_table_remove(cache_item->entries, hash);
+    else if (entry && entry->error)
+    {
+      status = ACCOUNTS_VERIFICATION_FAILED;
+
+      if (error)
+        *error = g_error_copy(entry->error);
+    }
+    else if (entry)
+      status = ACCOUNTS_VERIFICATION_SUCCEEDED;
+  }
+
+  g_mutex_unlock(&priv->mutex);
+  g_free(hash);
+
+  return status;
+}
+
+/**
+ * accounts_verification_cache_store:
+ * @cache: the #AccountsVerificationCache.
+ * @item: the #AccountItem.
+ * @credentials: a string identifying the credentials which were verified.
+ * @error:(nullable): the error the verification failed with, or %NULL if it
+ * succeeded.
+ *
+ * Records the outcome of the verification of @credentials for @item. Only
+ * %ACCOUNT_ERROR_AUTHENTICATION_FAILED and %ACCOUNT_ERROR_VERIFICATION_FAILED
+ * tell that the credentials were rejected, other errors (a failed connection,
+ * a cancelled operation...) are ignored.
+ */
+void
+accounts_verification_cache_store(AccountsVerificationCache *cache,
+                                  AccountItem *item, const gchar *credentials,
+                                  const GError *error)
+{
+  AccountsVerificationCachePrivate *priv;
+  CacheItem *cache_item;
+  CacheEntry *entry;
+  GHashTableIter iter;
+  gpointer value;
+  gint64 now;
+  gchar *hash;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFICATION_CACHE(cache));
+  g_return_if_fail(ACCOUNT_IS_ITEM(item));
+  g_return_if_fail(credentials != NULL);
+
+  /* the credentials were neither accepted nor rejected */
+  if (error &&
+      !g_error_matches(error, ACCOUNT_ERROR,
+                       ACCOUNT_ERROR_AUTHENTICATION_FAILED) &&
+      !g_error_matches(error, ACCOUNT_ERROR,
+                       ACCOUNT_ERROR_VERIFICATION_FAILED))
+  {
+    return;
+  }
+
+  priv = PRIVATE(cache);
+  hash = hash_credentials(priv, credentials);
+  entry = g_slice_new(CacheEntry);
+  entry->error = error ? g_error_copy(error) : NULL;
+
+  g_mutex_lock(&priv->mutex);
+
+  now = g_get_monotonic_time();
+  entry->expires = now + (gint64)priv->ttl * G_USEC_PER_SEC;
+  cache_item = g_hash_table_lookup(priv->items, item);
+
+  if (!cache_item)
+  {
+    cache_item = g_slice_new(CacheItem);
+    cache_item->cache = cache;
+    cache_item->entries = g_hash_table_new_full(
+        g_str_hash, g_str_equal, g_free, (GDestroyNotify)cache_entry_free);
+    g_hash_table_insert(priv->items, item, cache_item);
+    g_object_weak_ref(G_OBJECT(item), item_finalized, cache_item);
+  }
+
+  /* drop the expired outcomes of other credentials */
+  g_hash_table_iter_init(&iter, cache_item->entries);
+
+  while (g_hash_table_iter_next(&iter, NULL, &value))
+  {
+    if (((CacheEntry *)value)->expires <= now)
+      g_hash_table_iter_remove(&iter);
+  }
+
+  g_hash_table_replace(cache_item->entries, hash, entry);
+
+  g_mutex_unlock(&priv->mutex);
+}
+
+/**
+ * accounts_verification_cache_invalidate:
+ * @cache: the #AccountsVerificationCache.
+ * @item: the #AccountItem.
+ *
+ * Drops all the outcomes recorded for @item.
+ */
+void
+accounts_verification_cache_invalidate(AccountsVerificationCache *cache,
+                                       AccountItem *item)
+{
+  AccountsVerificationCachePrivate *priv;
+  CacheItem *cache_item;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFICATION_CACHE(cache));
+  g_return_if_fail(ACCOUNT_IS_ITEM(item));
+
+  priv = PRIVATE(cache);
+
+  g_mutex_lock(&priv->mutex);
+
+  cache_item = g_hash_table_lookup(priv->items, item);
+
+  if (cache_item)
+    g_hash_table_remove_all(cache_item->entries);
+
+  g_mutex_unlock(&priv->mutex);
+}
+
+void
+_accounts_verification_cache_invalidate_edited(gpointer context)
+{
+  AccountsVerificationCache *cache = g_atomic_pointer_get(&default_cache);
+  AccountItem *item;
+
+  if (!cache || !ACCOUNT_IS_EDIT_CONTEXT(context))
+    return;
+
+  item = account_edit_context_get_account(context);
+
+  if (item)
+    accounts_verification_cache_invalidate(cache, item);
+}
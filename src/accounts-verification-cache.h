@@ -0,0 +1,83 @@
+/*
+ * accounts-verification-cache.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_VERIFICATION_CACHE_H_
+#define _ACCOUNTS_VERIFICATION_CACHE_H_
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_VERIFICATION_CACHE             (accounts_verification_cache_get_type ())
+#define ACCOUNTS_VERIFICATION_CACHE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_VERIFICATION_CACHE, AccountsVerificationCache))
+#define ACCOUNTS_VERIFICATION_CACHE_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_VERIFICATION_CACHE, AccountsVerificationCacheClass))
+#define ACCOUNTS_IS_VERIFICATION_CACHE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_VERIFICATION_CACHE))
+#define ACCOUNTS_IS_VERIFICATION_CACHE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_VERIFICATION_CACHE))
+#define ACCOUNTS_VERIFICATION_CACHE_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_VERIFICATION_CACHE, AccountsVerificationCacheClass))
+
+typedef struct _AccountsVerificationCacheClass AccountsVerificationCacheClass;
+typedef struct _AccountsVerificationCache AccountsVerificationCache;
+
+#include "account-item.h"
+
+/**
+ * AccountsVerificationStatus:
+ * @ACCOUNTS_VERIFICATION_UNKNOWN: no valid outcome is cached.
+ * @ACCOUNTS_VERIFICATION_SUCCEEDED: the credentials were verified.
+ * @ACCOUNTS_VERIFICATION_FAILED: the credentials were rejected.
+ *
+ * The cached outcome of a verification.
+ */
+typedef enum
+{
+    ACCOUNTS_VERIFICATION_UNKNOWN = 0,
+    ACCOUNTS_VERIFICATION_SUCCEEDED,
+    ACCOUNTS_VERIFICATION_FAILED
+} AccountsVerificationStatus;
+
+struct _AccountsVerificationCacheClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsVerificationCache
+{
+    GObject parent_instance;
+};
+
+GType accounts_verification_cache_get_type (void) G_GNUC_CONST;
+
+AccountsVerificationCache *accounts_verification_cache_new (guint ttl);
+AccountsVerificationCache *accounts_verification_cache_get_default (void);
+
+AccountsVerificationStatus
+accounts_verification_cache_lookup (AccountsVerificationCache *cache,
+                                    AccountItem *item,
+                                    const gchar *credentials,
+                                    GError **error);
+void accounts_verification_cache_store (AccountsVerificationCache *cache,
+                                        AccountItem *item,
+                                        const gchar *credentials,
+                                        const GError *error);
+void accounts_verification_cache_invalidate (AccountsVerificationCache *cache,
+                                             AccountItem *item);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_VERIFICATION_CACHE_H_ */
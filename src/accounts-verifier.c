@@ -0,0 +1,591 @@
+/*
+ * accounts-verifier.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SECTION:accounts-verifier
+ * @short_description: verification of many accounts.
+ *
+ * An #AccountsVerifier runs account_item_verify_async() for any number of
+ * accounts, for example to validate all the provisioned accounts at boot,
+ * without overloading the services they belong to:
+ *
+ * - at most #AccountsVerifier:max-parallel verifications run at the same
+ *   time;
+ * - verifications of the accounts of a single #AccountService are started at
+ *   most #AccountsVerifier:service-rate times per second;
+ * - a verification which takes longer than #AccountsVerifier:timeout
+ *   milliseconds fails with %G_IO_ERROR_TIMED_OUT, and its #GCancellable is
+ *   cancelled. It still counts towards #AccountsVerifier:max-parallel until
+ *   the plugin reports its result, so plugins ignoring the cancellation can't
+ *   make the verifier overload their backend.
+ *
+ * Requests are served in the order they were made, skipping those of services
+ * which reached their rate, and each of them reports its result through
+ * accounts_verifier_verify_finish(). The
+ * #AccountItem::verification-finished signal is emitted as well, for those
+ * following all the verifications of an account.
+ *
+ * An #AccountsVerifier must only be used, and its requests cancelled, from
+ * the main thread.
+ */
+
+#include "config.h"
+
+#include "accounts-verifier.h"
+
+typedef struct _VerifyRequest
+{
+  AccountsVerifier *verifier;
+  AccountItem *item;
+  GTask *task;
+  gulong cancelled_id;
+  /* while running; cancelled on timeout or with the task cancellable */
+  GCancellable *cancellable;
+  guint timeout_id;
+  gboolean completed;
+} VerifyRequest;
+
+struct _AccountsVerifierPrivate
+{
+  guint max_parallel;
+  gdouble service_rate;
+  guint timeout;
+
+  /* VerifyRequest, not started yet */
+  GQueue pending;
+  guint running;
+  /* requests not completed yet */
+  guint n_pending;
+
+  /* AccountService -> gint64 monotonic time, the earliest next start */
+  GHashTable *next_start;
+
+  guint dispatch_id;
+  guint dispatch_delay;
+};
+
+typedef struct _AccountsVerifierPrivate AccountsVerifierPrivate;
+
+#define PRIVATE(verifier) \
+  ((AccountsVerifierPrivate *) \
+   accounts_verifier_get_instance_private((AccountsVerifier *)(verifier)))
+
+G_DEFINE_TYPE_WITH_PRIVATE(
+  AccountsVerifier,
+  accounts_verifier,
+  G_TYPE_OBJECT
+)
+
+enum
+{
+  PROP_MAX_PARALLEL = 1,
+  PROP_SERVICE_RATE,
+  PROP_TIMEOUT,
+  PROP_N_PENDING
+};
+
+static void dispatch(AccountsVerifier *verifier);
+
+static gboolean
+dispatch_cb(gpointer user_data)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(user_data);
+
+  priv->dispatch_id = 0;
+  dispatch(user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_dispatch(AccountsVerifier *verifier, guint delay)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(verifier);
+
+  if (priv->dispatch_id)
+  {
+    /* scheduled earlier, so it runs no later than requested */
+    if (priv->dispatch_delay <= delay)
+      return;
+
+    g_source_remove(priv->dispatch_id);
+  }
+
+  priv->dispatch_delay = delay;
+
+  if (delay)
+    priv->dispatch_id = g_timeout_add(delay, dispatch_cb, verifier);
+  else
+    priv->dispatch_id = g_idle_add(dispatch_cb, verifier);
+}
+
+static void
+request_free(VerifyRequest *req)
+{
+  g_object_unref(req->item);
+
+  if (req->cancellable)
+    g_object_unref(req->cancellable);
+
+  g_slice_free(VerifyRequest, req);
+}
+
+/* takes @error; the request stays in the scheduler until the plugin is done */
+static void
+request_complete(VerifyRequest *req, GError *error)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(req->verifier);
+
+  if (req->completed)
+  {
+    if (error)
+      g_error_free(error);
+
+    return;
+  }
+
+  req->completed = TRUE;
+
+  if (req->cancelled_id)
+  {
+    g_cancellable_disconnect(g_task_get_cancellable(req->task),
+                             req->cancelled_id);
+    req->cancelled_id = 0;
+  }
+
+  priv->n_pending--;
+  g_signal_emit_by_name(req->item, "verification-finished", error);
+
+  if (error)
+    g_task_return_error(req->task, error);
+  else
+    g_task_return_boolean(req->task, TRUE);
+
+  g_object_notify(G_OBJECT(req->verifier), "n-pending");
+}
+
+static void
+on_cancelled(GCancellable *cancellable, VerifyRequest *req)
+{
+  /* the pending requests are failed from the dispatcher, as disconnecting is
+   * not possible from here */
+  if (req->cancellable)
+    g_cancellable_cancel(req->cancellable);
+  else
+    schedule_dispatch(req->verifier, 0);
+}
+
+static gboolean
+on_timeout(gpointer user_data)
+{
+  VerifyRequest *req = user_data;
+
+  req->timeout_id = 0;
+  request_complete(req,
+                   g_error_new(G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                               "Verification of `%s' timed out",
+                               req->item->name));
+  g_cancellable_cancel(req->cancellable);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_verified(GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+  VerifyRequest *req = user_data;
+  AccountsVerifierPrivate *priv = PRIVATE(req->verifier);
+  GError *error = NULL;
+
+  if (req->timeout_id)
+  {
+    g_source_remove(req->timeout_id);
+    req->timeout_id = 0;
+  }
+
+  account_item_verify_finish(req->item, result, &error);
+  g_clear_object(&req->cancellable);
+  priv->running--;
+
+  request_complete(req, error);
+  schedule_dispatch(req->verifier, 0);
+  g_object_unref(req->task);
+}
+
+static void
+request_start(VerifyRequest *req)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(req->verifier);
+
+  priv->running++;
+  req->cancellable = g_cancellable_new();
+
+  if (priv->timeout)
+    req->timeout_id = g_timeout_add(priv->timeout, on_timeout, req);
+
+  account_item_verify_async(req->item, req->cancellable, on_verified, req);
+}
+
+static gboolean
+service_can_start(AccountsVerifierPrivate *priv, AccountService *service,
+                  gint64 now, gint64 *wakeup)
+{
+  gint64 *next;
+
+  if (priv->service_rate <= 0)
+    return TRUE;
+
+  next = g_hash_table_lookup(priv->next_start, service);
+
+  if (next && *next > now)
+  {
+    if (!*wakeup || *next < *wakeup)
+      *wakeup = *next;
+
+    return FALSE;
+  }
+
+  if (!next)
+  {
+    next = g_new(gint64, 1);
+    g_hash_table_insert(priv->next_start, service, next);
+  }
+
+  *next = now + (gint64)(G_USEC_PER_SEC / priv->service_rate);
+
+  return TRUE;
+}
+
+static void
+dispatch(AccountsVerifier *verifier)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(verifier);
+  gint64 now = g_get_monotonic_time();
+  gint64 wakeup = 0;
+  GList *cancelled = NULL;
+  GList *l = priv->pending.head;
+
+  while (l)
+  {
+    VerifyRequest *req = l->data;
+    GList *next = l->next;
+
+    if (g_cancellable_is_cancelled(g_task_get_cancellable(req->task)))
+    {
+      g_queue_delete_link(&priv->pending, l);
+      cancelled = g_list_prepend(cancelled, req);
+    }
+    else if ((!priv->max_parallel || priv->running < priv->max_parallel) &&
+             service_can_start(priv, req->item->service, now, &wakeup))
+    {
+      g_queue_delete_link(&priv->pending, l);
+      request_start(req);
+    }
+
+    l = next;
+  }
+
+  if (wakeup)
+    schedule_dispatch(verifier, (wakeup - now + 999) / 1000);
+
+  /* after the queue is walked, as the callbacks may make new requests */
+  cancelled = g_list_reverse(cancelled);
+
+  for (l = cancelled; l; l = l->next)
+  {
+    VerifyRequest *req = l->data;
+
+    request_complete(req, g_error_new(G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                                      "Operation was cancelled"));
+    g_object_unref(req->task);
+  }
+
+  g_list_free(cancelled);
+}
+
+static void
+accounts_verifier_dispose(GObject *object)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(object);
+
+  if (priv->dispatch_id)
+  {
+    g_source_remove(priv->dispatch_id);
+    priv->dispatch_id = 0;
+  }
+
+  G_OBJECT_CLASS(accounts_verifier_parent_class)->dispose(object);
+}
+
+static void
+accounts_verifier_finalize(GObject *object)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(object);
+
+  g_hash_table_destroy(priv->next_start);
+
+  G_OBJECT_CLASS(accounts_verifier_parent_class)->finalize(object);
+}
+
+static void
+accounts_verifier_set_property(GObject *object, guint property_id,
+                               const GValue *value, GParamSpec *pspec)
+{
+  AccountsVerifierPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFIER(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MAX_PARALLEL:
+    {
+      priv->max_parallel = g_value_get_uint(value);
+      break;
+    }
+    case PROP_SERVICE_RATE:
+    {
+      priv->service_rate = g_value_get_double(value);
+      g_hash_table_remove_all(priv->next_start);
+      break;
+    }
+    case PROP_TIMEOUT:
+    {
+      priv->timeout = g_value_get_uint(value);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      return;
+    }
+  }
+
+  if (!g_queue_is_empty(&priv->pending))
+    schedule_dispatch(ACCOUNTS_VERIFIER(object), 0);
+}
+
+static void
+accounts_verifier_get_property(GObject *object, guint property_id,
+                               GValue *value, GParamSpec *pspec)
+{
+  AccountsVerifierPrivate *priv;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFIER(object));
+
+  priv = PRIVATE(object);
+
+  switch (property_id)
+  {
+    case PROP_MAX_PARALLEL:
+    {
+      g_value_set_uint(value, priv->max_parallel);
+      break;
+    }
+    case PROP_SERVICE_RATE:
+    {
+      g_value_set_double(value, priv->service_rate);
+      break;
+    }
+    case PROP_TIMEOUT:
+    {
+      g_value_set_uint(value, priv->timeout);
+      break;
+    }
+    case PROP_N_PENDING:
+    {
+      g_value_set_uint(value, priv->n_pending);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+accounts_verifier_class_init(AccountsVerifierClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->dispose = accounts_verifier_dispose;
+  object_class->finalize = accounts_verifier_finalize;
+  object_class->set_property = accounts_verifier_set_property;
+  object_class->get_property = accounts_verifier_get_property;
+
+  g_object_class_install_property(
+    object_class, PROP_MAX_PARALLEL,
+    g_param_spec_uint(
+      "max-parallel",
+      "Maximum parallel",
+      "Maximum number of verifications running at the same time, 0 for no "
+      "limit",
+      0, G_MAXUINT, 4,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_SERVICE_RATE,
+    g_param_spec_double(
+      "service-rate",
+      "Service rate",
+      "Maximum number of verifications started per second for a single "
+      "service, 0 for no limit",
+      0, G_MAXDOUBLE, 0,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_TIMEOUT,
+    g_param_spec_uint(
+      "timeout",
+      "Timeout",
+      "Time after which a verification fails, in milliseconds, 0 for none",
+      0, G_MAXUINT, 60000,
+      G_PARAM_CONSTRUCT | G_PARAM_READWRITE));
+  g_object_class_install_property(
+    object_class, PROP_N_PENDING,
+    g_param_spec_uint(
+      "n-pending",
+      "Pending",
+      "Number of verifications not completed yet",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE));
+}
+
+static void
+accounts_verifier_init(AccountsVerifier *verifier)
+{
+  AccountsVerifierPrivate *priv = PRIVATE(verifier);
+
+  g_queue_init(&priv->pending);
+  priv->next_start = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+}
+
+/**
+ * accounts_verifier_new:
+ * @max_parallel: the maximum number of verifications running at the same
+ * time, or 0 for no limit.
+ * @service_rate: the maximum number of verifications started per second for
+ * the accounts of a single service, or 0 for no limit.
+ * @timeout: the time after which a verification fails, in milliseconds, or 0
+ * for no timeout.
+ *
+ * Creates an #AccountsVerifier.
+ *
+ * Returns:(transfer full): a new #AccountsVerifier.
+ */
+AccountsVerifier *
+accounts_verifier_new(guint max_parallel, gdouble service_rate, guint timeout)
+{
+  return g_object_new(ACCOUNTS_TYPE_VERIFIER,
+                      "max-parallel", max_parallel,
+                      "service-rate", service_rate,
+                      "timeout", timeout,
+                      NULL);
+}
+
+/**
+ * accounts_verifier_verify_async:
+ * @verifier: the #AccountsVerifier.
+ * @item: the #AccountItem to verify.
+ * @cancellable:(nullable): a #GCancellable, or %NULL.
+ * @callback: a #GAsyncReadyCallback to call when done.
+ * @user_data: the data to pass to @callback.
+ *
+ * Queues the verification of @item, which starts as soon as the limits of
+ * @verifier allow it. Call accounts_verifier_verify_finish() from @callback
+ * to get the result.
+ */
+void
+accounts_verifier_verify_async(AccountsVerifier *verifier, AccountItem *item,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+  AccountsVerifierPrivate *priv;
+  VerifyRequest *req;
+  GTask *task;
+
+  g_return_if_fail(ACCOUNTS_IS_VERIFIER(verifier));
+  g_return_if_fail(ACCOUNT_IS_ITEM(item));
+  g_return_if_fail(!cancellable || G_IS_CANCELLABLE(cancellable));
+
+  priv = PRIVATE(verifier);
+  task = g_task_new(verifier, cancellable, callback, user_data);
+  g_task_set_source_tag(task, accounts_verifier_verify_async);
+
+  if (g_task_return_error_if_cancelled(task))
+  {
+    g_object_unref(task);
+    return;
+  }
+
+  req = g_slice_new0(VerifyRequest);
+  req->verifier = verifier;
+  req->item = g_object_ref(item);
+  /* the scheduler reference, dropped when the request leaves it */
+  req->task = task;
+  g_task_set_task_data(task, req, (GDestroyNotify)request_free);
+
+  if (cancellable)
+  {
+    req->cancelled_id = g_cancellable_connect(cancellable,
+                                              G_CALLBACK(on_cancelled), req,
+                                              NULL);
+  }
+
+  g_queue_push_tail(&priv->pending, req);
+  priv->n_pending++;
+  schedule_dispatch(verifier, 0);
+
+  g_object_notify(G_OBJECT(verifier), "n-pending");
+}
+
+/**
+ * accounts_verifier_verify_finish:
+ * @verifier: the #AccountsVerifier.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: a GError for error reporting, or %NULL.
+ *
+ * Finishes an operation started with accounts_verifier_verify_async().
+ *
+ * Returns: %TRUE if the account credentials are valid, %FALSE on error.
+ */
+gboolean
+accounts_verifier_verify_finish(AccountsVerifier *verifier,
+                                GAsyncResult *result, GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, verifier), FALSE);
+
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+/**
+ * accounts_verifier_get_n_pending:
+ * @verifier: the #AccountsVerifier.
+ *
+ * Returns: the number of verifications queued or running.
+ */
+guint
+accounts_verifier_get_n_pending(AccountsVerifier *verifier)
+{
+  g_return_val_if_fail(ACCOUNTS_IS_VERIFIER(verifier), 0);
+
+  return PRIVATE(verifier)->n_pending;
+}
@@ -0,0 +1,69 @@
+/*
+ * accounts-verifier.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ACCOUNTS_VERIFIER_H_
+#define _ACCOUNTS_VERIFIER_H_
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ACCOUNTS_TYPE_VERIFIER             (accounts_verifier_get_type ())
+#define ACCOUNTS_VERIFIER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), ACCOUNTS_TYPE_VERIFIER, AccountsVerifier))
+#define ACCOUNTS_VERIFIER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), ACCOUNTS_TYPE_VERIFIER, AccountsVerifierClass))
+#define ACCOUNTS_IS_VERIFIER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), ACCOUNTS_TYPE_VERIFIER))
+#define ACCOUNTS_IS_VERIFIER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), ACCOUNTS_TYPE_VERIFIER))
+#define ACCOUNTS_VERIFIER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), ACCOUNTS_TYPE_VERIFIER, AccountsVerifierClass))
+
+typedef struct _AccountsVerifierClass AccountsVerifierClass;
+typedef struct _AccountsVerifier AccountsVerifier;
+
+#include "account-item.h"
+
+struct _AccountsVerifierClass
+{
+    GObjectClass parent_class;
+};
+
+struct _AccountsVerifier
+{
+    GObject parent_instance;
+};
+
+GType accounts_verifier_get_type (void) G_GNUC_CONST;
+
+AccountsVerifier *accounts_verifier_new (guint max_parallel,
+                                         gdouble service_rate,
+                                         guint timeout);
+
+void accounts_verifier_verify_async (AccountsVerifier *verifier,
+                                     AccountItem *item,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+gboolean accounts_verifier_verify_finish (AccountsVerifier *verifier,
+                                          GAsyncResult *result,
+                                          GError **error);
+
+guint accounts_verifier_get_n_pending (AccountsVerifier *verifier);
+
+G_END_DECLS
+
+#endif /* _ACCOUNTS_VERIFIER_H_ */
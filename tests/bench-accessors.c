@@ -0,0 +1,223 @@
+/*
+ * bench-accessors.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Compares reading, writing and notifying AccountItem and AccountService
+ * properties by name, through g_object_get(), g_object_set() and
+ * g_object_notify(), with the typed accessors, which notify through cached
+ * GParamSpec pointers.
+ *
+ * Usage: bench-accessors [ITERATIONS]
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+
+#include "account-item.h"
+#include "account-service.h"
+
+#define DEFAULT_ITERATIONS 1000000
+
+typedef void (*BenchFunc) (gpointer object, guint i);
+
+static void
+report(const gchar *name, BenchFunc func, gpointer object, guint iterations)
+{
+  GTimer *timer = g_timer_new();
+  guint i;
+
+  for (i = 0; i < iterations; i++)
+    func(object, i);
+
+  g_timer_stop(timer);
+  g_print("%-40s %8.1f ns/call\n", name,
+          g_timer_elapsed(timer, NULL) * 1e9 / iterations);
+  g_timer_destroy(timer);
+}
+
+/* alternate between two values, so that every set notifies */
+static const gchar *names[] = { "Alice", "Bob" };
+
+static void
+item_get_by_name(gpointer object, guint i)
+{
+  gchar *display_name;
+
+  g_object_get(object, "display-name", &display_name, NULL);
+  g_free(display_name);
+}
+
+static void
+item_get_typed(gpointer object, guint i)
+{
+  const gchar * volatile display_name;
+
+  display_name = account_item_get_display_name(object);
+  (void)display_name;
+}
+
+static void
+item_set_by_name(gpointer object, guint i)
+{
+  g_object_set(object, "display-name", names[i & 1], NULL);
+}
+
+static void
+item_set_typed(gpointer object, guint i)
+{
+  account_item_set_display_name(object, names[i & 1]);
+}
+
+static void
+item_get_supports_avatar_by_name(gpointer object, guint i)
+{
+  gboolean supports_avatar;
+
+  g_object_get(object, "supports-avatar", &supports_avatar, NULL);
+}
+
+static void
+item_get_supports_avatar_typed(gpointer object, guint i)
+{
+  volatile gboolean supports_avatar;
+
+  supports_avatar = account_item_get_supports_avatar(object);
+  (void)supports_avatar;
+}
+
+static void
+item_set_supports_avatar_by_name(gpointer object, guint i)
+{
+  g_object_set(object, "supports-avatar", i & 1, NULL);
+}
+
+static void
+item_set_supports_avatar_typed(gpointer object, guint i)
+{
+  account_item_set_supports_avatar(object, i & 1);
+}
+
+static void
+notify_by_name(gpointer object, guint i)
+{
+  g_object_notify(object, "display-name");
+}
+
+static GParamSpec *display_name_pspec;
+
+static void
+notify_by_pspec(gpointer object, guint i)
+{
+  g_object_notify_by_pspec(object, display_name_pspec);
+}
+
+static void
+service_get_by_name(gpointer object, guint i)
+{
+  gchar *display_name;
+
+  g_object_get(object, "display-name", &display_name, NULL);
+  g_free(display_name);
+}
+
+static void
+service_get_typed(gpointer object, guint i)
+{
+  const gchar * volatile display_name;
+
+  display_name = account_service_get_display_name(object);
+  (void)display_name;
+}
+
+static void
+service_set_by_name(gpointer object, guint i)
+{
+  g_object_set(object, "display-name", names[i & 1], NULL);
+}
+
+static void
+service_set_typed(gpointer object, guint i)
+{
+  account_service_set_display_name(object, names[i & 1]);
+}
+
+static void
+on_notify(GObject *object, GParamSpec *pspec, gpointer user_data)
+{}
+
+int
+main(int argc, char **argv)
+{
+  guint iterations = DEFAULT_ITERATIONS;
+  AccountService *service;
+  AccountItem *item;
+
+  if (argc > 1)
+    iterations = MAX(1, atoi(argv[1]));
+
+  service = g_object_new(ACCOUNT_TYPE_SERVICE,
+                         "name", "bench",
+                         "display-name", names[0],
+                         NULL);
+  item = g_object_new(ACCOUNT_TYPE_ITEM,
+                      "name", "bench@example.com",
+                      "display-name", names[0],
+                      NULL);
+  display_name_pspec = g_object_class_find_property(
+      G_OBJECT_GET_CLASS(item), "display-name");
+
+  /* user interfaces usually listen to the changes */
+  g_signal_connect(item, "notify", G_CALLBACK(on_notify), NULL);
+  g_signal_connect(service, "notify", G_CALLBACK(on_notify), NULL);
+
+  g_print("%u iterations\n\n", iterations);
+
+  report("AccountItem display-name, g_object_get", item_get_by_name, item,
+         iterations);
+  report("AccountItem display-name, getter", item_get_typed, item,
+         iterations);
+  report("AccountItem display-name, g_object_set", item_set_by_name, item,
+         iterations);
+  report("AccountItem display-name, setter", item_set_typed, item,
+         iterations);
+  report("AccountItem supports-avatar, g_object_get",
+         item_get_supports_avatar_by_name, item, iterations);
+  report("AccountItem supports-avatar, getter",
+         item_get_supports_avatar_typed, item, iterations);
+  report("AccountItem supports-avatar, g_object_set",
+         item_set_supports_avatar_by_name, item, iterations);
+  report("AccountItem supports-avatar, setter",
+         item_set_supports_avatar_typed, item, iterations);
+  report("g_object_notify", notify_by_name, item, iterations);
+  report("g_object_notify_by_pspec", notify_by_pspec, item, iterations);
+  report("AccountService display-name, g_object_get", service_get_by_name,
+         service, iterations);
+  report("AccountService display-name, getter", service_get_typed, service,
+         iterations);
+  report("AccountService display-name, g_object_set", service_set_by_name,
+         service, iterations);
+  report("AccountService display-name, setter", service_set_typed, service,
+         iterations);
+
+  g_object_unref(item);
+  g_object_unref(service);
+
+  return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ * test-common.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * A minimal AccountsList and AccountPlugin, for testing the library without
+ * the hildon accounts framework.
+ */
+
+#include "config.h"
+
+#include <glib/gstdio.h>
+
+#include "test-common.h"
+
+typedef struct _TestAccountsList TestAccountsList;
+typedef struct _TestAccountsListClass TestAccountsListClass;
+
+struct _TestAccountsList
+{
+  GObject parent_instance;
+  GList *items;
+};
+
+struct _TestAccountsListClass
+{
+  GObjectClass parent_class;
+};
+
+static void test_accounts_list_iface_init(AccountsListIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(
+  TestAccountsList,
+  test_accounts_list,
+  G_TYPE_OBJECT,
+  G_IMPLEMENT_INTERFACE(ACCOUNTS_TYPE_LIST, test_accounts_list_iface_init)
+);
+
+static void
+test_accounts_list_add(AccountsList *accounts_list, AccountItem *item)
+{
+  TestAccountsList *list = (TestAccountsList *)accounts_list;
+
+  list->items = g_list_append(list->items, g_object_ref(item));
+}
+
+static void
+test_accounts_list_remove(AccountsList *accounts_list, AccountItem *item)
+{
+  TestAccountsList *list = (TestAccountsList *)accounts_list;
+  GList *l = g_list_find(list->items, item);
+
+  if (l)
+  {
+    list->items = g_list_delete_link(list->items, l);
+    g_object_unref(item);
+  }
+}
+
+static GList *
+test_accounts_list_get_all(AccountsList *accounts_list)
+{
+  TestAccountsList *list = (TestAccountsList *)accounts_list;
+
+  return g_list_copy_deep(list->items, (GCopyFunc)g_object_ref, NULL);
+}
+
+static void
+test_accounts_list_finalize(GObject *object)
+{
+  TestAccountsList *list = (TestAccountsList *)object;
+
+  g_list_free_full(list->items, g_object_unref);
+
+  G_OBJECT_CLASS(test_accounts_list_parent_class)->finalize(object);
+}
+
+static void
+test_accounts_list_iface_init(AccountsListIface *iface)
+{
+  iface->add = test_accounts_list_add;
+  iface->remove = test_accounts_list_remove;
+  iface->get_all = test_accounts_list_get_all;
+}
+
+static void
+test_accounts_list_class_init(TestAccountsListClass *klass)
+{
+  G_OBJECT_CLASS(klass)->finalize = test_accounts_list_finalize;
+}
+
+static void
+test_accounts_list_init(TestAccountsList *list)
+{}
+
+AccountsList *
+test_accounts_list_new(void)
+{
+  return g_object_new(TEST_TYPE_ACCOUNTS_LIST, NULL);
+}
+
+typedef struct _TestPlugin TestPlugin;
+typedef struct _TestPluginClass TestPluginClass;
+
+struct _TestPlugin
+{
+  AccountPlugin parent_instance;
+  gchar *name;
+  GList *services;
+};
+
+struct _TestPluginClass
+{
+  AccountPluginClass parent_class;
+};
+
+G_DEFINE_TYPE(TestPlugin, test_plugin, ACCOUNT_TYPE_PLUGIN);
+
+static gboolean
+test_plugin_setup(AccountPlugin *plugin, AccountsList *accounts_list)
+{
+  return TRUE;
+}
+
+static const gchar *
+test_plugin_get_name(AccountPlugin *plugin)
+{
+  return ((TestPlugin *)plugin)->name;
+}
+
+static GList *
+test_plugin_list_services(AccountPlugin *plugin)
+{
+  return g_list_copy(((TestPlugin *)plugin)->services);
+}
+
+static void
+test_plugin_finalize(GObject *object)
+{
+  TestPlugin *plugin = (TestPlugin *)object;
+
+  g_list_free_full(plugin->services, g_object_unref);
+  g_free(plugin->name);
+
+  G_OBJECT_CLASS(test_plugin_parent_class)->finalize(object);
+}
+
+static void
+test_plugin_class_init(TestPluginClass *klass)
+{
+  AccountPluginClass *plugin_class = ACCOUNT_PLUGIN_CLASS(klass);
+
+  G_OBJECT_CLASS(klass)->finalize = test_plugin_finalize;
+  plugin_class->setup = test_plugin_setup;
+  plugin_class->get_name = test_plugin_get_name;
+  plugin_class->get_display_name = test_plugin_get_name;
+  plugin_class->list_services = test_plugin_list_services;
+}
+
+static void
+test_plugin_init(TestPlugin *plugin)
+{}
+
+AccountPlugin *
+test_plugin_new(const gchar *name)
+{
+  TestPlugin *plugin = g_object_new(TEST_TYPE_PLUGIN, NULL);
+
+  plugin->name = g_strdup(name);
+
+  return ACCOUNT_PLUGIN(plugin);
+}
+
+/* the service stays owned by plugin as well */
+AccountService *
+test_service_new(AccountPlugin *plugin, const gchar *name,
+                 const gchar *display_name)
+{
+  TestPlugin *test_plugin = (TestPlugin *)plugin;
+  AccountService *service;
+
+  service = g_object_new(ACCOUNT_TYPE_SERVICE,
+                         "plugin", plugin,
+                         "name", name,
+                         "display-name", display_name,
+                         NULL);
+  test_plugin->services = g_list_append(test_plugin->services,
+                                        g_object_ref(service));
+
+  return service;
+}
+
+AccountItem *
+test_item_new(AccountService *service, const gchar *name,
+              const gchar *display_name)
+{
+  return g_object_new(ACCOUNT_TYPE_ITEM,
+                      "service", service,
+                      "name", name,
+                      "display-name", display_name,
+                      NULL);
+}
+
+/* points the user cache directory to a new temporary directory, before
+ * anything reads it */
+gchar *
+test_setup_cache_dir(void)
+{
+  GError *error = NULL;
+  gchar *dir = g_dir_make_tmp("libaccounts-test-XXXXXX", &error);
+
+  g_assert_no_error(error);
+  g_setenv("XDG_CACHE_HOME", dir, TRUE);
+  g_assert_cmpstr(g_get_user_cache_dir(), ==, dir);
+
+  return dir;
+}
+
+void
+test_remove_dir(const gchar *path)
+{
+  GDir *dir = g_dir_open(path, 0, NULL);
+
+  if (dir)
+  {
+    const gchar *name;
+
+    while ((name = g_dir_read_name(dir)))
+    {
+      gchar *child = g_build_filename(path, name, NULL);
+
+      if (g_file_test(child, G_FILE_TEST_IS_DIR) &&
+          !g_file_test(child, G_FILE_TEST_IS_SYMLINK))
+      {
+        test_remove_dir(child);
+      }
+      else
+        g_remove(child);
+
+      g_free(child);
+    }
+
+    g_dir_close(dir);
+  }
+
+  g_rmdir(path);
+}
@@ -0,0 +1,46 @@
+/*
+ * test-common.h
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _TEST_COMMON_H_
+#define _TEST_COMMON_H_
+
+#include "accounts-list.h"
+#include "account-plugin.h"
+
+G_BEGIN_DECLS
+
+#define TEST_TYPE_ACCOUNTS_LIST (test_accounts_list_get_type ())
+#define TEST_TYPE_PLUGIN (test_plugin_get_type ())
+
+GType test_accounts_list_get_type (void) G_GNUC_CONST;
+GType test_plugin_get_type (void) G_GNUC_CONST;
+
+AccountsList *test_accounts_list_new (void);
+AccountPlugin *test_plugin_new (const gchar *name);
+AccountService *test_service_new (AccountPlugin *plugin, const gchar *name,
+                                  const gchar *display_name);
+AccountItem *test_item_new (AccountService *service, const gchar *name,
+                            const gchar *display_name);
+
+gchar *test_setup_cache_dir (void);
+void test_remove_dir (const gchar *path);
+
+G_END_DECLS
+
+#endif /* _TEST_COMMON_H_ */
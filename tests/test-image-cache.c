@@ -0,0 +1,138 @@
+/*
+ * test-image-cache.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "accounts-image-cache.h"
+
+#define SIZE 16
+
+static GdkPixbuf *
+new_pixbuf(gint size)
+{
+  return gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, size, size);
+}
+
+static gboolean
+cached(AccountsImageCache *cache, const gchar *key, gint size)
+{
+  GdkPixbuf *pixbuf = accounts_image_cache_lookup(cache, key, size);
+
+  if (!pixbuf)
+    return FALSE;
+
+  g_object_unref(pixbuf);
+
+  return TRUE;
+}
+
+static void
+test_lru_eviction(void)
+{
+  GdkPixbuf *pixbuf = new_pixbuf(SIZE);
+  gsize length = gdk_pixbuf_get_byte_length(pixbuf);
+  AccountsImageCache *cache = accounts_image_cache_new(2 * length);
+
+  accounts_image_cache_insert(cache, "a", SIZE, pixbuf);
+  accounts_image_cache_insert(cache, "b", SIZE, pixbuf);
+  g_assert_cmpuint(accounts_image_cache_get_size(cache), ==, 2 * length);
+
+  /* a lookup makes "a" the most recently used */
+  g_assert_true(cached(cache, "a", SIZE));
+  accounts_image_cache_insert(cache, "c", SIZE, pixbuf);
+  g_assert_cmpuint(accounts_image_cache_get_size(cache), ==, 2 * length);
+  g_assert_false(cached(cache, "b", SIZE));
+  g_assert_true(cached(cache, "a", SIZE));
+  g_assert_true(cached(cache, "c", SIZE));
+
+  /* shrinking the budget evicts right away, "a" is the oldest now */
+  accounts_image_cache_set_budget(cache, length);
+  g_assert_cmpuint(accounts_image_cache_get_size(cache), ==, length);
+  g_assert_false(cached(cache, "a", SIZE));
+  g_assert_true(cached(cache, "c", SIZE));
+
+  /* replacing an entry does not count it twice */
+  accounts_image_cache_insert(cache, "c", SIZE, pixbuf);
+  g_assert_cmpuint(accounts_image_cache_get_size(cache), ==, length);
+  g_assert_true(cached(cache, "c", SIZE));
+
+  g_object_unref(cache);
+  g_object_unref(pixbuf);
+}
+
+static void
+test_oversized(void)
+{
+  GdkPixbuf *small = new_pixbuf(SIZE);
+  GdkPixbuf *big = new_pixbuf(2 * SIZE);
+  gsize length = gdk_pixbuf_get_byte_length(small);
+  AccountsImageCache *cache = accounts_image_cache_new(length);
+
+  accounts_image_cache_insert(cache, "small", SIZE, small);
+
+  /* the last inserted image is kept, even when over the budget */
+  accounts_image_cache_insert(cache, "big", 2 * SIZE, big);
+  g_assert_false(cached(cache, "small", SIZE));
+  g_assert_true(cached(cache, "big", 2 * SIZE));
+  g_assert_cmpuint(accounts_image_cache_get_size(cache), ==,
+                   gdk_pixbuf_get_byte_length(big));
+
+  g_object_unref(cache);
+  g_object_unref(big);
+  g_object_unref(small);
+}
+
+static void
+test_remove(void)
+{
+  GdkPixbuf *small = new_pixbuf(SIZE);
+  GdkPixbuf *big = new_pixbuf(2 * SIZE);
+  AccountsImageCache *cache = accounts_image_cache_new(G_MAXSIZE);
+
+  /* the sizes of an image are cached separately */
+  accounts_image_cache_insert(cache, "a", SIZE, small);
+  accounts_image_cache_insert(cache, "a", 2 * SIZE, big);
+  accounts_image_cache_insert(cache, "b", SIZE, small);
+  g_assert_true(cached(cache, "a", SIZE));
+  g_assert_true(cached(cache, "a", 2 * SIZE));
+
+  /* and removed together */
+  accounts_image_cache_remove(cache, "a");
+  g_assert_false(cached(cache, "a", SIZE));
+  g_assert_false(cached(cache, "a", 2 * SIZE));
+  g_assert_true(cached(cache, "b", SIZE));
+  g_assert_cmpuint(accounts_image_cache_get_size(cache), ==,
+                   gdk_pixbuf_get_byte_length(small));
+
+  g_object_unref(cache);
+  g_object_unref(big);
+  g_object_unref(small);
+}
+
+int
+main(int argc, char **argv)
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_func("/image-cache/lru-eviction", test_lru_eviction);
+  g_test_add_func("/image-cache/oversized", test_oversized);
+  g_test_add_func("/image-cache/remove", test_remove);
+
+  return g_test_run();
+}
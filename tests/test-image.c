@@ -0,0 +1,499 @@
+/*
+ * test-image.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <utime.h>
+
+#include <glib/gstdio.h>
+
+#include "accounts-image.h"
+#include "accounts-image-cache.h"
+
+#include "test-common.h"
+
+#define COLOR 0x336699ff
+
+/* the header of thumbnails, as written by accounts-image.c */
+typedef struct
+{
+  guint32 magic;
+  guint32 version;
+  gint32 width;
+  gint32 height;
+  gint32 rowstride;
+  guint32 has_alpha;
+  guint32 reserved[2];
+} ThumbnailHeader;
+
+#define THUMBNAIL_MAGIC 0x5443414cu
+#define THUMBNAIL_MAX_BYTES (1024 * 1024)
+
+typedef struct
+{
+  const gchar *name;
+  void (*corrupt) (ThumbnailHeader *header, gsize *length);
+} Corruption;
+
+static GBytes *
+encode_png(gint width, gint height)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, width,
+                                     height);
+  GError *error = NULL;
+  gchar *buffer;
+  gsize size;
+
+  gdk_pixbuf_fill(pixbuf, COLOR);
+  gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &size, "png", &error, NULL);
+  g_assert_no_error(error);
+  g_object_unref(pixbuf);
+
+  return g_bytes_new_take(buffer, size);
+}
+
+static GdkPixbuf *
+load(AccountsImage *image)
+{
+  GError *error = NULL;
+  GdkPixbuf *pixbuf = accounts_image_load(image, &error);
+
+  g_assert_no_error(error);
+  g_assert_nonnull(pixbuf);
+
+  return pixbuf;
+}
+
+/* whether the first pixel of @pixbuf is @rgb */
+static gboolean
+has_color(GdkPixbuf *pixbuf, guint32 rgb)
+{
+  const guint8 *pixels = gdk_pixbuf_read_pixels(pixbuf);
+
+  return pixels[0] == ((rgb >> 16) & 0xff) &&
+         pixels[1] == ((rgb >> 8) & 0xff) &&
+         pixels[2] == (rgb & 0xff);
+}
+
+static gchar *
+thumbnail_path(AccountsImage *image)
+{
+  const gchar *key = accounts_image_get_key(image);
+  gchar *name;
+  gchar *path;
+
+  g_assert_true(g_str_has_prefix(key, "sha256:"));
+  name = g_strdup_printf("%s-0.raw", key + strlen("sha256:"));
+  path = g_build_filename(g_get_user_cache_dir(), "libaccounts",
+                          "thumbnails", name, NULL);
+  g_free(name);
+
+  return path;
+}
+
+/* drops the decoded image from memory, so the next load reads the thumbnail */
+static void
+forget(AccountsImage *image)
+{
+  accounts_image_cache_remove(accounts_image_cache_get_default(),
+                              accounts_image_get_key(image));
+}
+
+static void
+test_key_is_lazy(void)
+{
+  GBytes *bytes = encode_png(3, 3);
+  AccountsImage *image = accounts_image_new_from_bytes(bytes);
+  AccountsImage *copy = accounts_image_new_from_bytes(bytes);
+  GdkPixbuf *pixbuf;
+  GdkPixbuf *copy_pixbuf;
+
+  /* hashed on the first decode only */
+  g_assert_null(accounts_image_get_key(image));
+  pixbuf = load(image);
+  g_assert_true(g_str_has_prefix(accounts_image_get_key(image), "sha256:"));
+  g_assert_null(accounts_image_get_key(copy));
+
+  /* images of the same data share the decoded pixbuf */
+  copy_pixbuf = load(copy);
+  g_assert_cmpstr(accounts_image_get_key(copy), ==,
+                  accounts_image_get_key(image));
+  g_assert_true(copy_pixbuf == pixbuf);
+
+  g_object_unref(copy_pixbuf);
+  g_object_unref(pixbuf);
+  g_object_unref(copy);
+  g_object_unref(image);
+  g_bytes_unref(bytes);
+}
+
+static void
+test_thumbnail(void)
+{
+  GBytes *bytes = encode_png(5, 4);
+  AccountsImage *image = accounts_image_new_from_bytes(bytes);
+  GdkPixbuf *pixbuf = load(image);
+  GError *error = NULL;
+  gchar *path = thumbnail_path(image);
+  gchar *contents;
+  gsize length;
+
+  g_assert_true(has_color(pixbuf, COLOR >> 8));
+  g_object_unref(pixbuf);
+  forget(image);
+
+  /* change the thumbnail, to tell whether it is read back */
+  g_file_get_contents(path, &contents, &length, &error);
+  g_assert_no_error(error);
+  g_assert_cmpuint(length, >, sizeof(ThumbnailHeader) + 3);
+  memcpy(contents + sizeof(ThumbnailHeader), "\x00\xff\x00", 3);
+  g_file_set_contents(path, contents, length, &error);
+  g_assert_no_error(error);
+  g_free(contents);
+
+  pixbuf = load(image);
+  g_assert_cmpint(gdk_pixbuf_get_width(pixbuf), ==, 5);
+  g_assert_cmpint(gdk_pixbuf_get_height(pixbuf), ==, 4);
+  g_assert_true(has_color(pixbuf, 0x00ff00));
+
+  g_object_unref(pixbuf);
+  g_object_unref(image);
+  g_free(path);
+  g_bytes_unref(bytes);
+}
+
+static void
+bad_magic(ThumbnailHeader *header, gsize *length)
+{
+  header->magic ^= 1;
+}
+
+static void
+bad_version(ThumbnailHeader *header, gsize *length)
+{
+  header->version++;
+}
+
+static void
+huge_width(ThumbnailHeader *header, gsize *length)
+{
+  header->width = G_MAXINT32;
+}
+
+static void
+zero_height(ThumbnailHeader *header, gsize *length)
+{
+  header->height = 0;
+}
+
+static void
+short_rowstride(ThumbnailHeader *header, gsize *length)
+{
+  header->rowstride = header->width * 3 - 1;
+}
+
+/* each field is in range, but not the size of the pixels they describe */
+static void
+huge_pixels(ThumbnailHeader *header, gsize *length)
+{
+  header->width = 1;
+  header->height = THUMBNAIL_MAX_BYTES;
+  header->rowstride = THUMBNAIL_MAX_BYTES;
+}
+
+static void
+truncated(ThumbnailHeader *header, gsize *length)
+{
+  *length = sizeof(*header) + (*length - sizeof(*header)) / 2;
+}
+
+static const Corruption corruptions[] =
+{
+  { "bad-magic", bad_magic },
+  { "bad-version", bad_version },
+  { "huge-width", huge_width },
+  { "zero-height", zero_height },
+  { "short-rowstride", short_rowstride },
+  { "huge-pixels", huge_pixels },
+  { "truncated", truncated }
+};
+
+static void
+test_invalid_thumbnail(gconstpointer data)
+{
+  const Corruption *corruption = data;
+  GBytes *bytes = encode_png(7, 5);
+  AccountsImage *image = accounts_image_new_from_bytes(bytes);
+  GdkPixbuf *pixbuf = load(image);
+  GError *error = NULL;
+  gchar *path = thumbnail_path(image);
+  ThumbnailHeader *header;
+  gchar *contents;
+  gsize length;
+
+  g_object_unref(pixbuf);
+  forget(image);
+
+  g_file_get_contents(path, &contents, &length, &error);
+  g_assert_no_error(error);
+  g_assert_cmpuint(length, >, sizeof(*header));
+  corruption->corrupt((ThumbnailHeader *)contents, &length);
+  g_file_set_contents(path, contents, length, &error);
+  g_assert_no_error(error);
+  g_free(contents);
+
+  /* the invalid thumbnail is ignored, and replaced */
+  pixbuf = load(image);
+  g_assert_cmpint(gdk_pixbuf_get_width(pixbuf), ==, 7);
+  g_assert_cmpint(gdk_pixbuf_get_height(pixbuf), ==, 5);
+  g_assert_true(has_color(pixbuf, COLOR >> 8));
+
+  g_file_get_contents(path, &contents, &length, &error);
+  g_assert_no_error(error);
+  g_assert_cmpuint(length, ==,
+                   sizeof(*header) + gdk_pixbuf_get_byte_length(pixbuf));
+  header = (ThumbnailHeader *)contents;
+  g_assert_cmphex(header->magic, ==, THUMBNAIL_MAGIC);
+  g_assert_cmpint(header->width, ==, 7);
+  g_assert_cmpint(header->height, ==, 5);
+  g_assert_cmpint(header->rowstride, ==, gdk_pixbuf_get_rowstride(pixbuf));
+  g_free(contents);
+
+  g_object_unref(pixbuf);
+  forget(image);
+  g_object_unref(image);
+  g_free(path);
+  g_bytes_unref(bytes);
+}
+
+static void
+on_avatar_notify(GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+  gboolean *notified = user_data;
+
+  *notified = TRUE;
+}
+
+static void
+wait_for_avatar(AccountItem *item)
+{
+  gboolean notified = FALSE;
+  gulong id = g_signal_connect(item, "notify::avatar",
+                               G_CALLBACK(on_avatar_notify), &notified);
+
+  while (!notified)
+    g_main_context_iteration(NULL, TRUE);
+
+  g_signal_handler_disconnect(item, id);
+}
+
+static void
+test_item_avatar_not_kept(void)
+{
+  GBytes *bytes = encode_png(9, 9);
+  AccountsImage *image = accounts_image_new_from_bytes(bytes);
+  AccountItem *item = g_object_new(ACCOUNT_TYPE_ITEM, "name", "alice", NULL);
+  GdkPixbuf *avatar;
+
+  account_item_set_avatar_image(item, image);
+
+  /* decoded in a worker thread when first read */
+  g_assert_null(account_item_get_avatar(item));
+  wait_for_avatar(item);
+  avatar = account_item_get_avatar(item);
+  g_assert_nonnull(avatar);
+  g_assert_true(account_item_get_avatar(item) == avatar);
+
+  /* the item does not keep the avatar once the cache evicted it */
+  forget(image);
+
+  while (g_main_context_iteration(NULL, FALSE))
+    ;
+
+  g_assert_null(account_item_get_avatar(item));
+  wait_for_avatar(item);
+  g_assert_nonnull(account_item_get_avatar(item));
+
+  g_object_unref(item);
+  g_object_unref(image);
+  g_bytes_unref(bytes);
+}
+
+static void
+test_item_avatar_data(void)
+{
+  GBytes *bytes = encode_png(11, 11);
+  AccountItem *item = g_object_new(ACCOUNT_TYPE_ITEM, "name", "bob", NULL);
+  AccountsImage *image;
+
+  account_item_set_avatar_data(item, bytes);
+  image = account_item_get_avatar_image(item);
+  g_assert_nonnull(image);
+
+  while (g_main_context_iteration(NULL, FALSE))
+    ;
+
+  /* not decoded, so not even hashed, until displayed */
+  g_assert_null(accounts_image_get_key(image));
+
+  g_object_unref(item);
+  g_bytes_unref(bytes);
+}
+
+static void
+test_item_avatar_at_size(void)
+{
+  GBytes *bytes = encode_png(64, 32);
+  AccountsImage *image = accounts_image_new_from_bytes(bytes);
+  AccountItem *item = g_object_new(ACCOUNT_TYPE_ITEM, "name", "carol", NULL);
+  GdkPixbuf *avatar;
+
+  account_item_set_avatar_image(item, image);
+
+  /* decoded in a worker thread, not while being asked for */
+  g_assert_null(account_item_get_avatar_at_size(item, 16));
+  wait_for_avatar(item);
+
+  avatar = account_item_get_avatar_at_size(item, 16);
+  g_assert_nonnull(avatar);
+  g_assert_cmpint(gdk_pixbuf_get_width(avatar), ==, 16);
+  g_assert_cmpint(gdk_pixbuf_get_height(avatar), ==, 8);
+  g_object_unref(avatar);
+
+  g_object_unref(item);
+  g_object_unref(image);
+  g_bytes_unref(bytes);
+}
+
+static void
+test_no_big_thumbnails(void)
+{
+  GBytes *bytes = encode_png(600, 600);
+  AccountsImage *image = accounts_image_new_from_bytes(bytes);
+  GdkPixbuf *pixbuf = load(image);
+  gchar *path = thumbnail_path(image);
+
+  /* more than THUMBNAIL_MAX_BYTES of pixels */
+  g_assert_false(g_file_test(path, G_FILE_TEST_EXISTS));
+
+  g_object_unref(pixbuf);
+  forget(image);
+  g_object_unref(image);
+  g_free(path);
+  g_bytes_unref(bytes);
+}
+
+static gchar *
+write_old_thumbnail(const gchar *name, gsize length, time_t mtime)
+{
+  gchar *dir = g_build_filename(g_get_user_cache_dir(), "libaccounts",
+                                "thumbnails", NULL);
+  gchar *path = g_build_filename(dir, name, NULL);
+  gchar *contents = g_malloc0(length);
+  GError *error = NULL;
+  struct utimbuf times;
+
+  g_assert_cmpint(g_mkdir_with_parents(dir, 0700), ==, 0);
+  g_file_set_contents(path, contents, length, &error);
+  g_assert_no_error(error);
+
+  times.actime = mtime;
+  times.modtime = mtime;
+  g_assert_cmpint(g_utime(path, &times), ==, 0);
+
+  g_free(contents);
+  g_free(dir);
+
+  return path;
+}
+
+static void
+test_thumbnail_budget(void)
+{
+  gsize budget = accounts_image_get_thumbnail_budget();
+  gchar *paths[4];
+  guint i;
+
+  /* starts from an empty directory */
+  accounts_image_set_thumbnail_budget(0);
+
+  for (i = 0; i < G_N_ELEMENTS(paths); i++)
+  {
+    gchar *name = g_strdup_printf("old-%u-0.raw", i);
+
+    paths[i] = write_old_thumbnail(name, 1000, 1000000 + i * 1000);
+    g_free(name);
+  }
+
+  accounts_image_set_thumbnail_budget(4000);
+  g_assert_true(g_file_test(paths[0], G_FILE_TEST_EXISTS));
+
+  /* the oldest are removed, down to 3/4 of the budget */
+  accounts_image_set_thumbnail_budget(3000);
+  g_assert_false(g_file_test(paths[0], G_FILE_TEST_EXISTS));
+  g_assert_false(g_file_test(paths[1], G_FILE_TEST_EXISTS));
+  g_assert_true(g_file_test(paths[2], G_FILE_TEST_EXISTS));
+  g_assert_true(g_file_test(paths[3], G_FILE_TEST_EXISTS));
+
+  accounts_image_set_thumbnail_budget(budget);
+  g_assert_cmpuint(accounts_image_get_thumbnail_budget(), ==, budget);
+
+  for (i = 0; i < G_N_ELEMENTS(paths); i++)
+  {
+    g_unlink(paths[i]);
+    g_free(paths[i]);
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  gchar *cache_dir;
+  guint i;
+  int rv;
+
+  g_test_init(&argc, &argv, NULL);
+  cache_dir = test_setup_cache_dir();
+
+  g_test_add_func("/image/key-is-lazy", test_key_is_lazy);
+  g_test_add_func("/image/thumbnail", test_thumbnail);
+
+  for (i = 0; i < G_N_ELEMENTS(corruptions); i++)
+  {
+    gchar *path = g_strconcat("/image/invalid-thumbnail/",
+                              corruptions[i].name, NULL);
+
+    g_test_add_data_func(path, &corruptions[i], test_invalid_thumbnail);
+    g_free(path);
+  }
+
+  g_test_add_func("/image/no-big-thumbnails", test_no_big_thumbnails);
+  g_test_add_func("/image/thumbnail-budget", test_thumbnail_budget);
+  g_test_add_func("/image/item-avatar-not-kept", test_item_avatar_not_kept);
+  g_test_add_func("/image/item-avatar-data", test_item_avatar_data);
+  g_test_add_func("/image/item-avatar-at-size", test_item_avatar_at_size);
+
+  rv = g_test_run();
+
+  test_remove_dir(cache_dir);
+  g_free(cache_dir);
+
+  return rv;
+}
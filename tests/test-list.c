@@ -0,0 +1,223 @@
+/*
+ * test-list.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "accounts-image.h"
+
+#include "test-common.h"
+
+typedef struct _Fixture
+{
+  AccountsList *list;
+  AccountPlugin *plugin;
+  AccountService *service;
+} Fixture;
+
+static void
+fixture_setup(Fixture *fixture, gconstpointer data)
+{
+  fixture->list = test_accounts_list_new();
+  fixture->plugin = test_plugin_new("test");
+  fixture->service = test_service_new(fixture->plugin, "sip", "SIP");
+}
+
+static void
+fixture_teardown(Fixture *fixture, gconstpointer data)
+{
+  g_object_unref(fixture->list);
+  g_object_unref(fixture->service);
+  g_object_unref(fixture->plugin);
+}
+
+static void
+on_notify(GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+  GHashTable *notified = user_data;
+
+  /* the names of properties are interned */
+  g_hash_table_add(notified, (gpointer)pspec->name);
+}
+
+static void
+test_replace(Fixture *fixture, gconstpointer data)
+{
+  AccountItem *alice = test_item_new(fixture->service, "alice", "Alice");
+  AccountItem *bob = test_item_new(fixture->service, "bob", "Bob");
+  AccountItem *new_alice;
+  AccountItem *carol;
+  GHashTable *notified;
+  GList *items;
+  GList *result;
+  GList *all;
+
+  accounts_list_add(fixture->list, alice);
+  accounts_list_add(fixture->list, bob);
+
+  notified = g_hash_table_new(g_str_hash, g_str_equal);
+  g_signal_connect(alice, "notify", G_CALLBACK(on_notify), notified);
+
+  /* the plugin reports carol, alice renamed, and no longer bob */
+  carol = test_item_new(fixture->service, "carol", "Carol");
+  new_alice = test_item_new(fixture->service, "alice", "Alice Smith");
+  items = g_list_append(NULL, carol);
+  items = g_list_append(items, new_alice);
+
+  result = accounts_list_replace_for_plugin(fixture->list, fixture->plugin,
+                                            items);
+
+  /* the registered alice is kept, in the order of items */
+  g_assert_cmpuint(g_list_length(result), ==, 2);
+  g_assert_true(result->data == carol);
+  g_assert_true(result->next->data == alice);
+  g_list_free(result);
+
+  g_assert_cmpstr(account_item_get_display_name(alice), ==, "Alice Smith");
+  g_assert_true(g_hash_table_contains(notified, "display-name"));
+  g_assert_false(g_hash_table_contains(notified, "name"));
+  g_assert_false(g_hash_table_contains(notified, "avatar"));
+
+  all = accounts_list_get_all(fixture->list);
+  g_assert_cmpuint(g_list_length(all), ==, 2);
+  g_assert_nonnull(g_list_find(all, alice));
+  g_assert_nonnull(g_list_find(all, carol));
+  g_assert_null(g_list_find(all, bob));
+  g_assert_null(g_list_find(all, new_alice));
+  g_list_free_full(all, g_object_unref);
+
+  /* nothing changes when reporting the same accounts again */
+  g_hash_table_remove_all(notified);
+  result = accounts_list_replace_for_plugin(fixture->list, fixture->plugin,
+                                            items);
+  g_assert_cmpuint(g_hash_table_size(notified), ==, 0);
+  g_list_free(result);
+
+  g_signal_handlers_disconnect_by_func(alice, on_notify, notified);
+  g_hash_table_destroy(notified);
+  g_list_free(items);
+  g_object_unref(new_alice);
+  g_object_unref(carol);
+  g_object_unref(bob);
+  g_object_unref(alice);
+}
+
+static void
+test_replace_avatar_image(Fixture *fixture, gconstpointer data)
+{
+  AccountItem *alice = test_item_new(fixture->service, "alice", "Alice");
+  AccountItem *new_alice = test_item_new(fixture->service, "alice", "Alice");
+  AccountsImage *image;
+  GBytes *bytes;
+  GList *items;
+  GList *result;
+
+  accounts_list_add(fixture->list, alice);
+
+  /* never decoded, so not even valid image data is needed */
+  bytes = g_bytes_new_static("not an image", 12);
+  image = accounts_image_new_from_bytes(bytes);
+  account_item_set_avatar_image(new_alice, image);
+
+  items = g_list_append(NULL, new_alice);
+  result = accounts_list_replace_for_plugin(fixture->list, fixture->plugin,
+                                            items);
+  g_assert_true(result->data == alice);
+  g_list_free(result);
+
+  /* the image is shared as is, without decoding or hashing it */
+  g_assert_true(account_item_get_avatar_image(alice) == image);
+  g_assert_null(alice->avatar);
+  g_assert_null(accounts_image_get_key(image));
+
+  g_list_free(items);
+  g_object_unref(image);
+  g_bytes_unref(bytes);
+  g_object_unref(new_alice);
+  g_object_unref(alice);
+}
+
+static void
+test_replace_same_name(Fixture *fixture, gconstpointer data)
+{
+  AccountItem *registered[3];
+  AccountItem *reported[2];
+  GList *items = NULL;
+  GList *result;
+  GList *all;
+  guint i;
+
+  /* nothing prevents a plugin from having accounts with the same name */
+  for (i = 0; i < G_N_ELEMENTS(registered); i++)
+  {
+    registered[i] = test_item_new(fixture->service, "alice", "Alice");
+    accounts_list_add(fixture->list, registered[i]);
+  }
+
+  for (i = 0; i < G_N_ELEMENTS(reported); i++)
+  {
+    reported[i] = test_item_new(fixture->service, "alice", "Alice");
+    items = g_list_append(items, reported[i]);
+  }
+
+  result = accounts_list_replace_for_plugin(fixture->list, fixture->plugin,
+                                            items);
+
+  /* matched by a different registered account each, in their order */
+  g_assert_cmpuint(g_list_length(result), ==, 2);
+  g_assert_true(result->data == registered[0]);
+  g_assert_true(result->next->data == registered[1]);
+
+  all = accounts_list_get_all(fixture->list);
+  g_assert_cmpuint(g_list_length(all), ==, 2);
+  g_assert_nonnull(g_list_find(all, registered[0]));
+  g_assert_nonnull(g_list_find(all, registered[1]));
+  g_assert_null(g_list_find(all, registered[2]));
+  g_list_free_full(all, g_object_unref);
+  g_list_free(result);
+  g_list_free(items);
+
+  /* and all of them are removed when none is reported anymore */
+  result = accounts_list_replace_for_plugin(fixture->list, fixture->plugin,
+                                            NULL);
+  g_assert_null(result);
+
+  all = accounts_list_get_all(fixture->list);
+  g_assert_null(all);
+
+  for (i = 0; i < G_N_ELEMENTS(reported); i++)
+    g_object_unref(reported[i]);
+
+  for (i = 0; i < G_N_ELEMENTS(registered); i++)
+    g_object_unref(registered[i]);
+}
+
+int
+main(int argc, char **argv)
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/list/replace", Fixture, NULL, fixture_setup, test_replace,
+             fixture_teardown);
+  g_test_add("/list/replace-avatar-image", Fixture, NULL, fixture_setup,
+             test_replace_avatar_image, fixture_teardown);
+  g_test_add("/list/replace-same-name", Fixture, NULL, fixture_setup,
+             test_replace_same_name, fixture_teardown);
+
+  return g_test_run();
+}
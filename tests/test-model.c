@@ -0,0 +1,336 @@
+/*
+ * test-model.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "accounts-filter.h"
+#include "accounts-model.h"
+#include "accounts-snapshot.h"
+#include "accounts-sorted-view.h"
+
+#include "test-common.h"
+
+#define CHANGE_LOG_SIZE 4
+
+typedef struct _Fixture
+{
+  AccountsList *list;
+  AccountPlugin *plugin;
+  AccountService *service;
+  AccountsModel *model;
+} Fixture;
+
+static void
+fixture_setup(Fixture *fixture, gconstpointer data)
+{
+  fixture->list = test_accounts_list_new();
+  fixture->plugin = test_plugin_new("test");
+  fixture->service = test_service_new(fixture->plugin, "jabber", "Jabber");
+  fixture->model = g_object_new(ACCOUNTS_TYPE_MODEL,
+                                "accounts-list", fixture->list,
+                                "change-log-size", CHANGE_LOG_SIZE,
+                                NULL);
+}
+
+static void
+fixture_teardown(Fixture *fixture, gconstpointer data)
+{
+  g_object_unref(fixture->model);
+  g_object_unref(fixture->list);
+  g_object_unref(fixture->service);
+  g_object_unref(fixture->plugin);
+}
+
+static AccountItem *
+add_item(Fixture *fixture, const gchar *name)
+{
+  AccountItem *item = test_item_new(fixture->service, name, name);
+
+  accounts_list_add(fixture->list, item);
+  g_object_unref(item);
+
+  return item;
+}
+
+static void
+test_change_log_boundaries(Fixture *fixture, gconstpointer data)
+{
+  AccountsModel *model = fixture->model;
+  AccountItem *items[CHANGE_LOG_SIZE + 1];
+  GArray *changes;
+  AccountsChange *change;
+  guint i;
+
+  g_assert_cmpuint(accounts_model_get_sequence(model), ==, 0);
+  g_assert_true(accounts_model_changes_since(model, 0, &changes));
+  g_assert_cmpuint(changes->len, ==, 0);
+  g_array_unref(changes);
+
+  for (i = 0; i < G_N_ELEMENTS(items); i++)
+  {
+    gchar *name = g_strdup_printf("user%u@example.com", i);
+
+    items[i] = add_item(fixture, name);
+    g_free(name);
+  }
+
+  /* one change more than the log holds, the first one is gone */
+  g_assert_cmpuint(accounts_model_get_sequence(model), ==,
+                   CHANGE_LOG_SIZE + 1);
+  g_assert_false(accounts_model_changes_since(model, 0, &changes));
+  g_assert_null(changes);
+
+  g_assert_true(accounts_model_changes_since(model, 1, &changes));
+  g_assert_cmpuint(changes->len, ==, CHANGE_LOG_SIZE);
+
+  for (i = 0; i < changes->len; i++)
+  {
+    change = &g_array_index(changes, AccountsChange, i);
+    g_assert_cmpuint(change->sequence, ==, i + 2);
+    g_assert_cmpint(change->type, ==, ACCOUNTS_CHANGE_ADDED);
+    g_assert_cmpuint(change->id, ==,
+                     accounts_model_get_item_id(model, items[i + 1]));
+    g_assert_null(change->property);
+  }
+
+  g_array_unref(changes);
+
+  /* wrap around the ring buffer */
+  account_item_set_display_name(items[0], "Renamed");
+  g_assert_cmpuint(accounts_model_get_sequence(model), ==,
+                   CHANGE_LOG_SIZE + 2);
+  g_assert_false(accounts_model_changes_since(model, 1, &changes));
+  g_assert_true(accounts_model_changes_since(model, 2, &changes));
+  g_assert_cmpuint(changes->len, ==, CHANGE_LOG_SIZE);
+
+  change = &g_array_index(changes, AccountsChange, 0);
+  g_assert_cmpuint(change->sequence, ==, 3);
+
+  change = &g_array_index(changes, AccountsChange, CHANGE_LOG_SIZE - 1);
+  g_assert_cmpuint(change->sequence, ==, CHANGE_LOG_SIZE + 2);
+  g_assert_cmpint(change->type, ==, ACCOUNTS_CHANGE_PROPERTY);
+  g_assert_cmpuint(change->id, ==,
+                   accounts_model_get_item_id(model, items[0]));
+  g_assert_cmpstr(change->property, ==, "display-name");
+  g_array_unref(changes);
+
+  accounts_list_remove(fixture->list, items[1]);
+  g_assert_true(accounts_model_changes_since(model, CHANGE_LOG_SIZE + 2,
+                                             &changes));
+  g_assert_cmpuint(changes->len, ==, 1);
+  change = &g_array_index(changes, AccountsChange, 0);
+  g_assert_cmpint(change->type, ==, ACCOUNTS_CHANGE_REMOVED);
+  g_array_unref(changes);
+
+  /* up to date, and ahead of the model */
+  g_assert_true(accounts_model_changes_since(model, CHANGE_LOG_SIZE + 3,
+                                             &changes));
+  g_assert_cmpuint(changes->len, ==, 0);
+  g_array_unref(changes);
+  g_assert_false(accounts_model_changes_since(model, CHANGE_LOG_SIZE + 4,
+                                              &changes));
+  g_assert_null(changes);
+}
+
+static void
+test_snapshot(Fixture *fixture, gconstpointer data)
+{
+  AccountItem *item = add_item(fixture, "alice@example.com");
+  AccountsSnapshot *before;
+  AccountsSnapshot *after;
+  const AccountsRecord *record;
+  guint id;
+
+  before = accounts_model_get_snapshot(fixture->model);
+  g_assert_cmpuint(accounts_snapshot_get_n_records(before), ==, 1);
+  g_assert_cmpuint(accounts_snapshot_get_sequence(before), ==,
+                   accounts_model_get_sequence(fixture->model));
+
+  account_item_set_display_name(item, "Alice");
+  after = accounts_model_get_snapshot(fixture->model);
+  g_assert_true(before != after);
+
+  /* the published snapshot never changes */
+  id = accounts_model_get_item_id(fixture->model, item);
+  record = accounts_snapshot_lookup(before, id);
+  g_assert_nonnull(record);
+  g_assert_cmpstr(accounts_record_get_display_name(record), ==,
+                  "alice@example.com");
+
+  record = accounts_snapshot_lookup(after, id);
+  g_assert_nonnull(record);
+  g_assert_cmpstr(accounts_record_get_display_name(record), ==, "Alice");
+  g_assert_cmpstr(accounts_record_get_name(record), ==, "alice@example.com");
+  g_assert_cmpstr(accounts_record_get_service(record), ==, "jabber");
+
+  accounts_snapshot_unref(before);
+  accounts_snapshot_unref(after);
+}
+
+static gpointer
+read_snapshot(gpointer data)
+{
+  return accounts_model_get_snapshot(data);
+}
+
+static void
+test_snapshot_from_thread(Fixture *fixture, gconstpointer data)
+{
+  AccountsSnapshot *snapshot;
+  GThread *thread;
+
+  add_item(fixture, "bob@example.com");
+  thread = g_thread_new("reader", read_snapshot, fixture->model);
+  snapshot = g_thread_join(thread);
+
+  g_assert_cmpuint(accounts_snapshot_get_n_records(snapshot), ==, 1);
+  g_assert_cmpstr(
+      accounts_record_get_name(accounts_snapshot_get_record(snapshot, 0)), ==,
+      "bob@example.com");
+
+  accounts_snapshot_unref(snapshot);
+}
+
+static void
+on_items_updated(AccountsModel *model, GPtrArray *updates, gpointer user_data)
+{
+  guint *n_updates = user_data;
+
+  *n_updates += updates->len;
+}
+
+static gboolean
+timeout_cb(gpointer user_data)
+{
+  gboolean *timed_out = user_data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_coalesce_interval_change(Fixture *fixture, gconstpointer data)
+{
+  AccountItem *item = add_item(fixture, "bob@example.com");
+  gboolean timed_out = FALSE;
+  guint n_updates = 0;
+  guint timeout_id;
+
+  accounts_model_set_coalesce_interval(fixture->model, 60000);
+  g_signal_connect(fixture->model, "items-updated",
+                   G_CALLBACK(on_items_updated), &n_updates);
+
+  account_item_set_display_name(item, "Bob");
+  g_assert_cmpuint(n_updates, ==, 0);
+
+  /* shortening the interval reschedules the pending update */
+  accounts_model_set_coalesce_interval(fixture->model, 10);
+  timeout_id = g_timeout_add(5000, timeout_cb, &timed_out);
+
+  while (!n_updates && !timed_out)
+    g_main_context_iteration(NULL, TRUE);
+
+  g_assert_false(timed_out);
+  g_assert_cmpuint(n_updates, ==, 1);
+  g_source_remove(timeout_id);
+}
+
+static void
+test_sorted_view_priority(Fixture *fixture, gconstpointer data)
+{
+  AccountService *sip = test_service_new(fixture->plugin, "sip", "SIP");
+  AccountItem *alice = add_item(fixture, "alice@example.com");
+  AccountItem *bob = test_item_new(sip, "bob@example.com",
+                                   "bob@example.com");
+  AccountsSortedView *view;
+
+  accounts_list_add(fixture->list, bob);
+  g_object_unref(bob);
+  view = accounts_sorted_view_new(fixture->model);
+
+  g_assert_cmpint(accounts_sorted_view_get_position(view, alice), ==, 0);
+  g_assert_cmpint(accounts_sorted_view_get_position(view, bob), ==, 1);
+
+  /* the services are listed by ascending priority */
+  account_service_set_priority(sip, -1);
+  g_assert_true(accounts_sorted_view_get_item(view, 0) == bob);
+  g_assert_true(accounts_sorted_view_get_item(view, 1) == alice);
+  g_assert_cmpint(accounts_sorted_view_get_position(view, bob), ==, 0);
+
+  account_service_set_priority(fixture->service, -2);
+  g_assert_true(accounts_sorted_view_get_item(view, 0) == alice);
+  g_assert_cmpint(accounts_sorted_view_get_position(view, bob), ==, 1);
+
+  g_object_unref(view);
+  g_object_unref(sip);
+}
+
+static void
+test_filter_service(Fixture *fixture, gconstpointer data)
+{
+  gchar *name = g_strdup("filter-test-service");
+  AccountsFilter *filter;
+  AccountService *service;
+  AccountItem *item;
+  gchar *value;
+
+  add_item(fixture, "alice@example.com");
+  filter = accounts_filter_new(fixture->model, name, NULL, 0, 0);
+
+  /* the filter keeps its own copy, and doesn't intern it */
+  g_free(name);
+  g_object_get(filter, "service", &value, NULL);
+  g_assert_cmpstr(value, ==, "filter-test-service");
+  g_free(value);
+  g_assert_cmpuint(g_quark_try_string("filter-test-service"), ==, 0);
+  g_assert_cmpuint(accounts_filter_get_n_items(filter), ==, 0);
+
+  /* until an account of that service is added */
+  service = test_service_new(fixture->plugin, "filter-test-service", "Test");
+  item = test_item_new(service, "bob@example.com", "bob@example.com");
+  accounts_list_add(fixture->list, item);
+  g_assert_cmpuint(accounts_filter_get_n_items(filter), ==, 1);
+  g_assert_true(accounts_filter_contains(filter, item));
+
+  g_object_unref(item);
+  g_object_unref(service);
+  g_object_unref(filter);
+}
+
+int
+main(int argc, char **argv)
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/model/change-log-boundaries", Fixture, NULL, fixture_setup,
+             test_change_log_boundaries, fixture_teardown);
+  g_test_add("/model/snapshot", Fixture, NULL, fixture_setup, test_snapshot,
+             fixture_teardown);
+  g_test_add("/model/snapshot-from-thread", Fixture, NULL, fixture_setup,
+             test_snapshot_from_thread, fixture_teardown);
+  g_test_add("/model/coalesce-interval-change", Fixture, NULL, fixture_setup,
+             test_coalesce_interval_change, fixture_teardown);
+  g_test_add("/model/sorted-view-priority", Fixture, NULL, fixture_setup,
+             test_sorted_view_priority, fixture_teardown);
+  g_test_add("/model/filter-service", Fixture, NULL, fixture_setup,
+             test_filter_service, fixture_teardown);
+
+  return g_test_run();
+}
@@ -0,0 +1,322 @@
+/*
+ * test-plugin-manager.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <glib/gstdio.h>
+
+#include "account-plugin-manager.h"
+
+#include "test-common.h"
+
+typedef struct _Fixture
+{
+  gchar *plugin_dir;
+  gchar *module;
+  GList *plugin_paths;
+  AccountsList *list;
+  guint n_warnings;
+} Fixture;
+
+/* modules which are not valid plugins are reported as warnings */
+static gboolean
+count_warnings(const gchar *log_domain, GLogLevelFlags log_level,
+               const gchar *message, gpointer user_data)
+{
+  guint *n_warnings = user_data;
+
+  if (!(log_level & G_LOG_LEVEL_WARNING))
+    return TRUE;
+
+  (*n_warnings)++;
+
+  return FALSE;
+}
+
+static gchar *
+catalog_path(void)
+{
+  return g_build_filename(g_get_user_cache_dir(), "libaccounts",
+                          "services.catalog", NULL);
+}
+
+static gchar *
+add_module(Fixture *fixture, const gchar *name)
+{
+  gchar *path = g_build_filename(fixture->plugin_dir, name, NULL);
+  GError *error = NULL;
+
+  g_file_set_contents(path, "not a plugin", -1, &error);
+  g_assert_no_error(error);
+
+  return path;
+}
+
+static gint64
+module_mtime(const gchar *path)
+{
+  GStatBuf buf;
+
+  g_assert_cmpint(g_stat(path, &buf), ==, 0);
+
+  return buf.st_mtime;
+}
+
+static void
+fixture_setup(Fixture *fixture, gconstpointer data)
+{
+  gchar *cwd = g_get_current_dir();
+
+  /* in the build tree, as /tmp might not allow mapping executables */
+  fixture->plugin_dir = g_build_filename(cwd, "plugins-XXXXXX", NULL);
+  g_assert_nonnull(g_mkdtemp(fixture->plugin_dir));
+  g_free(cwd);
+  fixture->module = add_module(fixture, "libfake.so");
+  fixture->plugin_paths = g_list_append(NULL, fixture->plugin_dir);
+  fixture->list = test_accounts_list_new();
+
+  g_test_log_set_fatal_handler(count_warnings, &fixture->n_warnings);
+}
+
+static void
+fixture_teardown(Fixture *fixture, gconstpointer data)
+{
+  gchar *path = catalog_path();
+
+  g_test_log_set_fatal_handler(NULL, NULL);
+
+  g_remove(path);
+  g_free(path);
+  test_remove_dir(fixture->plugin_dir);
+
+  g_object_unref(fixture->list);
+  g_list_free(fixture->plugin_paths);
+  g_free(fixture->module);
+  g_free(fixture->plugin_dir);
+}
+
+/* a catalog listing a "fake" service for the module */
+static void
+write_catalog(Fixture *fixture, gint64 mtime)
+{
+  GKeyFile *key_file = g_key_file_new();
+  gchar *group = g_strconcat("Module ", fixture->module, NULL);
+  gchar *path = catalog_path();
+  gchar *dir = g_path_get_dirname(path);
+  GError *error = NULL;
+
+  g_key_file_set_integer(key_file, "Catalog", "Version", 1);
+  g_key_file_set_int64(key_file, group, "MTime", mtime);
+  g_key_file_set_string(key_file, "Service 0", "Module", fixture->module);
+  g_key_file_set_string(key_file, "Service 0", "Name", "fake");
+  g_key_file_set_string(key_file, "Service 0", "DisplayName", "Fake");
+  g_key_file_set_integer(key_file, "Service 0", "Priority", 0);
+  g_key_file_set_boolean(key_file, "Service 0", "SupportsAvatar", FALSE);
+
+  g_assert_cmpint(g_mkdir_with_parents(dir, 0700), ==, 0);
+  g_key_file_save_to_file(key_file, path, &error);
+  g_assert_no_error(error);
+
+  g_key_file_free(key_file);
+  g_free(dir);
+  g_free(path);
+  g_free(group);
+}
+
+static AccountPluginManager *
+new_manager(Fixture *fixture)
+{
+  fixture->n_warnings = 0;
+
+  return account_plugin_manager_new_on_demand(fixture->plugin_paths,
+                                              fixture->list);
+}
+
+static void
+test_catalog_current(Fixture *fixture, gconstpointer data)
+{
+  AccountPluginManager *manager;
+  GPtrArray *services;
+  AccountService *service;
+
+  write_catalog(fixture, module_mtime(fixture->module));
+  manager = new_manager(fixture);
+
+  /* the module was not loaded */
+  g_assert_cmpuint(fixture->n_warnings, ==, 0);
+
+  services = account_plugin_manager_get_services(manager);
+  g_assert_cmpuint(services->len, ==, 1);
+  service = g_ptr_array_index(services, 0);
+  g_assert_cmpstr(account_service_get_name(service), ==, "fake");
+  g_assert_cmpstr(account_service_get_display_name(service), ==, "Fake");
+
+  g_object_unref(manager);
+}
+
+static void
+test_catalog_stale(Fixture *fixture, gconstpointer data)
+{
+  gint64 mtime = module_mtime(fixture->module);
+  AccountPluginManager *manager;
+  GKeyFile *key_file;
+  gchar *path;
+  gchar *group;
+  GError *error = NULL;
+
+  /* the module changed since the catalog was written */
+  write_catalog(fixture, mtime - 1);
+  manager = new_manager(fixture);
+
+  g_assert_cmpuint(fixture->n_warnings, >, 0);
+  g_assert_cmpuint(account_plugin_manager_get_services(manager)->len, ==, 0);
+  g_object_unref(manager);
+
+  /* the catalog is updated, failed modules included */
+  key_file = g_key_file_new();
+  path = catalog_path();
+  group = g_strconcat("Module ", fixture->module, NULL);
+  g_key_file_load_from_file(key_file, path, G_KEY_FILE_NONE, &error);
+  g_assert_no_error(error);
+  g_assert_cmpint(g_key_file_get_int64(key_file, group, "MTime", &error), ==,
+                  mtime);
+  g_assert_no_error(error);
+  g_assert_false(g_key_file_has_group(key_file, "Service 0"));
+  g_key_file_free(key_file);
+  g_free(group);
+  g_free(path);
+
+  /* so they are not loaded again */
+  manager = new_manager(fixture);
+  g_assert_cmpuint(fixture->n_warnings, ==, 0);
+  g_object_unref(manager);
+}
+
+static void
+test_catalog_new_module(Fixture *fixture, gconstpointer data)
+{
+  AccountPluginManager *manager;
+  gchar *other;
+
+  write_catalog(fixture, module_mtime(fixture->module));
+  other = add_module(fixture, "libother.so");
+  manager = new_manager(fixture);
+
+  g_assert_cmpuint(fixture->n_warnings, >, 0);
+  g_assert_cmpuint(account_plugin_manager_get_services(manager)->len, ==, 0);
+
+  g_object_unref(manager);
+  g_free(other);
+}
+
+/* replaces the module by an actual plugin */
+static void
+install_test_plugin(Fixture *fixture)
+{
+  GError *error = NULL;
+  gchar *contents;
+  gsize length;
+
+  g_file_get_contents(TEST_PLUGIN, &contents, &length, &error);
+  g_assert_no_error(error);
+  g_file_set_contents(fixture->module, contents, length, &error);
+  g_assert_no_error(error);
+  g_free(contents);
+}
+
+static void
+on_services_changed(AccountPluginManager *manager, gpointer user_data)
+{
+  guint *n_changes = user_data;
+
+  (*n_changes)++;
+}
+
+static void
+test_load_service(Fixture *fixture, gconstpointer data)
+{
+  AccountPluginManager *manager;
+  AccountService *placeholder;
+  AccountService *loaded;
+  GPtrArray *services;
+  guint n_changes = 0;
+
+  install_test_plugin(fixture);
+  write_catalog(fixture, module_mtime(fixture->module));
+  manager = new_manager(fixture);
+
+  services = account_plugin_manager_get_services(manager);
+  g_assert_cmpuint(services->len, ==, 1);
+  placeholder = g_object_ref(g_ptr_array_index(services, 0));
+  g_assert_null(account_service_get_plugin(placeholder));
+  g_assert_true(account_plugin_manager_find_service(manager, "fake") ==
+                placeholder);
+
+  g_signal_connect(manager, "services-changed",
+                   G_CALLBACK(on_services_changed), &n_changes);
+  loaded = account_plugin_manager_load_service(manager, placeholder);
+
+  /* the placeholder is replaced everywhere */
+  g_assert_nonnull(loaded);
+  g_assert_true(loaded != placeholder);
+  g_assert_nonnull(account_service_get_plugin(loaded));
+  g_assert_cmpstr(account_service_get_display_name(loaded), ==,
+                  "Fake (loaded)");
+  g_assert_true(account_plugin_manager_find_service(manager, "fake") ==
+                loaded);
+  services = account_plugin_manager_get_services(manager);
+  g_assert_cmpuint(services->len, ==, 1);
+  g_assert_true(g_ptr_array_index(services, 0) == loaded);
+  g_assert_cmpuint(n_changes, ==, 1);
+  g_assert_cmpuint(fixture->n_warnings, ==, 0);
+
+  g_assert_true(account_plugin_manager_load_service(manager, loaded) ==
+                loaded);
+
+  g_signal_handlers_disconnect_by_func(manager, on_services_changed,
+                                       &n_changes);
+  g_object_unref(placeholder);
+  g_object_unref(manager);
+}
+
+int
+main(int argc, char **argv)
+{
+  gchar *cache_dir;
+  int rv;
+
+  g_test_init(&argc, &argv, NULL);
+  cache_dir = test_setup_cache_dir();
+
+  g_test_add("/plugin-manager/catalog-current", Fixture, NULL, fixture_setup,
+             test_catalog_current, fixture_teardown);
+  g_test_add("/plugin-manager/catalog-stale", Fixture, NULL, fixture_setup,
+             test_catalog_stale, fixture_teardown);
+  g_test_add("/plugin-manager/catalog-new-module", Fixture, NULL,
+             fixture_setup, test_catalog_new_module, fixture_teardown);
+  g_test_add("/plugin-manager/load-service", Fixture, NULL, fixture_setup,
+             test_load_service, fixture_teardown);
+
+  rv = g_test_run();
+
+  test_remove_dir(cache_dir);
+  g_free(cache_dir);
+
+  return rv;
+}
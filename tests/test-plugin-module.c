@@ -0,0 +1,124 @@
+/*
+ * test-plugin-module.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * A plugin module providing the "fake" service, loaded by
+ * test-plugin-manager.
+ */
+
+#include "config.h"
+
+#include "account-plugin.h"
+
+typedef struct _TestModulePlugin TestModulePlugin;
+typedef struct _TestModulePluginClass TestModulePluginClass;
+
+struct _TestModulePlugin
+{
+  AccountPlugin parent_instance;
+  GList *services;
+};
+
+struct _TestModulePluginClass
+{
+  AccountPluginClass parent_class;
+};
+
+enum
+{
+  PROP_INITIALIZED = 1
+};
+
+ACCOUNT_DEFINE_PLUGIN(TestModulePlugin, test_module_plugin, ACCOUNT_TYPE_PLUGIN);
+
+static gboolean
+test_module_plugin_setup(AccountPlugin *plugin, AccountsList *accounts_list)
+{
+  return TRUE;
+}
+
+static const gchar *
+test_module_plugin_get_name(AccountPlugin *plugin)
+{
+  return "test-module";
+}
+
+static GList *
+test_module_plugin_list_services(AccountPlugin *plugin)
+{
+  return g_list_copy(((TestModulePlugin *)plugin)->services);
+}
+
+static void
+test_module_plugin_get_property(GObject *object, guint property_id,
+                                GValue *value, GParamSpec *pspec)
+{
+  switch (property_id)
+  {
+    case PROP_INITIALIZED:
+    {
+      g_value_set_boolean(value, TRUE);
+      break;
+    }
+    default:
+    {
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+      break;
+    }
+  }
+}
+
+static void
+test_module_plugin_finalize(GObject *object)
+{
+  TestModulePlugin *plugin = (TestModulePlugin *)object;
+
+  g_list_free_full(plugin->services, g_object_unref);
+
+  G_OBJECT_CLASS(test_module_plugin_parent_class)->finalize(object);
+}
+
+static void
+test_module_plugin_class_init(TestModulePluginClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  AccountPluginClass *plugin_class = ACCOUNT_PLUGIN_CLASS(klass);
+
+  object_class->get_property = test_module_plugin_get_property;
+  object_class->finalize = test_module_plugin_finalize;
+  plugin_class->setup = test_module_plugin_setup;
+  plugin_class->get_name = test_module_plugin_get_name;
+  plugin_class->get_display_name = test_module_plugin_get_name;
+  plugin_class->list_services = test_module_plugin_list_services;
+
+  g_object_class_override_property(object_class, PROP_INITIALIZED,
+                                   "initialized");
+}
+
+static void
+test_module_plugin_init(TestModulePlugin *plugin)
+{
+  AccountService *service = g_object_new(ACCOUNT_TYPE_SERVICE,
+                                         "plugin", plugin,
+                                         "name", "fake",
+                                         "display-name", "Fake (loaded)",
+                                         NULL);
+
+  plugin->services = g_list_append(NULL, service);
+}
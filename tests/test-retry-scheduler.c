@@ -0,0 +1,260 @@
+/*
+ * test-retry-scheduler.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "account-error.h"
+#include "accounts-retry-scheduler.h"
+
+#include "test-common.h"
+
+#define BASE_DELAY 100 /* ms */
+/* how late a timeout may fire on a busy machine */
+#define SLACK 40 /* ms */
+#define N_OPERATIONS 10
+
+typedef struct _Operation
+{
+  AccountItem *item;
+  /* the attempts up to n_failures fail with code */
+  guint n_failures;
+  gint code;
+  guint n_attempts;
+  gint64 started[2];
+  gboolean finished;
+  gboolean result;
+  GError *error;
+} Operation;
+
+typedef struct _Fixture
+{
+  AccountPlugin *plugin;
+  AccountService *service;
+  AccountsRetryScheduler *scheduler;
+  Operation operations[N_OPERATIONS];
+} Fixture;
+
+static void
+fixture_setup(Fixture *fixture, gconstpointer data)
+{
+  guint i;
+
+  fixture->plugin = test_plugin_new("test");
+  fixture->service = test_service_new(fixture->plugin, "sip", "SIP");
+  fixture->scheduler = accounts_retry_scheduler_new(NULL);
+  g_object_set(fixture->scheduler,
+               "base-delay", BASE_DELAY,
+               "max-parallel", 0,
+               NULL);
+
+  for (i = 0; i < N_OPERATIONS; i++)
+  {
+    Operation *op = &fixture->operations[i];
+    gchar *name = g_strdup_printf("user%u", i);
+
+    op->item = test_item_new(fixture->service, name, name);
+    op->code = ACCOUNT_ERROR_CONNECTION_FAILED;
+    g_free(name);
+  }
+}
+
+static void
+fixture_teardown(Fixture *fixture, gconstpointer data)
+{
+  guint i;
+
+  for (i = 0; i < N_OPERATIONS; i++)
+  {
+    g_clear_error(&fixture->operations[i].error);
+    g_object_unref(fixture->operations[i].item);
+  }
+
+  g_object_unref(fixture->scheduler);
+  g_object_unref(fixture->service);
+  g_object_unref(fixture->plugin);
+}
+
+static void
+attempt_func(AccountItem *item, GTask *attempt, gpointer user_data)
+{
+  Operation *op = user_data;
+
+  if (op->n_attempts < G_N_ELEMENTS(op->started))
+    op->started[op->n_attempts] = g_get_monotonic_time();
+
+  op->n_attempts++;
+
+  if (op->n_attempts <= op->n_failures)
+  {
+    g_task_return_new_error(attempt, ACCOUNT_ERROR, op->code,
+                            "Attempt %u failed", op->n_attempts);
+  }
+  else
+    g_task_return_boolean(attempt, TRUE);
+
+  g_object_unref(attempt);
+}
+
+static void
+submit_cb(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  Operation *op = user_data;
+
+  op->result = accounts_retry_scheduler_submit_finish(
+      ACCOUNTS_RETRY_SCHEDULER(source), result, &op->error);
+  op->finished = TRUE;
+}
+
+static void
+submit(Fixture *fixture, Operation *op)
+{
+  accounts_retry_scheduler_submit_async(fixture->scheduler, op->item,
+                                        attempt_func, op, NULL, NULL,
+                                        submit_cb, op);
+}
+
+static gboolean
+timeout_cb(gpointer user_data)
+{
+  gboolean *timed_out = user_data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+wait_for(Operation *ops, guint n_ops)
+{
+  gboolean timed_out = FALSE;
+  guint timeout_id = g_timeout_add_seconds(10, timeout_cb, &timed_out);
+  guint i = 0;
+
+  while (i < n_ops && !timed_out)
+  {
+    if (ops[i].finished)
+      i++;
+    else
+      g_main_context_iteration(NULL, TRUE);
+  }
+
+  g_assert_false(timed_out);
+  g_source_remove(timeout_id);
+}
+
+static void
+test_first_retry(Fixture *fixture, gconstpointer data)
+{
+  guint i;
+
+  for (i = 0; i < N_OPERATIONS; i++)
+  {
+    fixture->operations[i].n_failures = 1;
+    submit(fixture, &fixture->operations[i]);
+  }
+
+  wait_for(fixture->operations, N_OPERATIONS);
+
+  /* the delay after the first failure is drawn below base-delay, for every
+   * operation */
+  for (i = 0; i < N_OPERATIONS; i++)
+  {
+    Operation *op = &fixture->operations[i];
+
+    g_assert_true(op->result);
+    g_assert_no_error(op->error);
+    g_assert_cmpuint(op->n_attempts, ==, 2);
+    g_assert_cmpint(op->started[1] - op->started[0], <=,
+                    (BASE_DELAY + SLACK) * G_TIME_SPAN_MILLISECOND);
+  }
+}
+
+static void
+test_max_attempts(Fixture *fixture, gconstpointer data)
+{
+  Operation *op = &fixture->operations[0];
+
+  g_object_set(fixture->scheduler,
+               "base-delay", 1,
+               "max-attempts", 3,
+               NULL);
+  op->n_failures = G_MAXUINT;
+  submit(fixture, op);
+  wait_for(op, 1);
+
+  g_assert_false(op->result);
+  g_assert_error(op->error, ACCOUNT_ERROR, ACCOUNT_ERROR_CONNECTION_FAILED);
+  g_assert_cmpuint(op->n_attempts, ==, 3);
+}
+
+static void
+test_not_retryable(Fixture *fixture, gconstpointer data)
+{
+  Operation *op = &fixture->operations[0];
+
+  op->n_failures = 1;
+  op->code = ACCOUNT_ERROR_INVALID_VALUE;
+  submit(fixture, op);
+  wait_for(op, 1);
+
+  g_assert_false(op->result);
+  g_assert_error(op->error, ACCOUNT_ERROR, ACCOUNT_ERROR_INVALID_VALUE);
+  g_assert_cmpuint(op->n_attempts, ==, 1);
+}
+
+static void
+test_network_unavailable(Fixture *fixture, gconstpointer data)
+{
+  Operation *op = &fixture->operations[0];
+  gboolean timed_out = FALSE;
+
+  accounts_retry_scheduler_set_network_available(fixture->scheduler, FALSE);
+  submit(fixture, op);
+
+  g_timeout_add(2 * BASE_DELAY, timeout_cb, &timed_out);
+
+  while (!timed_out)
+    g_main_context_iteration(NULL, TRUE);
+
+  g_assert_cmpuint(op->n_attempts, ==, 0);
+  g_assert_false(op->finished);
+
+  accounts_retry_scheduler_set_network_available(fixture->scheduler, TRUE);
+  wait_for(op, 1);
+
+  g_assert_true(op->result);
+  g_assert_cmpuint(op->n_attempts, ==, 1);
+}
+
+int
+main(int argc, char **argv)
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/retry-scheduler/first-retry", Fixture, NULL, fixture_setup,
+             test_first_retry, fixture_teardown);
+  g_test_add("/retry-scheduler/max-attempts", Fixture, NULL, fixture_setup,
+             test_max_attempts, fixture_teardown);
+  g_test_add("/retry-scheduler/not-retryable", Fixture, NULL, fixture_setup,
+             test_not_retryable, fixture_teardown);
+  g_test_add("/retry-scheduler/network-unavailable", Fixture, NULL,
+             fixture_setup, test_network_unavailable, fixture_teardown);
+
+  return g_test_run();
+}
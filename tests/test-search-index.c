@@ -0,0 +1,155 @@
+/*
+ * test-search-index.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "accounts-search-index.h"
+
+#include "test-common.h"
+
+typedef struct _Fixture
+{
+  AccountsList *list;
+  AccountPlugin *plugin;
+  AccountService *service;
+  AccountsModel *model;
+  AccountsSearchIndex *index;
+  AccountItem *jose;
+  AccountItem *zoe;
+  AccountItem *alexander;
+} Fixture;
+
+static AccountItem *
+add_item(Fixture *fixture, const gchar *name, const gchar *display_name)
+{
+  AccountItem *item = test_item_new(fixture->service, name, display_name);
+
+  accounts_list_add(fixture->list, item);
+  g_object_unref(item);
+
+  return item;
+}
+
+static void
+fixture_setup(Fixture *fixture, gconstpointer data)
+{
+  fixture->list = test_accounts_list_new();
+  fixture->plugin = test_plugin_new("test");
+  fixture->service = test_service_new(fixture->plugin, "sip", "SIP");
+  fixture->model = accounts_model_new(fixture->list);
+  fixture->index = accounts_search_index_new(fixture->model);
+
+  fixture->jose = add_item(fixture, "u1", "José Ñandú");
+  fixture->zoe = add_item(fixture, "u2", "Zoë");
+  fixture->alexander = add_item(fixture, "u3", "Alexander");
+}
+
+static void
+fixture_teardown(Fixture *fixture, gconstpointer data)
+{
+  g_object_unref(fixture->index);
+  g_object_unref(fixture->model);
+  g_object_unref(fixture->list);
+  g_object_unref(fixture->service);
+  g_object_unref(fixture->plugin);
+}
+
+/* checks that query finds exactly expected */
+static void
+assert_search(Fixture *fixture, const gchar *query, AccountItem *expected)
+{
+  GList *found = accounts_search_index_search(fixture->index, query, 0);
+
+  if (expected)
+  {
+    g_assert_cmpuint(g_list_length(found), ==, 1);
+    g_assert_true(found->data == expected);
+  }
+  else
+    g_assert_null(found);
+
+  g_list_free(found);
+}
+
+static void
+test_folding(Fixture *fixture, gconstpointer data)
+{
+  assert_search(fixture, "jose", fixture->jose);
+  assert_search(fixture, "NANDU", fixture->jose);
+  assert_search(fixture, "ñandú", fixture->jose);
+  assert_search(fixture, "zoe", fixture->zoe);
+  assert_search(fixture, "ZOË", fixture->zoe);
+
+  /* short queries match word prefixes */
+  assert_search(fixture, "na", fixture->jose);
+  assert_search(fixture, "z", fixture->zoe);
+}
+
+static void
+test_typos(Fixture *fixture, gconstpointer data)
+{
+  assert_search(fixture, "alexandr", fixture->alexander);
+  assert_search(fixture, "xyzzy", NULL);
+}
+
+static void
+test_ranking(Fixture *fixture, gconstpointer data)
+{
+  AccountItem *alex = add_item(fixture, "u4", "Tom Alex");
+  GList *found;
+
+  /* a prefix of the display name wins over a word in it */
+  found = accounts_search_index_search(fixture->index, "alex", 0);
+  g_assert_cmpuint(g_list_length(found), ==, 2);
+  g_assert_true(found->data == fixture->alexander);
+  g_assert_true(found->next->data == alex);
+  g_list_free(found);
+
+  found = accounts_search_index_search(fixture->index, "alex", 1);
+  g_assert_cmpuint(g_list_length(found), ==, 1);
+  g_list_free(found);
+}
+
+static void
+test_updates(Fixture *fixture, gconstpointer data)
+{
+  account_item_set_display_name(fixture->zoe, "Yann");
+  assert_search(fixture, "zoe", NULL);
+  assert_search(fixture, "yann", fixture->zoe);
+
+  accounts_list_remove(fixture->list, fixture->jose);
+  assert_search(fixture, "jose", NULL);
+}
+
+int
+main(int argc, char **argv)
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/search-index/folding", Fixture, NULL, fixture_setup,
+             test_folding, fixture_teardown);
+  g_test_add("/search-index/typos", Fixture, NULL, fixture_setup,
+             test_typos, fixture_teardown);
+  g_test_add("/search-index/ranking", Fixture, NULL, fixture_setup,
+             test_ranking, fixture_teardown);
+  g_test_add("/search-index/updates", Fixture, NULL, fixture_setup,
+             test_updates, fixture_teardown);
+
+  return g_test_run();
+}
@@ -0,0 +1,171 @@
+/*
+ * test-verification-cache.c
+ *
+ * Copyright (C) 2026 Ivaylo Dimitrov <ivo.g.dimitrov.75@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "account-error.h"
+#include "accounts-verification-cache.h"
+
+#include "test-common.h"
+
+#define TTL 60 /* s */
+
+typedef struct _Fixture
+{
+  AccountPlugin *plugin;
+  AccountService *service;
+  AccountItem *item;
+  AccountsVerificationCache *cache;
+} Fixture;
+
+static void
+fixture_setup(Fixture *fixture, gconstpointer data)
+{
+  fixture->plugin = test_plugin_new("test");
+  fixture->service = test_service_new(fixture->plugin, "sip", "SIP");
+  fixture->item = test_item_new(fixture->service, "alice", "Alice");
+  fixture->cache = accounts_verification_cache_new(TTL);
+}
+
+static void
+fixture_teardown(Fixture *fixture, gconstpointer data)
+{
+  g_object_unref(fixture->cache);
+  g_object_unref(fixture->item);
+  g_object_unref(fixture->service);
+  g_object_unref(fixture->plugin);
+}
+
+static void
+test_succeeded(Fixture *fixture, gconstpointer data)
+{
+  GError *error = NULL;
+
+  accounts_verification_cache_store(fixture->cache, fixture->item, "secret",
+                                    NULL);
+
+  g_assert_cmpint(accounts_verification_cache_lookup(
+                    fixture->cache, fixture->item, "secret", &error),
+                  ==, ACCOUNTS_VERIFICATION_SUCCEEDED);
+  g_assert_no_error(error);
+  g_assert_cmpint(accounts_verification_cache_lookup(
+                    fixture->cache, fixture->item, "other", NULL),
+                  ==, ACCOUNTS_VERIFICATION_UNKNOWN);
+}
+
+static void
+test_rejected(Fixture *fixture, gconstpointer data)
+{
+  static const gint codes[] =
+  {
+    ACCOUNT_ERROR_AUTHENTICATION_FAILED,
+    ACCOUNT_ERROR_VERIFICATION_FAILED
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS(codes); i++)
+  {
+    GError *stored = g_error_new(ACCOUNT_ERROR, codes[i], "rejected");
+    GError *error = NULL;
+
+    accounts_verification_cache_store(fixture->cache, fixture->item, "secret",
+                                      stored);
+    g_error_free(stored);
+
+    g_assert_cmpint(accounts_verification_cache_lookup(
+                      fixture->cache, fixture->item, "secret", &error),
+                    ==, ACCOUNTS_VERIFICATION_FAILED);
+    g_assert_error(error, ACCOUNT_ERROR, codes[i]);
+    g_error_free(error);
+  }
+}
+
+static void
+test_not_rejected(Fixture *fixture, gconstpointer data)
+{
+  static const gint codes[] =
+  {
+    ACCOUNT_ERROR_CONNECTION_FAILED,
+    ACCOUNT_ERROR_USER_CANCELLED,
+    ACCOUNT_ERROR_UNKNOWN
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS(codes); i++)
+  {
+    GError *error = g_error_new(ACCOUNT_ERROR, codes[i], "failed");
+
+    accounts_verification_cache_store(fixture->cache, fixture->item, "secret",
+                                      error);
+    g_error_free(error);
+
+    g_assert_cmpint(accounts_verification_cache_lookup(
+                      fixture->cache, fixture->item, "secret", NULL),
+                    ==, ACCOUNTS_VERIFICATION_UNKNOWN);
+  }
+}
+
+static void
+test_not_rejected_keeps_outcome(Fixture *fixture, gconstpointer data)
+{
+  GError *error = g_error_new(G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "timeout");
+
+  accounts_verification_cache_store(fixture->cache, fixture->item, "secret",
+                                    NULL);
+  accounts_verification_cache_store(fixture->cache, fixture->item, "secret",
+                                    error);
+  g_error_free(error);
+
+  /* a failure which says nothing about the credentials doesn't replace
+   * the outcome of their last verification */
+  g_assert_cmpint(accounts_verification_cache_lookup(
+                    fixture->cache, fixture->item, "secret", NULL),
+                  ==, ACCOUNTS_VERIFICATION_SUCCEEDED);
+}
+
+static void
+test_invalidate(Fixture *fixture, gconstpointer data)
+{
+  accounts_verification_cache_store(fixture->cache, fixture->item, "secret",
+                                    NULL);
+  accounts_verification_cache_invalidate(fixture->cache, fixture->item);
+
+  g_assert_cmpint(accounts_verification_cache_lookup(
+                    fixture->cache, fixture->item, "secret", NULL),
+                  ==, ACCOUNTS_VERIFICATION_UNKNOWN);
+}
+
+int
+main(int argc, char **argv)
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/verification-cache/succeeded", Fixture, NULL, fixture_setup,
+             test_succeeded, fixture_teardown);
+  g_test_add("/verification-cache/rejected", Fixture, NULL, fixture_setup,
+             test_rejected, fixture_teardown);
+  g_test_add("/verification-cache/not-rejected", Fixture, NULL, fixture_setup,
+             test_not_rejected, fixture_teardown);
+  g_test_add("/verification-cache/not-rejected-keeps-outcome", Fixture, NULL,
+             fixture_setup, test_not_rejected_keeps_outcome, fixture_teardown);
+  g_test_add("/verification-cache/invalidate", Fixture, NULL, fixture_setup,
+             test_invalidate, fixture_teardown);
+
+  return g_test_run();
+}